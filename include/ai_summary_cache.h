@@ -0,0 +1,59 @@
+#ifndef AI_SUMMARY_CACHE_H
+#define AI_SUMMARY_CACHE_H
+
+#include <Arduino.h>
+
+#define AI_SUMMARY_TTL_MS 900000        // Revalidate a summary older than 15 minutes
+#define AI_SUMMARY_ETAG_SIZE 64
+
+// Conditional fetch of the AI summary: filled in on the loop task before the
+// request is queued, answered by the request on the uplink worker
+struct AISummaryFetch {
+    String userId;                      // Cache key the summary is fetched for
+    uint32_t sequence;
+    bool revalidation;                  // Background refresh of a summary already shown
+    char ifNoneMatch[AI_SUMMARY_ETAG_SIZE]; // Empty for an unconditional request
+    char etag[AI_SUMMARY_ETAG_SIZE];    // ETag of the new summary
+    bool notModified;                   // Server answered 304, the cached summary stands
+};
+
+// Last AI summary, keyed by user and the sequence of the last measurement
+// uploaded for the device: the summary can only change once new data reached
+// the server. A matching entry is served at once; past AI_SUMMARY_TTL_MS it is
+// still served but refreshed in the background with If-None-Match.
+// Used from loop() only.
+class AISummaryCache {
+private:
+    bool valid;
+    String userId;
+    uint32_t sequence;
+    String summary;
+    char etag[AI_SUMMARY_ETAG_SIZE];
+    unsigned long fetchedAt;
+
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t revalidations;
+    uint32_t notModified;
+
+public:
+    AISummaryCache();
+
+    // True if a summary for this key is cached; counts a hit or a miss
+    bool lookup(const String& userId, uint32_t sequence);
+    bool isStale() const;
+
+    // Prepares a fetch for the key, conditional on the cached ETag when revalidating
+    void prepareFetch(AISummaryFetch& fetch, const String& userId, uint32_t sequence, bool revalidation);
+
+    // Applies a successful fetch
+    void update(const AISummaryFetch& fetch, const String& newSummary);
+
+    const String& getSummary() const { return summary; }
+    uint32_t getHits() const { return hits; }
+    uint32_t getMisses() const { return misses; }
+    uint32_t getRevalidations() const { return revalidations; }
+    uint32_t getNotModified() const { return notModified; }
+};
+
+#endif // AI_SUMMARY_CACHE_H
@@ -0,0 +1,64 @@
+#ifndef BACKGROUND_JOB_H
+#define BACKGROUND_JOB_H
+
+#include <Arduino.h>
+
+#define BACKGROUND_JOB_STACK 8192       // Same as the Arduino loop task; enough for HTTPClient
+#define BACKGROUND_JOB_PRIORITY 1
+#define BACKGROUND_JOB_CORE 0           // Off the loop() core so the web server and sensor keep running
+
+enum JobState {
+    JOB_UNKNOWN,    // No job with this id (never started, or superseded by a newer one)
+    JOB_RUNNING,
+    JOB_DONE
+};
+
+// Runs one long blocking operation (WiFi connect, cloud request) off the loop
+// task so request handlers can return immediately: start() gives it a FreeRTOS
+// task of its own, an executor such as UplinkWorker runs it on a shared one via
+// reserve() and run(). Each job hands out a job id the browser polls with; the
+// work function must only touch data reserved for the job, everything else is
+// applied from loop() once takeCompletion() reports the job finished.
+class BackgroundJob {
+public:
+    typedef bool (*Work)(void* context);
+
+private:
+    const char* name;
+    Work work;
+    void* context;
+    uint32_t id;
+    volatile JobState state;
+    volatile bool success;
+    volatile bool completionPending;
+    unsigned long startedAt;
+    volatile unsigned long finishedAt;
+
+    static uint32_t nextId;
+    static void taskEntry(void* param);
+
+public:
+    BackgroundJob(const char* name);
+
+    // Returns the new job id, or 0 if a job is still running or the task couldn't be created
+    uint32_t start(Work work, void* context);
+    
+    // Executor interface: reserve() marks the job running and returns its id
+    // (0 if it already runs), run() executes it on the calling task and
+    // publishes the result, cancel() backs out a reservation that was never run
+    uint32_t reserve(Work work, void* context);
+    void run();
+    void cancel();
+
+    JobState getState(uint32_t jobId) const;
+    bool isRunning() const { return state == JOB_RUNNING; }
+    bool succeeded() const { return success; }
+    uint32_t getId() const { return id; }
+    const char* getName() const { return name; }
+    unsigned long getElapsedMs() const;
+
+    // True exactly once after the job finishes; call from loop() to apply its results
+    bool takeCompletion();
+};
+
+#endif // BACKGROUND_JOB_H
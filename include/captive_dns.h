@@ -0,0 +1,62 @@
+#ifndef CAPTIVE_DNS_H
+#define CAPTIVE_DNS_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#define DNS_PORT 53
+#define DNS_MAX_PACKET 512              // Plain DNS over UDP never exceeds this
+#define DNS_MAX_QUERIES_PER_CALL 32     // Upper bound on one drain, so a flood can't starve the caller
+#define DNS_TTL_SECONDS 60
+#define DNS_TASK_STACK 4096
+#define DNS_TASK_PRIORITY 2             // Above loop() so queries are answered while it is busy
+#define DNS_TASK_CORE 0
+#define DNS_TASK_INTERVAL_MS 5
+
+// Run the responder in its own FreeRTOS task (1) or from WiFiManager::loop() (0)
+#ifndef DNS_OWN_TASK
+#define DNS_OWN_TASK 1
+#endif
+
+// Captive-portal DNS: every A query is answered with the AP address from a
+// prebuilt resource record, AAAA gets an empty answer (the AP has no IPv6, so
+// clients fall back to A at once) and any other type is answered NXDOMAIN.
+// Each call drains all pending queries instead of one per loop() iteration.
+class CaptiveDns {
+private:
+    WiFiUDP udp;
+    uint8_t answer[16];                 // Answer RR appended after the question
+    uint8_t packet[DNS_MAX_PACKET];
+    bool running;
+    TaskHandle_t task;
+    volatile bool stopRequested;
+
+    uint32_t queries;
+    uint32_t answered;
+    uint32_t noData;
+    uint32_t nxDomain;
+    uint32_t dropped;
+
+    void handlePacket(int length);
+    static void taskEntry(void* param);
+
+public:
+    CaptiveDns();
+
+    bool start(const IPAddress& ip, bool ownTask = DNS_OWN_TASK);
+    void stop();
+
+    // Answers every pending query; returns how many were handled. Called from
+    // loop() this is a no-op while the responder runs in its own task.
+    int processRequests();
+    void loop();
+
+    uint32_t getQueries() const { return queries; }
+    uint32_t getAnswered() const { return answered; }
+    uint32_t getNoData() const { return noData; }
+    uint32_t getNxDomain() const { return nxDomain; }
+    uint32_t getDropped() const { return dropped; }
+};
+
+#endif // CAPTIVE_DNS_H
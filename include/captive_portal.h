@@ -0,0 +1,41 @@
+#ifndef CAPTIVE_PORTAL_H
+#define CAPTIVE_PORTAL_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+// Connectivity check of one OS: the path it requests and, optionally, the host
+// it sends it to. Any path on a listed host is treated as the same check.
+struct CaptiveProbe {
+    const char* host;           // nullptr: match on path only
+    const char* path;
+    uint16_t onlineCode;        // Answer that tells the OS the network is online
+    const char* contentType;
+    const char* onlineBody;
+};
+
+// Answers OS connectivity probes and stray URLs from clients on the setup AP
+// with canned responses. Nothing here touches the WiFi stack or builds Strings
+// per request, so a phone firing a burst of probes while joining gets an
+// immediate answer for each.
+class CaptivePortal {
+private:
+    char portalURL[24];         // http://<AP IP>/
+    char redirectBody[256];     // Fallback page for clients that ignore Location (245 bytes with the longest URL)
+
+public:
+    CaptivePortal();
+
+    // Builds the redirect once; the AP address never changes afterwards
+    void begin(const IPAddress& apIP);
+
+    // Matches the current request against the probe table
+    const CaptiveProbe* match(WebServer& server) const;
+
+    // With portalRequired the OS is sent to the setup page (opening its sign-in
+    // sheet), otherwise it gets the answer it expects from the real internet
+    void answerProbe(WebServer& server, const CaptiveProbe& probe, bool portalRequired) const;
+    void redirect(WebServer& server) const;
+};
+
+#endif // CAPTIVE_PORTAL_H
@@ -32,6 +32,7 @@ public:
     void showLoginStatus(bool success);
     void setupSensorUI();
     void updateSensorReadings(int32_t heartRate, bool validHR, int32_t spo2, bool validSPO2);
+    void showProbeReadings(int probe, int32_t heartRate, bool validHR, int32_t spo2, bool validSPO2);
     void showMeasuringStatus();
     void showFingerStatus(bool fingerDetected);
     void showWiFiReconfigOption();
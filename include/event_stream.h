@@ -0,0 +1,66 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebServer.h>
+
+#define EVENT_MAX_SUBSCRIBERS 4        // Concurrent /events connections
+#define EVENT_CLIENT_BUFFER 512        // Pending bytes per subscriber before events are dropped
+#define EVENT_MAX_FRAME 192            // Longest single event (name + data)
+#define EVENT_KEEPALIVE_MS 15000       // Comment line sent to idle subscribers
+#define EVENT_RETRY_MS 3000            // Browser reconnect delay announced to subscribers
+
+// WebServer that can hand the current connection over to someone else. Without
+// this the server keeps a still-open connection after the handler returns and
+// waits up to HTTP_MAX_CLOSE_WAIT (2s) for the client to close it, serving no
+// other request meanwhile.
+class TakeoverWebServer : public WebServer {
+public:
+    TakeoverWebServer(int port) : WebServer(port) {}
+
+    // Call from a handler that sends its own response; the server forgets the
+    // connection and the returned client owns it
+    WiFiClient takeClient() {
+        WiFiClient taken = _currentClient;
+        _currentClient = WiFiClient();
+        return taken;
+    }
+};
+
+// Server-Sent Events hub. Subscribers are taken over from the WebServer after
+// the request is parsed and kept open; events are queued in a fixed per-client
+// buffer and written out from loop() with non-blocking sends, so a slow or
+// stalled client only loses its own events and never holds up the loop.
+class EventStream {
+private:
+    struct Subscriber {
+        WiFiClient client;
+        char buffer[EVENT_CLIENT_BUFFER];
+        size_t used;
+        bool active;
+    };
+
+    Subscriber subscribers[EVENT_MAX_SUBSCRIBERS];
+    unsigned long lastKeepAlive;
+    uint32_t eventsPublished;
+    uint32_t eventsDropped;
+
+    bool queue(Subscriber& sub, const char* data, size_t length);
+    void flush(Subscriber& sub);
+    void release(Subscriber& sub);
+
+public:
+    EventStream();
+
+    // Takes over an HTTP connection; returns false if all slots are in use
+    bool subscribe(WiFiClient& client);
+    void publish(const char* event, const char* data);
+    void loop();
+
+    int getSubscriberCount() const;
+    uint32_t getEventsPublished() const { return eventsPublished; }
+    uint32_t getEventsDropped() const { return eventsDropped; }
+};
+
+#endif // EVENT_STREAM_H
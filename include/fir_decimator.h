@@ -0,0 +1,119 @@
+#ifndef FIR_DECIMATOR_H
+#define FIR_DECIMATOR_H
+
+#include <stdint.h>
+
+// Low-pass taps (Q15, Hamming-windowed sinc, cutoff at output Nyquist).
+// Taps are symmetric and sum to 32768 so the DC gain is exactly 1.
+
+// 400 Hz -> 25 Hz (decimate by 16)
+constexpr int FIR_DECIM16_FACTOR = 16;
+constexpr int FIR_DECIM16_TAP_COUNT = 64;
+constexpr int16_t FIR_DECIM16_TAPS[FIR_DECIM16_TAP_COUNT] = {
+       -3,    -8,   -15,   -23,   -34,   -47,   -62,   -79,   -96,  -112,  -124,  -129,
+     -126,  -110,   -79,   -31,    36,   124,   233,   362,   509,   672,   846,  1027,
+     1209,  1387,  1554,  1704,  1831,  1931,  2001,  2036,  2036,  2001,  1931,  1831,
+     1704,  1554,  1387,  1209,  1027,   846,   672,   509,   362,   233,   124,    36,
+      -31,   -79,  -110,  -126,  -129,  -124,  -112,   -96,   -79,   -62,   -47,   -34,
+      -23,   -15,    -8,    -3
+};
+
+// 800 Hz -> 25 Hz (decimate by 32)
+constexpr int FIR_DECIM32_FACTOR = 32;
+constexpr int FIR_DECIM32_TAP_COUNT = 128;
+constexpr int16_t FIR_DECIM32_TAPS[FIR_DECIM32_TAP_COUNT] = {
+       -1,    -2,    -3,    -5,    -7,    -9,   -11,   -13,   -16,   -19,   -23,   -26,
+      -30,   -34,   -39,   -43,   -47,   -52,   -56,   -59,   -62,   -64,   -66,   -66,
+      -65,   -63,   -59,   -53,   -45,   -35,   -23,    -8,     9,    28,    51,    75,
+      103,   133,   165,   200,   237,   276,   316,   359,   402,   447,   492,   538,
+      583,   628,   673,   716,   758,   797,   835,   869,   901,   930,   955,   976,
+      993,  1006,  1015,  1022,  1022,  1015,  1006,   993,   976,   955,   930,   901,
+      869,   835,   797,   758,   716,   673,   628,   583,   538,   492,   447,   402,
+      359,   316,   276,   237,   200,   165,   133,   103,    75,    51,    28,     9,
+       -8,   -23,   -35,   -45,   -53,   -59,   -63,   -65,   -66,   -66,   -64,   -62,
+      -59,   -56,   -52,   -47,   -43,   -39,   -34,   -30,   -26,   -23,   -19,   -16,
+      -13,   -11,    -9,    -7,    -5,    -3,    -2,    -1
+};
+
+// Decimating FIR filter for one sensor channel.
+// The filter is only evaluated at output instants (polyphase form), so the cost is
+// MAX_TAPS/2 multiply-adds per *output* sample thanks to tap symmetry, and a single
+// store per input sample. History is kept twice so every dot product is contiguous.
+template <int MAX_TAPS>
+class FirDecimator {
+private:
+    const int16_t* taps;
+    int tapCount;
+    int factor;
+    int32_t history[2 * MAX_TAPS];
+    int head;              // Index of the oldest sample in the history window
+    int phase;             // Inputs received since the last output
+    int filled;            // Number of valid samples in history (for start-up)
+
+public:
+    FirDecimator() : taps(nullptr), tapCount(0), factor(1), head(0), phase(0), filled(0) {}
+
+    void configure(const int16_t* newTaps, int newTapCount, int newFactor) {
+        taps = newTaps;
+        tapCount = (newTapCount <= MAX_TAPS) ? newTapCount : MAX_TAPS;
+        factor = (newFactor > 0) ? newFactor : 1;
+        reset();
+    }
+
+    void reset() {
+        for (int i = 0; i < 2 * MAX_TAPS; i++) {
+            history[i] = 0;
+        }
+        head = 0;
+        phase = 0;
+        filled = 0;
+    }
+
+    int getFactor() const { return factor; }
+
+    // Push one raw sample. Returns true and writes `out` when an output sample is due.
+    bool push(uint32_t sample, uint32_t& out) {
+        if (taps == nullptr || tapCount == 0) {
+            out = sample;
+            return true;
+        }
+
+        history[head] = (int32_t)sample;
+        history[head + tapCount] = (int32_t)sample;
+        head++;
+        if (head == tapCount) {
+            head = 0;
+        }
+        if (filled < tapCount) {
+            filled++;
+        }
+
+        phase++;
+        if (phase < factor) {
+            return false;
+        }
+        phase = 0;
+
+        // Until the delay line is full the output would be dragged towards zero,
+        // so pass the newest sample through instead
+        if (filled < tapCount) {
+            out = sample;
+            return true;
+        }
+
+        const int32_t* window = &history[head];
+        int64_t acc = 0;
+        for (int i = 0, j = tapCount - 1; i < j; i++, j--) {
+            acc += (int64_t)taps[i] * (window[i] + window[j]);
+        }
+        if (tapCount & 1) {
+            acc += (int64_t)taps[tapCount / 2] * window[tapCount / 2];
+        }
+
+        acc = (acc + (1 << 14)) >> 15;
+        out = (acc > 0) ? (uint32_t)acc : 0;
+        return true;
+    }
+};
+
+#endif // FIR_DECIMATOR_H
@@ -0,0 +1,76 @@
+#ifndef JSON_FIELD_EXTRACTOR_H
+#define JSON_FIELD_EXTRACTOR_H
+
+#include <Arduino.h>
+
+#define JSON_EXTRACT_MAX_FIELDS 4
+#define JSON_EXTRACT_KEY_SIZE 32        // Longer keys never match
+
+// Incremental JSON parser that copies selected top-level fields of an object
+// into caller-owned fixed buffers while the response is still arriving. It is
+// a Stream sink, so HTTPClient::writeToStream() feeds it (and takes care of
+// chunked transfer encoding); memory use does not depend on the response size.
+// String values are unescaped (\n, \", \uXXXX including surrogate pairs, as
+// UTF-8) and truncated on a character boundary when the buffer is too small.
+// Unpaired surrogates and \u0000 become U+FFFD, so a value never contains a NUL.
+// Numbers, true, false and null are copied as written; nested objects and
+// arrays are skipped.
+class JsonFieldExtractor : public Stream {
+private:
+    struct Field {
+        const char* key;
+        char* buffer;
+        size_t size;
+        size_t length;
+        bool found;
+        bool truncated;
+    };
+
+    Field fields[JSON_EXTRACT_MAX_FIELDS];
+    int fieldCount;
+
+    int depth;
+    bool expectKey;                     // Next string at depth 1 is a key
+    bool readingKey;
+    bool inString;
+    bool escaped;
+    bool inScalar;
+    int8_t unicodeDigits;               // -1 outside a \u escape
+    uint16_t unicodeValue;
+    uint16_t highSurrogate;
+    int target;                         // Field receiving the current value, -1 for none
+    char key[JSON_EXTRACT_KEY_SIZE];
+    size_t keyLength;
+
+    void feed(char c);
+    void handleEscape(char c);
+    void emitByte(uint8_t b);
+    void emitCodepoint(uint32_t codepoint);
+    void flushHighSurrogate();
+    void endValue();
+    int findField() const;
+
+public:
+    JsonFieldExtractor();
+
+    // Registers a field to extract; returns its index, or -1 if the table is full.
+    // The buffer is always NUL-terminated.
+    int addField(const char* key, char* buffer, size_t size);
+
+    // Clears the parser and all field buffers for the next response
+    void reset();
+
+    // True once the field's value has been read completely
+    bool isFound(int field) const { return field >= 0 && field < fieldCount && fields[field].found; }
+    bool isTruncated(int field) const { return field >= 0 && field < fieldCount && fields[field].truncated; }
+
+    // Stream sink interface; reading from the extractor yields nothing
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+};
+
+#endif // JSON_FIELD_EXTRACTOR_H
@@ -0,0 +1,58 @@
+#ifndef MAX30105_FIFO_H
+#define MAX30105_FIFO_H
+
+#include <stdint.h>
+
+// MAX30105 FIFO registers used for burst reads. WR_PTR, OVF_COUNTER and RD_PTR
+// are consecutive, so one 3-byte read starting at WR_PTR is a consistent snapshot.
+#define MAX30105_REG_FIFO_WR_PTR 0x04
+#define MAX30105_REG_OVF_COUNTER 0x05    // Samples lost while the FIFO was full (saturates at 0x1F)
+#define MAX30105_REG_FIFO_RD_PTR 0x06
+#define MAX30105_REG_FIFO_DATA 0x07
+#define MAX30105_FIFO_DEPTH 32
+#define MAX30105_FIFO_PTR_MASK 0x1F      // Pointers are 5-bit; the upper register bits are reserved
+#define MAX30105_OVF_SATURATED 0x1F
+#define MAX30105_BYTES_PER_LED 3
+
+// FIFO pointer registers as read in one burst from MAX30105_REG_FIFO_WR_PTR
+struct FifoPointers {
+    uint8_t writePtr;
+    uint8_t overflow;
+    uint8_t readPtr;
+};
+
+// Number of unread samples in the FIFO.
+// Equal pointers mean either empty or exactly full. With rollover enabled the part
+// only bumps OVF_COUNTER once a sample is actually overwritten, so only then is
+// the FIFO known to be full. For the one sample period before that it reads as
+// empty; the next read finds it overflowed and counts the lost sample. Elapsed
+// time is no hint: a sensor that stopped sampling has equal pointers forever.
+inline int fifoPendingSamples(const FifoPointers& pointers) {
+    int samples = (int)(pointers.writePtr & MAX30105_FIFO_PTR_MASK) -
+                  (int)(pointers.readPtr & MAX30105_FIFO_PTR_MASK);
+    if (samples < 0) {
+        samples += MAX30105_FIFO_DEPTH;
+    }
+    if (samples == 0 && pointers.overflow > 0) {
+        samples = MAX30105_FIFO_DEPTH;
+    }
+    return samples;
+}
+
+// Samples are timestamped from a running count at the configured rate, not from
+// when the host got around to reading them. The newest sample in the FIFO was
+// taken within the sample period before the pointers were read, so a model time
+// outside [now - period, now] is drift between the sensor oscillator and micros().
+// Returns the shift that brings the model back inside that window (0 if it is).
+inline int32_t sampleClockCorrection(uint32_t newestTime, uint32_t now, uint32_t periodUs) {
+    int32_t lag = (int32_t)(now - newestTime);
+    if (lag < 0) {
+        return lag;
+    }
+    if (lag > (int32_t)periodUs) {
+        return lag - (int32_t)periodUs;
+    }
+    return 0;
+}
+
+#endif // MAX30105_FIFO_H
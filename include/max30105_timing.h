@@ -0,0 +1,35 @@
+#ifndef MAX30105_TIMING_H
+#define MAX30105_TIMING_H
+
+// Every enabled LED slot needs its pulse plus ADC conversion inside one sample
+// period, so the widest usable pulse shrinks as the rate and LED count go up.
+// Fastest allowed sample rate per pulse width, from the MAX30105 datasheet's
+// SpO2 mode (RED + IR) and multi-LED mode (RED + IR + GREEN) settings tables.
+struct PulseWidthLimit {
+    int pulseWidthUs;      // Also sets the ADC resolution: 411us = 18 bit ... 69us = 15 bit
+    int maxRateTwoLeds;
+    int maxRateThreeLeds;
+};
+
+constexpr int MAX30105_PULSE_WIDTH_COUNT = 4;
+constexpr PulseWidthLimit MAX30105_PULSE_WIDTH_LIMITS[MAX30105_PULSE_WIDTH_COUNT] = {
+    {411,  400,  200},
+    {215,  800,  400},
+    {118, 1000,  800},
+    { 69, 1600, 1000}
+};
+
+// Widest pulse no longer than `preferredUs` that fits `ledCount` slots at
+// `sampleRate`. Falls back to the narrowest pulse if nothing fits.
+inline int max30105PulseWidthFor(int sampleRate, int ledCount, int preferredUs) {
+    for (int i = 0; i < MAX30105_PULSE_WIDTH_COUNT; i++) {
+        const PulseWidthLimit& limit = MAX30105_PULSE_WIDTH_LIMITS[i];
+        int maxRate = (ledCount >= 3) ? limit.maxRateThreeLeds : limit.maxRateTwoLeds;
+        if (limit.pulseWidthUs <= preferredUs && sampleRate <= maxRate) {
+            return limit.pulseWidthUs;
+        }
+    }
+    return MAX30105_PULSE_WIDTH_LIMITS[MAX30105_PULSE_WIDTH_COUNT - 1].pulseWidthUs;
+}
+
+#endif // MAX30105_TIMING_H
@@ -0,0 +1,65 @@
+#ifndef MEASUREMENT_QUEUE_H
+#define MEASUREMENT_QUEUE_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define MEASUREMENT_QUEUE_FILE "/measurements.bin"
+#define MEASUREMENT_QUEUE_CAPACITY 256          // Slots in the ring file (16 KB); the oldest record is dropped when full
+#define MEASUREMENT_QUEUE_NVS "mqueue"          // Preferences namespace holding the acknowledged sequence
+#define MEASUREMENT_QUEUE_USER_ID_SIZE 48       // Firebase UIDs are 28 characters
+#define MEASUREMENT_QUEUE_RETRY_MS 30000        // Pause after a failed upload
+
+// One queued measurement; exactly 64 bytes on flash
+struct QueuedMeasurement {
+    uint32_t sequence;                          // Monotonic, never 0 for a written slot
+    int32_t heartRate;
+    int32_t spo2;
+    char userId[MEASUREMENT_QUEUE_USER_ID_SIZE];
+    uint32_t crc;                               // CRC-32 of the fields above
+};
+
+// Persistent store-and-forward queue for finished measurements. Records live
+// in a fixed-size ring file on LittleFS, slot = sequence % capacity, so every
+// slot is rewritten equally often. A torn write fails its CRC and is ignored.
+// The tail is recovered at boot from the highest valid sequence in the file;
+// the head is the last acknowledged sequence, committed to NVS, which is
+// atomic on power loss. A crash between upload and ack re-sends the record,
+// it is never lost. Safe to use from loop() and background job tasks.
+class MeasurementQueue {
+private:
+    bool ready;
+    SemaphoreHandle_t lock;
+    uint32_t nextSequence;                      // Sequence of the next append
+    uint32_t ackedSequence;                     // Everything up to here has been uploaded
+    uint32_t dropped;                           // Overwritten before they could be uploaded
+
+    static uint32_t crc32(const uint8_t* data, size_t length);
+    bool readSlot(File& file, uint32_t sequence, QueuedMeasurement& record);
+    void recover();
+    void saveAcked();
+
+public:
+    MeasurementQueue();
+
+    // Mounts LittleFS (formatting it if unusable) and recovers head and tail
+    bool begin();
+
+    // Returns the sequence given to the record, or 0 if it couldn't be stored
+    uint32_t append(int32_t heartRate, int32_t spo2, const String& userId);
+
+    // Copies up to maxCount consecutive unacknowledged records, oldest first,
+    // without removing them; returns how many were copied (0 if empty)
+    int peek(QueuedMeasurement* records, int maxCount);
+
+    // Marks everything up to and including sequence as uploaded
+    void ack(uint32_t sequence);
+
+    uint32_t pending();
+    uint32_t getDropped() const { return dropped; }
+    uint32_t getAckedSequence() const { return ackedSequence; }
+    uint32_t getLastSequence() const { return nextSequence - 1; }
+    bool isReady() const { return ready; }
+};
+
+#endif // MEASUREMENT_QUEUE_H
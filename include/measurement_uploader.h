@@ -0,0 +1,65 @@
+#ifndef MEASUREMENT_UPLOADER_H
+#define MEASUREMENT_UPLOADER_H
+
+#include <Arduino.h>
+#include "uplink_client.h"
+#include "measurement_queue.h"
+
+#define UPLOAD_BATCH_MAX 16                     // Records coalesced into one request
+#define UPLOAD_BATCH_WINDOW_MS 10000            // How long the oldest queued record waits for others to join it
+#define UPLOAD_BATCH_PATH "/api/records/batch"
+#define UPLOAD_SINGLE_PATH "/api/records"
+#define UPLOAD_TIMEOUT_MS 5000
+#define UPLOAD_BODY_SIZE 1536                   // UPLOAD_BATCH_MAX records of at most ~90 bytes each
+
+// Uploads the head of the MeasurementQueue. Up to UPLOAD_BATCH_MAX records of
+// the same user go out as one POST of a JSON array. Every record carries the
+// id "<device uid>-<sequence>" (see getDeviceUid()), so the server can drop
+// duplicates per record, and the request an Idempotency-Key built from the
+// sequence range. The batch contents are frozen until the server acknowledges
+// them: a retry after a failed or lost response resends exactly the same
+// records under the same key, even if more were queued in the meantime.
+// Servers without the batch endpoint (404/405) get one POST per record
+// instead, each keyed by its record id.
+// Only called from the drain job; the buffers are members to keep them off
+// the job task's stack.
+class MeasurementUploader {
+private:
+    UplinkClient& uplink;
+    MeasurementQueue& queue;
+    volatile bool batchSupported;
+    volatile bool windowOpen;                   // Records are waiting for the batch window to close
+    unsigned long windowStart;
+    QueuedMeasurement batch[UPLOAD_BATCH_MAX];
+    int batchCount;                             // Records frozen in batch[] until acknowledged, 0 if none
+    char body[UPLOAD_BODY_SIZE];
+
+    uint32_t requests;
+    uint32_t uploaded;
+    uint32_t bytes;                             // Request bodies sent, for bytes/record
+
+    int freezeBatch();
+    int buildBody(int count);
+    bool postBatch(int count);
+    bool postSingle(const QueuedMeasurement& record);
+
+public:
+    MeasurementUploader(UplinkClient& uplink, MeasurementQueue& queue);
+
+    // Call after each append; opens the batch window for the first record
+    void noteQueued();
+
+    // True once UPLOAD_BATCH_MAX records are waiting or the window has passed.
+    // A backlog found at boot is due at once.
+    bool isDue(uint32_t pending) const;
+
+    // Uploads one batch from the head of the queue and acknowledges it.
+    // Returns the number of records uploaded, or -1 if the request failed.
+    int uploadBatch();
+
+    uint32_t getRequests() const { return requests; }
+    uint32_t getUploaded() const { return uploaded; }
+    uint32_t getBytes() const { return bytes; }
+};
+
+#endif // MEASUREMENT_UPLOADER_H
@@ -0,0 +1,116 @@
+#ifndef MELODY_H
+#define MELODY_H
+
+#include <Arduino.h>
+#include "pitches.h"
+
+// Compact melodies for TonePlayer, compiled from pitches.h note lists at
+// compile time:
+//
+//     const Melody chime = MELODY(NOTE_C6, REST, REST, NOTE_E6);
+//
+// Each note becomes one 2-byte MelodyStep holding its index in MELODY_PITCHES
+// and its length in beats; the RESTs after a note are merged into it, and
+// leading RESTs become one silent step. A beat is what one entry of the note
+// list lasted with the old int-array melodies, so playback timing is the same.
+
+// Pitch 0 is REST; the rest are all notes of pitches.h in ascending order
+constexpr uint16_t MELODY_PITCHES[] = {
+    REST,
+    NOTE_B0, NOTE_C1, NOTE_CS1, NOTE_D1, NOTE_DS1, NOTE_E1, NOTE_F1, NOTE_FS1,
+    NOTE_G1, NOTE_GS1, NOTE_A1, NOTE_AS1, NOTE_B1, NOTE_C2, NOTE_CS2, NOTE_D2,
+    NOTE_DS2, NOTE_E2, NOTE_F2, NOTE_FS2, NOTE_G2, NOTE_GS2, NOTE_A2, NOTE_AS2,
+    NOTE_B2, NOTE_C3, NOTE_CS3, NOTE_D3, NOTE_DS3, NOTE_E3, NOTE_F3, NOTE_FS3,
+    NOTE_G3, NOTE_GS3, NOTE_A3, NOTE_AS3, NOTE_B3, NOTE_C4, NOTE_CS4, NOTE_D4,
+    NOTE_DS4, NOTE_E4, NOTE_F4, NOTE_FS4, NOTE_G4, NOTE_GS4, NOTE_A4, NOTE_AS4,
+    NOTE_B4, NOTE_C5, NOTE_CS5, NOTE_D5, NOTE_DS5, NOTE_E5, NOTE_F5, NOTE_FS5,
+    NOTE_G5, NOTE_GS5, NOTE_A5, NOTE_AS5, NOTE_B5, NOTE_C6, NOTE_CS6, NOTE_D6,
+    NOTE_DS6, NOTE_E6, NOTE_F6, NOTE_FS6, NOTE_G6, NOTE_GS6, NOTE_A6, NOTE_AS6,
+    NOTE_B6, NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7, NOTE_FS7,
+    NOTE_G7, NOTE_GS7, NOTE_A7, NOTE_AS7, NOTE_B7, NOTE_C8, NOTE_CS8, NOTE_D8,
+    NOTE_DS8
+};
+constexpr int MELODY_PITCH_COUNT = sizeof(MELODY_PITCHES) / sizeof(MELODY_PITCHES[0]);
+constexpr uint8_t MELODY_NO_PITCH = 0xFF;
+
+struct MelodyStep {
+    uint8_t pitch;              // Index into MELODY_PITCHES
+    uint8_t beats;              // The note plus the RESTs merged into it
+};
+
+struct Melody {
+    const MelodyStep* steps;
+    uint16_t length;
+};
+
+// Compile-time helpers for MELODY(); C++11 constexpr, so recursion instead of loops
+namespace melody_compiler {
+
+constexpr uint8_t pitchIndex(int frequency, int i = 0) {
+    return i >= MELODY_PITCH_COUNT ? MELODY_NO_PITCH
+         : MELODY_PITCHES[i] == frequency ? i
+         : pitchIndex(frequency, i + 1);
+}
+
+constexpr bool allPitchesKnown(const int* notes, int count, int i = 0) {
+    return i >= count || (pitchIndex(notes[i]) != MELODY_NO_PITCH && allPitchesKnown(notes, count, i + 1));
+}
+
+// A step starts at the first entry and at every note
+constexpr bool isStepStart(const int* notes, int i) {
+    return i == 0 || notes[i] != REST;
+}
+
+constexpr int countSteps(const int* notes, int count, int i = 0) {
+    return i >= count ? 0 : (isStepStart(notes, i) ? 1 : 0) + countSteps(notes, count, i + 1);
+}
+
+// Position of step k in the note list, count past the last step
+constexpr int stepStart(const int* notes, int count, int k, int i = 0) {
+    return i >= count ? count
+         : !isStepStart(notes, i) ? stepStart(notes, count, k, i + 1)
+         : k == 0 ? i
+         : stepStart(notes, count, k - 1, i + 1);
+}
+
+constexpr int stepBeats(const int* notes, int count, int k) {
+    return stepStart(notes, count, k + 1) - stepStart(notes, count, k);
+}
+
+constexpr bool allBeatsFit(const int* notes, int count, int steps, int k = 0) {
+    return k >= steps || (stepBeats(notes, count, k) <= 0xFF && allBeatsFit(notes, count, steps, k + 1));
+}
+
+constexpr MelodyStep makeStep(const int* notes, int count, int k) {
+    return MelodyStep{pitchIndex(notes[stepStart(notes, count, k)]), (uint8_t)stepBeats(notes, count, k)};
+}
+
+template<int... Ks> struct Indices {};
+template<int N, int... Ks> struct MakeIndices : MakeIndices<N - 1, N - 1, Ks...> {};
+template<int... Ks> struct MakeIndices<0, Ks...> { typedef Indices<Ks...> type; };
+
+template<int... Notes> struct NoteList {
+    static constexpr int notes[] = {Notes...};
+    static constexpr int count = sizeof...(Notes);
+    static constexpr int steps = countSteps(notes, count);
+};
+template<int... Notes> constexpr int NoteList<Notes...>::notes[];
+
+template<typename List, typename Steps = typename MakeIndices<List::steps>::type> struct Compiler;
+
+template<typename List, int... Ks> struct Compiler<List, Indices<Ks...>> {
+    static_assert(List::count > 0, "MELODY() needs at least one note");
+    static_assert(allPitchesKnown(List::notes, List::count), "MELODY() note is not in MELODY_PITCHES");
+    static_assert(allBeatsFit(List::notes, List::count, List::steps), "MELODY() has more than 254 RESTs in a row");
+
+    static constexpr MelodyStep steps[] = {makeStep(List::notes, List::count, Ks)...};
+    static constexpr Melody melody = {steps, List::steps};
+};
+template<typename List, int... Ks> constexpr MelodyStep Compiler<List, Indices<Ks...>>::steps[];
+template<typename List, int... Ks> constexpr Melody Compiler<List, Indices<Ks...>>::melody;
+
+} // namespace melody_compiler
+
+#define MELODY(...) (melody_compiler::Compiler<melody_compiler::NoteList<__VA_ARGS__>>::melody)
+
+#endif // MELODY_H
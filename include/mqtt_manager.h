@@ -4,7 +4,9 @@
 #include <Arduino.h>
 #include <WiFiClientSecure.h>
 #include <PubSubClient.h>
+#include <ArduinoJson.h>
 #include "common_types.h"
+#include "tone_player.h"
 
 // MQTT Configuration
 #define MQTT_BROKER       "70030b8b8dc741c79d6ab7ffa586f461.s1.eu.hivemq.cloud"
@@ -13,6 +15,18 @@
 #define MQTT_PASSWORD     "Thai2005"
 #define MQTT_QOS_LEVEL    1
 
+// Device telemetry, MessagePack encoded, on MQTT_TOPIC_PREFIX<device id>/{result,session,heartbeat}.
+// The device id is getDeviceUid(), so every unit has its own topics and broker client id.
+#define MQTT_TOPIC_PREFIX "healthsense/"
+#define MQTT_TOPIC_SIZE   64
+#define MQTT_PAYLOAD_SIZE 128              // Largest message: an ack with a 40-byte request id
+#define MQTT_HEARTBEAT_INTERVAL_MS 60000
+
+// Remote commands arrive on MQTT_TOPIC_PREFIX<device id>/cmd/<command> and are acknowledged on .../ack
+#define MQTT_COMMAND_JSON_CAPACITY 256
+#define MQTT_COMMAND_NAME_SIZE 16
+#define MQTT_COMMAND_ID_SIZE 40
+
 // Forward declaration
 class SensorManager;
 
@@ -25,18 +39,49 @@ private:
     unsigned long lastReconnectAttempt;
     const int reconnectInterval = 5000; // 5 seconds between reconnect attempts
     int buzzerPin;
+    TonePlayer& tonePlayer;                // Plays notifications and alerts
+    unsigned long lastHeartbeat;
+    unsigned long heartbeatInterval;
+    bool notificationsEnabled;             // Beep on messages to the legacy notification topic
+    uint8_t payload[MQTT_PAYLOAD_SIZE];    // Encode buffer for the publish* methods
     
     // Callback function pointer for measuring status check
     bool (*isMeasuringCallback)();
     
+    // Remote command actions, provided by main.cpp
+    bool (*startMeasurementCallback)();
+    void (*stopMeasurementCallback)();
+    bool (*uploadCallback)();
+    
+    // One entry per remote command; handlers return false and set error to refuse it
+    struct Command {
+        const char* name;
+        bool (MQTTManager::*handler)(JsonDocument& args, const char*& error);
+    };
+    static const Command commands[];
+    
     // Static callback wrapper for MQTT message callback
     static void messageCallbackWrapper(char* topic, byte* payload, unsigned int length);
     
     // Actual message handler (instance method)
     void handleMessage(char* topic, byte* payload, unsigned int length);
+    void handleCommand(const char* name, byte* payload, unsigned int length);
+    void publishAck(const char* command, const char* id, bool ok, const char* error);
+    
+    // Command handlers
+    bool commandAlert(JsonDocument& args, const char*& error);
+    bool commandConfig(JsonDocument& args, const char*& error);
+    bool commandStart(JsonDocument& args, const char*& error);
+    bool commandStatus(JsonDocument& args, const char*& error);
+    bool commandStop(JsonDocument& args, const char*& error);
+    bool commandUpload(JsonDocument& args, const char*& error);
+    
+    // Publishes an encoded payload on MQTT_TOPIC_PREFIX<device id>/<kind>
+    bool publishBinary(const char* kind, size_t length, bool retained);
+    bool publishStatus(const char* kind);
     
 public:
-    MQTTManager(int buzzer_pin);
+    MQTTManager(int buzzer_pin, TonePlayer& tones);
     ~MQTTManager();
     
     void begin();
@@ -49,9 +94,23 @@ public:
     bool subscribe();
     bool publish(const char* topic, const char* message);
     
+    // Telemetry; userId may be empty (guest mode). Published at QoS 0:
+    // PubSubClient can't publish QoS 1, and a second client library would need
+    // its own TLS session and client id on the broker. A result is delivered
+    // reliably anyway: it is persisted in the MeasurementQueue first and
+    // uploaded over HTTPS with idempotency keys until acknowledged, so MQTT
+    // only needs to be the low-latency copy for live subscribers.
+    bool publishResult(int32_t heartRate, int32_t spo2, const char* userId, int probe = 0);
+    bool publishSession(const char* event, const char* userId);
+    
     // Set the callback to check if device is measuring
     void setIsMeasuringCallback(bool (*callback)());
     
+    // Actions behind the start, stop and upload commands
+    void setStartMeasurementCallback(bool (*callback)());
+    void setStopMeasurementCallback(void (*callback)());
+    void setUploadCallback(bool (*callback)());
+    
     // Notification handling
     void playNotification();
 };
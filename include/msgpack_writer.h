@@ -0,0 +1,37 @@
+#ifndef MSGPACK_WRITER_H
+#define MSGPACK_WRITER_H
+
+#include <Arduino.h>
+
+// Encodes MessagePack into a caller-owned fixed buffer, without heap
+// allocation. Integers use the smallest encoding that holds the value.
+// Writes past the end of the buffer are dropped and mark the writer as
+// overflowed; check hasOverflowed() before sending the result.
+class MsgPackWriter {
+private:
+    uint8_t* buffer;
+    size_t size;
+    size_t length;
+    bool overflowed;
+
+    void put(uint8_t b);
+    void putBigEndian(uint32_t value, int bytes);
+    void writeRaw(const char* data, size_t count);
+
+public:
+    MsgPackWriter(uint8_t* buffer, size_t size);
+
+    // A map of count key/value pairs follows; keys are written with writeString()
+    void beginMap(uint16_t count);
+    void beginArray(uint16_t count);
+    void writeString(const char* value);
+    void writeInt(int32_t value);
+    void writeUInt(uint32_t value);
+    void writeBool(bool value);
+    void writeNil();
+
+    size_t getLength() const { return length; }
+    bool hasOverflowed() const { return overflowed; }
+};
+
+#endif // MSGPACK_WRITER_H
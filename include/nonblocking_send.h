@@ -0,0 +1,25 @@
+#ifndef NONBLOCKING_SEND_H
+#define NONBLOCKING_SEND_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+
+// WiFiClient::write() waits for the socket (select() plus retries) until it
+// has taken everything, which stalls the loop on a client that stopped
+// reading. Sends only what the socket buffer accepts right now and returns
+// the number of bytes taken (0 if it is full), or -1 if the connection failed.
+// Used for the long-lived streaming connections (SSE, WebSocket).
+inline int sendNonBlocking(WiFiClient& client, const uint8_t* data, size_t length) {
+    int fd = client.fd();
+    if (fd < 0) {
+        return -1;
+    }
+    int sent = send(fd, data, length, MSG_DONTWAIT);
+    if (sent < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+    return sent;
+}
+
+#endif // NONBLOCKING_SEND_H
@@ -0,0 +1,204 @@
+#ifndef PROBE_SCHEDULER_H
+#define PROBE_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define MAX_SENSOR_PROBES 2            // One probe per ESP32 I2C controller
+#define SCHEDULER_BURST_SAMPLES 8      // Max samples moved per probe per acquisition turn
+
+// Interleaves FIFO reads across several probes so that no probe's FIFO
+// overflows while another one is busy. Every probe keeps its own window,
+// estimator and measurement session; the scheduler only decides who runs when.
+// Probe is SensorManager on the device (see SensorScheduler) and a simulated
+// bus in the native tests; it only needs the acquisition and session calls below.
+template <typename Probe>
+class ProbeScheduler {
+private:
+    Probe* probes[MAX_SENSOR_PROBES];
+    int probeCount;
+    int nextAcquire;       // Probe that reads first in the next acquisition round
+    int nextProcess;       // Probe that gets the next processing slot
+    uint32_t samplesAcquired[MAX_SENSOR_PROBES];
+    uint32_t hopsProcessed[MAX_SENSOR_PROBES];
+    bool active[MAX_SENSOR_PROBES]; // Probe takes part in the current measurement session
+
+public:
+    ProbeScheduler() : probeCount(0), nextAcquire(0), nextProcess(0) {
+        for (int i = 0; i < MAX_SENSOR_PROBES; i++) {
+            probes[i] = nullptr;
+            samplesAcquired[i] = 0;
+            hopsProcessed[i] = 0;
+            active[i] = false;
+        }
+    }
+
+    bool addProbe(Probe* probe) {
+        if (probe == nullptr || probeCount >= MAX_SENSOR_PROBES) {
+            Serial.println(F("❌ Cannot add sensor probe - scheduler full"));
+            return false;
+        }
+
+        probes[probeCount] = probe;
+        probeCount++;
+
+        Serial.print(F("Sensor probe added, total probes: "));
+        Serial.println(probeCount);
+        return true;
+    }
+
+    // One scheduling round: a bounded FIFO burst for every probe (rotating who
+    // goes first), then at most one probe gets to run its HR/SpO2 computation
+    void service() {
+        if (probeCount == 0) {
+            return;
+        }
+
+        // Acquisition: every active probe gets a bounded burst, starting from a
+        // different probe each round so none is consistently served last
+        for (int n = 0; n < probeCount; n++) {
+            int i = (nextAcquire + n) % probeCount;
+            Probe* probe = probes[i];
+
+            if (!probe->isReady() || probe->isProximityIdle() || probe->isMeasurementReady()) {
+                continue;
+            }
+            samplesAcquired[i] += probe->serviceFifo(SCHEDULER_BURST_SAMPLES);
+        }
+        nextAcquire = (nextAcquire + 1) % probeCount;
+
+        // Processing: at most one probe per round, so a round never costs more than
+        // one HR/SpO2 computation. Idle probes need a turn to poll their proximity flag.
+        for (int n = 0; n < probeCount; n++) {
+            int i = (nextProcess + n) % probeCount;
+            Probe* probe = probes[i];
+
+            if (!probe->isReady() || probe->isMeasurementReady()) {
+                continue;
+            }
+
+            if (probe->isHopReady() || probe->isProximityIdle()) {
+                bool wasHop = probe->isHopReady();
+                probe->processReadings();
+                if (wasHop) {
+                    hopsProcessed[i]++;
+                }
+                nextProcess = (i + 1) % probeCount;
+                break;
+            }
+        }
+    }
+
+    // Measurement control for all probes
+    void startMeasurement() {
+        for (int i = 0; i < probeCount; i++) {
+            active[i] = probes[i]->isReady();
+            if (active[i]) {
+                probes[i]->startMeasurement();
+            }
+        }
+    }
+
+    // Restarts ready probes that are neither measuring nor complete
+    int resumeMeasurement() {
+        int started = 0;
+        for (int i = 0; i < probeCount; i++) {
+            Probe* probe = probes[i];
+            if (probe->isReady() && !probe->isMeasurementInProgress() && !probe->isMeasurementReady()) {
+                probe->startMeasurement();
+                active[i] = true;
+                started++;
+            }
+        }
+        return started;
+    }
+
+    void stopMeasurement() {
+        // Finished probes keep their results
+        for (int i = 0; i < probeCount; i++) {
+            if (probes[i]->isMeasurementInProgress()) {
+                probes[i]->stopMeasurement();
+            }
+            active[i] = false;
+        }
+    }
+
+    // Any probe still collecting readings
+    bool isMeasurementInProgress() const {
+        for (int i = 0; i < probeCount; i++) {
+            if (probes[i]->isMeasurementInProgress()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Every active probe that is still ready has finished
+    bool isMeasurementComplete() const {
+        // A probe that dropped off the bus mid-session no longer holds the others up
+        int completed = 0;
+        for (int i = 0; i < probeCount; i++) {
+            if (!active[i] || !probes[i]->isReady()) {
+                continue;
+            }
+            if (!probes[i]->isMeasurementReady()) {
+                return false;
+            }
+            completed++;
+        }
+        return completed > 0;
+    }
+
+    // At least one probe can measure; the others are skipped until they recover
+    bool isReady() const {
+        for (int i = 0; i < probeCount; i++) {
+            if (probes[i]->isReady()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void setReady(bool ready) {
+        for (int i = 0; i < probeCount; i++) {
+            probes[i]->setReady(ready);
+        }
+    }
+
+    // Health-checks every probe (each one resets itself after repeated errors).
+    // Returns true while at least one probe responds.
+    bool checkI2CConnection() {
+        bool anyConnected = false;
+        for (int i = 0; i < probeCount; i++) {
+            if (probes[i]->checkI2CConnection()) {
+                anyConnected = true;
+            }
+        }
+        return anyConnected;
+    }
+
+    // Getters
+    int getProbeCount() const { return probeCount; }
+
+    Probe* getProbe(int index) const {
+        if (index < 0 || index >= probeCount) {
+            return nullptr;
+        }
+        return probes[index];
+    }
+
+    uint32_t getSamplesAcquired(int index) const {
+        if (index < 0 || index >= probeCount) {
+            return 0;
+        }
+        return samplesAcquired[index];
+    }
+
+    uint32_t getHopsProcessed(int index) const {
+        if (index < 0 || index >= probeCount) {
+            return 0;
+        }
+        return hopsProcessed[index];
+    }
+};
+
+#endif // PROBE_SCHEDULER_H
@@ -0,0 +1,85 @@
+#ifndef PROXIMITY_IDLE_H
+#define PROXIMITY_IDLE_H
+
+#include <stdint.h>
+
+// Proximity idle mode: while no finger is present the sensor runs its built-in
+// proximity detection with a weak IR pilot and we only poll the interrupt flag
+#define MAX30105_MODE_SPO2 0x03          // MODECONFIG value for RED + IR
+#define MAX30105_MODE_MULTILED 0x07      // MODECONFIG value for RED + IR + GREEN slots
+#define MAX30105_INT_PROX 0x10           // PROX_INT bit in interrupt status 1
+#define PROXIMITY_PILOT_AMPLITUDE 0x1F   // IR pilot current while idle (~6.4mA vs 12mA measuring)
+#define PROXIMITY_THRESHOLD 0x08         // Compared with the 8 MSBs of the IR ADC count
+#define PROXIMITY_POLL_INTERVAL_MS 100   // How often to check the PROX_INT flag while idle
+#define PROXIMITY_IDLE_AFTER_MISSES 2    // Consecutive no-finger windows before going idle
+
+// Decides when the sensor drops into proximity mode and when a finger wakes it.
+// Sensor is the SparkFun MAX30105 driver on the device and a register model in
+// the native tests; only the register writes below are needed. Bringing the
+// sensor back to full measurement settings is left to the caller, which also
+// owns the sample window.
+template <typename Sensor>
+class ProximityIdle {
+private:
+    bool idle;                     // Sensor is waiting for a finger in proximity mode
+    unsigned long lastPoll;        // Last time PROX_INT was polled
+    int missedWindows;             // Consecutive processed windows without a finger
+
+public:
+    ProximityIdle() : idle(false), lastPoll(0), missedWindows(0) {}
+
+    // The sensor was (re)configured for measuring; a soft reset also clears PROX_INT_EN
+    void reset() {
+        idle = false;
+        missedWindows = 0;
+    }
+
+    void fingerSeen() { missedWindows = 0; }
+
+    // Counts a window without a finger and switches the sensor to proximity
+    // mode after PROXIMITY_IDLE_AFTER_MISSES of them. Returns true on the switch.
+    bool fingerMissing(Sensor& sensor, bool multiLed, unsigned long now) {
+        missedWindows++;
+        if (missedWindows < PROXIMITY_IDLE_AFTER_MISSES) {
+            return false;
+        }
+
+        // Red LED off, IR only at the low pilot current used by proximity mode
+        sensor.setPulseAmplitudeRed(0);
+        sensor.setPulseAmplitudeProximity(PROXIMITY_PILOT_AMPLITUDE);
+        sensor.setPROXINTTHRESH(PROXIMITY_THRESHOLD);
+
+        // Clear any stale interrupt flags, then arm the proximity interrupt.
+        // Rewriting the mode register is what puts the part back into proximity mode.
+        sensor.getINT1();
+        sensor.enablePROXINT();
+        sensor.setLEDMode(multiLed ? MAX30105_MODE_MULTILED : MAX30105_MODE_SPO2);
+
+        idle = true;
+        missedWindows = 0;
+        lastPoll = now;
+        return true;
+    }
+
+    // Reads interrupt status 1 at most every PROXIMITY_POLL_INTERVAL_MS. Returns
+    // true once PROX_INT has fired; the caller then restores full SpO2 mode.
+    bool poll(Sensor& sensor, unsigned long now) {
+        if (!idle || now - lastPoll < PROXIMITY_POLL_INTERVAL_MS) {
+            return false;
+        }
+        lastPoll = now;
+
+        // Reading interrupt status 1 also clears it
+        uint8_t status = sensor.getINT1();
+        if (!(status & MAX30105_INT_PROX)) {
+            return false;
+        }
+
+        idle = false;
+        return true;
+    }
+
+    bool isIdle() const { return idle; }
+};
+
+#endif // PROXIMITY_IDLE_H
@@ -8,6 +8,10 @@
 // Wire.h is included before MAX30105.h to avoid buffer length conflicts
 #include "spo2_algorithm.h"
 #include "MAX30105.h"
+#include "fir_decimator.h"
+#include "max30105_fifo.h"
+#include "max30105_timing.h"
+#include "proximity_idle.h"
 
 // Forward declaration of DisplayManager class
 class DisplayManager;
@@ -18,6 +22,7 @@ class DisplayManager;
 #define LED_BRIGHTNESS_VERY_LOW 0x15   // Very low brightness for extreme cases
 #define SAMPLE_AVERAGE 4               // Number of samples to average
 #define LED_MODE_SPO2 2                // Mode 2 = RED + IR for SpO2
+#define LED_MODE_MULTI 3               // Mode 3 = RED + IR + GREEN
 #define SAMPLE_RATE 100                // 100Hz sample rate
 #define PULSE_WIDTH 411                // Maximum pulse width for sensitivity
 #define ADC_RANGE 4096                 // Default ADC range
@@ -33,21 +38,69 @@ class DisplayManager;
 #define REQUIRED_VALID_READINGS 5      // Number of valid readings required before averaging
 #define MEASUREMENT_TIMEOUT_MS 120000   // Maximum time to wait for 5 valid readings (120 seconds - longer for I2C recovery)
 
+// Acquisition pipeline: where oversampled data is reduced to the processing rate
+enum AcquisitionMode {
+    ACQ_ONCHIP_AVERAGE,     // 100Hz with 4x on-chip boxcar averaging (SparkFun example settings)
+    ACQ_HOST_DECIMATE_400,  // 400Hz raw, burst FIFO reads, host FIR decimation by 16
+    ACQ_HOST_DECIMATE_800   // 800Hz raw, burst FIFO reads, host FIR decimation by 32
+};
+
+#ifndef SENSOR_ACQUISITION_MODE
+#define SENSOR_ACQUISITION_MODE ACQ_ONCHIP_AVERAGE
+#endif
+
+// Green channel: much stronger pulsatile signal, less sensitive to motion
+#ifndef SENSOR_USE_GREEN_LED
+#define SENSOR_USE_GREEN_LED 0
+#endif
+#define HR_FUSION_AGREEMENT_BPM 10     // IR and green HR closer than this are averaged
+
+#define PROCESSING_RATE_HZ 25          // Rate the SpO2/HR algorithm expects (100Hz / 4 averaged)
+#define SAMPLE_HOP 25                  // New samples per processing pass (window slides by this much)
+#define SENSOR_READ_TIMEOUT_MS 1000    // Blocking reads give up if the FIFO stays empty this long
+
+#define DECIMATED_QUEUE_SIZE MAX30105_FIFO_DEPTH // Samples buffered between burst reads (a full FIFO without decimation)
+
+// Sample timing: every sample carries a micros() timestamp from a running sample
+// count at the configured rate, anchored on the first FIFO read
+#define SAMPLE_PERIOD_US (1000000UL / PROCESSING_RATE_HZ) // Nominal spacing of processed samples
+#define GAP_FILL_MAX_US 80000          // Shorter FIFO gaps are bridged by linear interpolation
+#define JITTER_BUCKET_COUNT 6          // |clock correction| buckets per raw period: <1%, <5%, <10%, <25%, <50%, >=50%
+
+// Acquisition timing and loss counters, see getDiagnostics()
+struct SensorDiagnostics {
+    uint32_t samplesAcquired;      // Processed samples stored in the window
+    uint32_t samplesDropped;       // Raw samples lost to FIFO or queue overflow
+    uint32_t fifoOverflows;        // FIFO reads that found the hardware FIFO had overflowed
+    uint32_t samplesInterpolated;  // Raw samples synthesized to bridge short gaps
+    uint32_t windowsInvalidated;   // Processing passes discarded because the window spans a gap
+    uint32_t maxIntervalUs;        // Longest interval seen between two processed samples
+    uint32_t clockCorrections;     // Times the sample clock was re-aligned with micros()
+    uint32_t jitterHistogram[JITTER_BUCKET_COUNT]; // Per FIFO read: host read time against the sample clock model
+};
+
 class SensorManager {
 private:
     MAX30105* particleSensor;
     uint32_t* irBuffer;    // infrared LED sensor data
     uint32_t* redBuffer;   // red LED sensor data
+    uint32_t* greenBuffer; // green LED sensor data (multi-LED mode only)
+    uint32_t* timeBuffer;  // micros() timestamp of each sample in the window
     int32_t bufferLength;  // data length
     int32_t spo2;          // SPO2 value
     int8_t validSPO2;      // indicator to show if the SPO2 calculation is valid
     int32_t heartRate;     // heart rate value
     int8_t validHeartRate; // indicator to show if the heart rate calculation is valid
+    int32_t greenHeartRate; // heart rate from the green channel (0 if invalid)
+    bool multiLedMode;     // Whether the green LED should be sampled as a third channel
+    bool multiLedActive;   // multiLedMode as of the last configureSensor(); decides the FIFO layout
     bool sensorReady;      // Flag indicating if sensor is ready
     unsigned long lastI2CErrorTime; // Last time an I2C error occurred
     int i2cErrorCount;     // Count of consecutive I2C errors
     int sda_pin;           // SDA pin for I2C
     int scl_pin;           // SCL pin for I2C
+    TwoWire* wire;         // I2C controller this sensor is attached to
+    int hopFill;           // New samples already stored for the current hop
     
     // Measurement averaging system
     int32_t validReadings[REQUIRED_VALID_READINGS][2]; // Store [HR, SpO2] pairs
@@ -58,22 +111,70 @@ private:
     bool measurementComplete; // Flag indicating measurement is complete
     unsigned long measurementStartTime; // Time when measurement started
     
+    // Host-side decimation pipeline (used by the ACQ_HOST_DECIMATE_* modes)
+    AcquisitionMode acquisitionMode;
+    FirDecimator<FIR_DECIM32_TAP_COUNT> redDecimator;
+    FirDecimator<FIR_DECIM32_TAP_COUNT> irDecimator;
+    FirDecimator<FIR_DECIM32_TAP_COUNT> greenDecimator;
+    uint32_t decimatedRed[DECIMATED_QUEUE_SIZE];
+    uint32_t decimatedIR[DECIMATED_QUEUE_SIZE];
+    uint32_t decimatedGreen[DECIMATED_QUEUE_SIZE];
+    uint32_t decimatedTime[DECIMATED_QUEUE_SIZE];
+    int decimatedHead;     // Oldest decimated sample in the queue
+    int decimatedCount;    // Number of decimated samples waiting
+    
+    // Proximity idle mode
+    ProximityIdle<MAX30105> proximity;
+    
+    // Sample timing and gap tracking
+    uint32_t rawSamplePeriodUs; // Spacing of samples in the sensor FIFO
+    bool rawStreamStarted; // A raw sample has been read since the last (re)configuration
+    uint32_t nextRawTime;  // Sample clock: timestamp due to the next raw sample in the FIFO
+    uint32_t lastRawRed;   // Newest raw values, used to interpolate across short gaps
+    uint32_t lastRawIR;
+    uint32_t lastRawGreen;
+    bool sampleStreamStarted; // A processed sample has been stored since the last (re)configuration
+    uint32_t lastSampleTime; // Timestamp of the newest processed sample
+    int samplesUntilClean; // Stored samples until the window no longer spans a gap
+    SensorDiagnostics diagnostics;
+    
     // Callbacks
     void (*updateReadingsCallback)(int32_t hr, bool validHR, int32_t spo2, bool validSPO2);
     void (*updateFingerStatusCallback)(bool fingerDetected);
     void (*measurementCompleteCallback)(int32_t avgHR, int32_t avgSpO2);
+    void (*hopCallback)(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count);
+    
+    // Acquisition helpers
+    void configureSensor();
+    bool readNextSample(uint32_t& red, uint32_t& ir, uint32_t& green, uint32_t& timestampUs);
+    bool tryReadSample(uint32_t& red, uint32_t& ir, uint32_t& green, uint32_t& timestampUs);
+    void storeSample(int index, uint32_t red, uint32_t ir, uint32_t green, uint32_t timestampUs);
+    void shiftWindow();
+    void computeReadings();
+    void fuseGreenHeartRate();
+    bool readFifoPointers(FifoPointers& pointers);
+    void drainFifo();
+    void abortFifoRead(int samplesLost);
+    void pushRawSample(uint32_t red, uint32_t ir, uint32_t green, uint32_t timestampUs);
+    void markGap();
+    bool pollProximity();
 
 public:
     SensorManager(int bufferSize = 100);
     ~SensorManager();
     
-    void begin(int sda_pin, int scl_pin);
+    void begin(int sda_pin, int scl_pin, TwoWire& bus = Wire);
     void initializeSensor();
     void readSensor();
     void processReadings();
     void resetSensor();
     bool checkI2CConnection();
     
+    // Non-blocking acquisition used by SensorScheduler: moves up to maxSamples
+    // from the FIFO into the current hop and returns how many were moved
+    int serviceFifo(int maxSamples);
+    bool isHopReady() const { return hopFill >= SAMPLE_HOP; }
+    
     // Getters
     int32_t getHeartRate() const { return heartRate; }
     bool isHeartRateValid() const { return validHeartRate; }
@@ -81,6 +182,20 @@ public:
     bool isSPO2Valid() const { return validSPO2; }
     bool isReady() const { return sensorReady; }
     bool isFingerDetected() const;
+    AcquisitionMode getAcquisitionMode() const { return acquisitionMode; }
+    bool isProximityIdle() const { return proximity.isIdle(); }
+    bool isMultiLedMode() const { return multiLedActive; }
+    int32_t getGreenHeartRate() const { return greenHeartRate; }
+    
+    // Timing diagnostics
+    const SensorDiagnostics& getDiagnostics() const { return diagnostics; }
+    void resetDiagnostics();
+    uint32_t getSampleTime(int index) const { return timeBuffer[index]; } // micros() of window sample
+    bool isWindowClean() const { return samplesUntilClean == 0; }
+    
+    // Takes effect the next time the sensor is (re)initialized
+    void setAcquisitionMode(AcquisitionMode mode) { acquisitionMode = mode; }
+    void setMultiLedMode(bool enabled) { multiLedMode = enabled; }
     
     // Measurement control
     void startMeasurement();
@@ -95,6 +210,8 @@ public:
     void setUpdateReadingsCallback(void (*callback)(int32_t hr, bool validHR, int32_t spo2, bool validSPO2));
     void setUpdateFingerStatusCallback(void (*callback)(bool fingerDetected));
     void setMeasurementCompleteCallback(void (*callback)(int32_t avgHR, int32_t avgSpO2));
+    // Called with the raw samples of every completed hop (oldest first)
+    void setHopCallback(void (*callback)(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count));
     
     void setReady(bool ready) { sensorReady = ready; }
 };
@@ -0,0 +1,17 @@
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <Arduino.h>
+#include "sensor_manager.h"
+#include "probe_scheduler.h"
+
+// Number of MAX30105 probes fitted. The sensor address is fixed (0x57), so the
+// ESP32's two I2C controllers allow at most two probes without a mux.
+#ifndef SENSOR_PROBE_COUNT
+#define SENSOR_PROBE_COUNT 1
+#endif
+
+// The scheduler that services the fitted MAX30105 probes
+typedef ProbeScheduler<SensorManager> SensorScheduler;
+
+#endif // SENSOR_SCHEDULER_H
@@ -0,0 +1,48 @@
+#ifndef TEMPLATE_STREAM_H
+#define TEMPLATE_STREAM_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+#define TEMPLATE_CHUNK_SIZE 512        // Bytes buffered before a chunk is sent
+#define TEMPLATE_MAX_NAME 24           // Longest placeholder name
+
+// Renders a flash-resident HTML template straight into the response using
+// chunked transfer encoding. Output goes through one fixed buffer, so memory use
+// doesn't depend on the page size and nothing is allocated on the heap.
+//
+// Template syntax:
+//   {{NAME}}               replaced by whatever the value callback writes
+//   {{#NAME}}...{{/NAME}}  kept only if the section callback returns true
+//   {{^NAME}}...{{/NAME}}  kept only if the section callback returns false
+class TemplateStream {
+public:
+    typedef void (*ValueCallback)(const char* name, TemplateStream& out, void* context);
+    typedef bool (*SectionCallback)(const char* name, void* context);
+
+    TemplateStream(WebServer& server);
+
+    // Send the status line and headers; the body follows in chunks
+    void begin(int code, const char* contentType);
+    void render(const char* tpl, ValueCallback value, SectionCallback section, void* context);
+    void end();
+
+    // Used by value callbacks
+    void write(const char* data, size_t length);
+    void print(const char* text);
+    void print(int32_t value);
+    void print(const IPAddress& ip);
+    void printEscaped(const char* text);
+
+    size_t getBytesSent() const { return bytesSent; }
+
+private:
+    WebServer& server;
+    char buffer[TEMPLATE_CHUNK_SIZE];
+    size_t used;
+    size_t bytesSent;
+
+    void flush();
+};
+
+#endif // TEMPLATE_STREAM_H
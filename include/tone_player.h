@@ -0,0 +1,69 @@
+#ifndef TONE_PLAYER_H
+#define TONE_PLAYER_H
+
+#include <Arduino.h>
+#include "melody.h"
+
+#define TONE_QUEUE_DEPTH 4              // Melodies waiting behind the one playing
+#define TONE_LEDC_CHANNEL 0             // Attached to BUZZER_PIN in setup()
+
+enum TonePriority {
+    TONE_PRIORITY_FEEDBACK,     // UI sounds; dropped while the device is quiet
+    TONE_PRIORITY_NOTIFICATION, // Server notifications; dropped while the device is quiet
+    TONE_PRIORITY_ALERT         // Always played
+};
+
+// Plays melodies on the buzzer without blocking: loop() advances the current
+// note from millis(), so the web server and sensor keep running during
+// playback. Melodies wait in a priority queue (FIFO within one priority); a
+// higher priority melody cuts off the one playing. While the quiet callback
+// returns true (e.g. a measurement is running) only alerts are played.
+// Used from the loop task only; melodies must outlive playback.
+class TonePlayer {
+private:
+    struct Playback {
+        const MelodyStep* steps;
+        uint16_t length;
+        uint16_t noteMs;        // Tone on time of each note
+        uint16_t beatMs;        // Tone plus the gap before the next note
+        TonePriority priority;
+    };
+
+    int channel;
+    Playback queue[TONE_QUEUE_DEPTH];
+    int queued;
+    Playback current;
+    bool playing;
+    int step;
+    bool toneOn;
+    unsigned long stepStart;
+    bool (*quietCallback)();
+
+    uint32_t preempted;
+    uint32_t dropped;           // Rejected by a full queue or silenced by the quiet policy
+
+    bool isMuted(TonePriority priority);
+    void startNext();
+    void startStep();
+    void silence();
+
+public:
+    TonePlayer(int ledcChannel = TONE_LEDC_CHANNEL);
+
+    // Queues a MELODY(); a beat lasts 1.3 / tempoDivisor seconds, with the
+    // tone on for the first 1 / tempoDivisor. Returns false if it was dropped.
+    bool play(const Melody& melody, int tempoDivisor, TonePriority priority);
+
+    // Stops playback and clears the queue
+    void stop();
+
+    // Call from loop(); starts, advances and ends notes
+    void loop();
+
+    void setQuietCallback(bool (*callback)());
+    bool isPlaying() const { return playing; }
+    uint32_t getPreempted() const { return preempted; }
+    uint32_t getDropped() const { return dropped; }
+};
+
+#endif // TONE_PLAYER_H
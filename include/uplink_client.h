@@ -0,0 +1,76 @@
+#ifndef UPLINK_CLIENT_H
+#define UPLINK_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+
+#define UPLINK_IDLE_TIMEOUT_MS 20000    // Close the kept-alive connection after this long unused (below common server keep-alive limits)
+#define UPLINK_CONNECT_TIMEOUT_MS 5000
+#define UPLINK_HANDSHAKE_TIMEOUT_S 10
+#define UPLINK_DEFAULT_TIMEOUT_MS 5000  // Same as the HTTPClient default the callers used before
+
+// One extra request header; both strings must outlive the request() call
+struct UplinkHeader {
+    const char* name;
+    const char* value;
+};
+
+// Long-lived HTTP(S) connection to the backend. Requests reuse one socket with
+// HTTP keep-alive, so only the first request after an idle close pays for the
+// TCP and TLS handshake. The connection is closed after UPLINK_IDLE_TIMEOUT_MS
+// without use, when the station link drops, or on demand to free the TLS
+// buffers. Safe to call from loop() and from background job tasks; requests
+// are serialised by a mutex.
+class UplinkClient {
+private:
+    String baseURL;             // Without trailing slash; paths start with '/'
+    bool secure;
+    WiFiClientSecure tlsClient;
+    WiFiClient plainClient;
+    HTTPClient http;
+    SemaphoreHandle_t lock;
+    volatile bool open;         // Socket state after the last request, readable without the lock
+    unsigned long lastUsed;
+
+    uint32_t requests;
+    uint32_t connections;       // Fresh connections, each a full handshake
+    uint32_t reused;            // Requests sent on an already open connection
+    uint32_t idleCloses;
+
+    WiFiClient& transport() { return secure ? (WiFiClient&)tlsClient : plainClient; }
+    int send(const char* method, const String& url, const String& payload,
+             const UplinkHeader* headers, int headerCount, uint16_t timeoutMs, Stream* body, String* etag);
+    void closeLocked();
+
+public:
+    UplinkClient();
+
+    void begin(const String& serverURL);
+
+    // Sends one request and reads the whole response so the connection can be
+    // reused. Returns the HTTP status or a negative HTTPC_ERROR_* code. The
+    // response body is streamed into body when given (e.g. a JsonFieldExtractor)
+    // and discarded otherwise; it is never buffered whole. The response's ETag
+    // header is stored in etag when given.
+    int request(const char* method, const char* path, const String& payload,
+                const UplinkHeader* headers, int headerCount,
+                uint16_t timeoutMs = UPLINK_DEFAULT_TIMEOUT_MS, Stream* body = nullptr,
+                String* etag = nullptr);
+
+    // Closes the connection once it has been idle too long or WiFi went down
+    void loop();
+    // Closes the connection now unless a request is in flight (that one keeps
+    // it and the idle timeout closes it later); never blocks. Returns true if
+    // the connection is closed afterwards.
+    bool close();
+
+    bool isOpen() const { return open; }
+    uint32_t getRequests() const { return requests; }
+    uint32_t getConnections() const { return connections; }
+    uint32_t getReused() const { return reused; }
+    uint32_t getIdleCloses() const { return idleCloses; }
+};
+
+#endif // UPLINK_CLIENT_H
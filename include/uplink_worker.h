@@ -0,0 +1,49 @@
+#ifndef UPLINK_WORKER_H
+#define UPLINK_WORKER_H
+
+#include <Arduino.h>
+#include "background_job.h"
+
+#define UPLINK_WORKER_STACK 8192        // HTTPClient + TLS, same as BACKGROUND_JOB_STACK
+#define UPLINK_WORKER_PRIORITY 1
+#define UPLINK_WORKER_CORE 0            // Off the loop() core so display, sensor and portal keep running
+#define UPLINK_QUEUE_DEPTH 4            // Jobs waiting per priority; submit() fails beyond that
+
+// Highest first
+enum UplinkPriority {
+    UPLINK_PRIORITY_RESULTS,            // Login and fresh measurement results the user is waiting on
+    UPLINK_PRIORITY_AI,                 // AI health summary
+    UPLINK_PRIORITY_TELEMETRY,          // Backlog drained from the measurement queue
+    UPLINK_PRIORITY_COUNT
+};
+
+// The one task that talks to the backend. Background jobs are queued by
+// priority in bounded per-priority queues and run one at a time, so requests
+// never contend for the shared UplinkClient connection and a backlog upload
+// can't delay a login. Results reach the UI the usual BackgroundJob way:
+// loop() picks them up with takeCompletion().
+class UplinkWorker {
+private:
+    QueueHandle_t queues[UPLINK_PRIORITY_COUNT];
+    TaskHandle_t task;
+    BackgroundJob* volatile current;
+    uint32_t rejected;                  // submit() calls refused because the queue was full
+
+    static void taskEntry(void* param);
+    BackgroundJob* next();
+
+public:
+    UplinkWorker();
+
+    bool begin();
+
+    // Queues job; returns its id, or 0 if it is already queued or running or
+    // its priority's queue is full
+    uint32_t submit(BackgroundJob& job, UplinkPriority priority, BackgroundJob::Work work, void* context);
+
+    uint32_t getQueued() const;
+    uint32_t getRejected() const { return rejected; }
+    const char* getCurrentJob() const;  // nullptr while idle
+};
+
+#endif // UPLINK_WORKER_H
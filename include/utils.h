@@ -2,14 +2,17 @@
 #define UTILS_H
 
 #include <Arduino.h>
-#include "pitches.h"
+#include "melody.h"
 
-// Declaration for the melody arrays
-extern const int win_melody[];
-extern const int win_melody_len;
-extern const int lose_melody[];
-extern const int lose_melody_len;
+// Declaration for the melodies
+extern const Melody win_melody;
+extern const Melody lose_melody;
 
-void playMelody(int buzzer_pin, const int melody[], int melody_length, int tempo_divisor = 25);
+#define DEVICE_UID_SIZE 24  // DEVICE_ID, '-', 12 hex digits of the MAC and NUL
+
+// "<DEVICE_ID>-<eFuse MAC>". DEVICE_ID and DEVICE_SECRET are the credentials
+// every unit shares with the backend; this one differs per unit, so it keys
+// record ids, idempotency keys and MQTT topics.
+const char* getDeviceUid();
 
 #endif // UTILS_H
\ No newline at end of file
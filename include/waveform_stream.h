@@ -0,0 +1,73 @@
+#ifndef WAVEFORM_STREAM_H
+#define WAVEFORM_STREAM_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#define WAVEFORM_PORT 81                // WebSocket server port (ws://<device>:81/waveform)
+#define WAVEFORM_MAX_CLIENTS 3          // Concurrent waveform viewers
+#define WAVEFORM_CLIENT_BUFFER 1024     // Pending bytes per client before frames are dropped
+#define WAVEFORM_HANDSHAKE_BUFFER 384   // Longest accepted upgrade request
+#define WAVEFORM_HANDSHAKE_TIMEOUT_MS 2000
+#define WAVEFORM_MAX_DECIMATION 8       // Largest ?decimate=N a client may ask for
+#define WAVEFORM_MAX_BATCH 32           // Most samples in one published batch
+#define WAVEFORM_DC_SHIFT 4             // DC tracker time constant (2^4 samples) for the AC channel
+
+// Frame layout (little-endian), one binary WebSocket message per batch:
+//   uint8  version (1)
+//   uint8  sample count N
+//   uint8  decimation applied for this client
+//   uint8  reserved
+//   uint32 sequence number of the first sample (counts samples before decimation)
+//   uint32 micros() timestamp of the first sample
+//   uint32 sample period in microseconds (after decimation)
+//   N x { uint8 red[3], uint8 ir[3], int16 irAC }   18-bit raw counts, DC-removed IR
+#define WAVEFORM_FRAME_VERSION 1
+#define WAVEFORM_HEADER_BYTES 16
+#define WAVEFORM_SAMPLE_BYTES 8
+
+// Streams raw red/IR samples to WebSocket clients in binary frames, one per hop.
+// publish() only copies into per-client buffers; sockets are written from loop()
+// with non-blocking sends, and a client whose buffer is full simply misses frames
+// (visible as a sequence jump).
+class WaveformStream {
+private:
+    struct Viewer {
+        WiFiClient socket;
+        bool active;
+        bool upgraded;          // Handshake done, frames may be sent
+        unsigned long acceptedAt;
+        uint8_t decimation;
+        uint8_t phase;          // Samples skipped since the last one sent
+        char buffer[WAVEFORM_CLIENT_BUFFER];
+        size_t used;
+    };
+
+    WiFiServer server;
+    Viewer clients[WAVEFORM_MAX_CLIENTS];
+    uint32_t sequence;          // Samples published so far
+    int32_t irDC;               // Running DC estimate of the IR channel
+    bool dcInitialized;
+    uint32_t framesSent;
+    uint32_t framesDropped;
+
+    void accept();
+    void handshake(Viewer& client);
+    void readControl(Viewer& client);
+    bool queueFrame(Viewer& client, const uint8_t* payload, size_t length);
+    void flush(Viewer& client);
+    void release(Viewer& client);
+
+public:
+    WaveformStream();
+
+    void begin();
+    void loop();
+    void publish(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count);
+
+    int getClientCount() const;
+    uint32_t getFramesSent() const { return framesSent; }
+    uint32_t getFramesDropped() const { return framesDropped; }
+};
+
+#endif // WAVEFORM_STREAM_H
@@ -0,0 +1,614 @@
+// Generated by tools/embed_web_assets.py from the files in web/ - do not edit.
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// A gzip-compressed file stored in flash
+struct WebAsset {
+    const char* path;        // URL the asset is served at (without version query)
+    const char* contentType;
+    const uint8_t* data;     // gzip stream, send with Content-Encoding: gzip
+    size_t length;
+    bool immutable;          // URL carries a content hash, cache forever
+    const char* etag;        // Quoted hash of the data, for If-None-Match
+};
+
+// ai.css: 956 bytes, 480 gzipped
+static const uint8_t WEB_AI_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x52, 0x5d, 0x6f, 0x9c, 0x30,
+    0x10, 0xfc, 0x2b, 0x96, 0xa2, 0x48, 0xad, 0x14, 0x10, 0x1f, 0x77, 0xa4, 0x67, 0xbf, 0xe4, 0xa9,
+    0xff, 0x63, 0xc1, 0x0b, 0x58, 0x67, 0x6c, 0x64, 0x9b, 0x1c, 0x14, 0xf1, 0xdf, 0x6b, 0x03, 0x97,
+    0x90, 0x53, 0xaa, 0xca, 0x2f, 0x2b, 0xcd, 0xee, 0x78, 0x77, 0x66, 0x4a, 0xcd, 0xa7, 0xb9, 0x07,
+    0xce, 0x85, 0x6a, 0x68, 0x9a, 0xf4, 0xe3, 0x12, 0x57, 0x5a, 0x39, 0x10, 0x0a, 0xcd, 0xdc, 0xc1,
+    0x18, 0xdd, 0x04, 0x77, 0x2d, 0x3d, 0x27, 0x01, 0x6a, 0xd3, 0xb9, 0xf6, 0x60, 0x64, 0xc5, 0x1f,
+    0xa4, 0x59, 0x16, 0x9a, 0x3b, 0xb4, 0x16, 0x1a, 0xfc, 0xa4, 0x38, 0xf7, 0x23, 0x2b, 0xa1, 0xba,
+    0x36, 0x46, 0x0f, 0x8a, 0xd3, 0xa7, 0xba, 0xae, 0x39, 0xbe, 0xb2, 0x52, 0x1b, 0x8e, 0x86, 0xa6,
+    0xfd, 0x48, 0xac, 0x96, 0x82, 0x93, 0x00, 0x9c, 0x2f, 0x7c, 0x07, 0x22, 0x03, 0x5c, 0x0c, 0x96,
+    0x9e, 0xfc, 0x74, 0x07, 0xa6, 0x11, 0x6a, 0x65, 0x22, 0xc9, 0x12, 0x4b, 0x0d, 0xbe, 0x61, 0xde,
+    0xf6, 0x28, 0xfc, 0x1a, 0xac, 0x45, 0xd1, 0xb4, 0x6e, 0xab, 0xbf, 0x8e, 0x9f, 0x93, 0xe7, 0xfb,
+    0x4f, 0xe7, 0xc3, 0x4f, 0x79, 0x78, 0xf7, 0x56, 0xa7, 0xfb, 0x23, 0x98, 0x9f, 0x2e, 0xbf, 0x78,
+    0xc9, 0x40, 0x89, 0x0e, 0x9c, 0xd0, 0x8a, 0xda, 0x5e, 0x28, 0x92, 0xc6, 0x99, 0x25, 0xd2, 0x8b,
+    0x00, 0x86, 0x08, 0x55, 0x0b, 0x25, 0x1c, 0xde, 0x17, 0xcb, 0xfc, 0xbf, 0x04, 0x06, 0xa7, 0x97,
+    0xb7, 0x2b, 0x4e, 0xb5, 0x01, 0xaf, 0x01, 0x09, 0x53, 0x73, 0xf2, 0x3c, 0x3b, 0x03, 0xca, 0xd6,
+    0xda, 0x74, 0xd4, 0x68, 0x07, 0x0e, 0x7f, 0x24, 0x1c, 0x9b, 0x9f, 0x4b, 0x9a, 0x7c, 0x87, 0xe5,
+    0xc5, 0x86, 0x2e, 0xb1, 0x1d, 0x3a, 0xcf, 0x3e, 0xcd, 0x0e, 0x47, 0x17, 0x81, 0x14, 0x8d, 0xa2,
+    0x12, 0x6b, 0xc7, 0x6e, 0xad, 0xff, 0x38, 0xb2, 0x3d, 0x54, 0x48, 0x7b, 0x83, 0x51, 0x58, 0x89,
+    0xfd, 0x5b, 0xeb, 0x4b, 0x78, 0xff, 0x93, 0x94, 0x7d, 0x7a, 0xb8, 0x32, 0x04, 0xce, 0x68, 0xd7,
+    0x34, 0x8d, 0x8b, 0xa5, 0x1c, 0x9c, 0xd3, 0xea, 0x4b, 0x28, 0xc8, 0xda, 0xb8, 0xb3, 0x84, 0x72,
+    0xa5, 0xb8, 0x6d, 0x33, 0xa5, 0x96, 0x9c, 0x75, 0x42, 0xed, 0x51, 0x49, 0x83, 0x3e, 0x6c, 0xab,
+    0x57, 0x95, 0xe2, 0xd2, 0xa9, 0xa8, 0x94, 0x03, 0xbe, 0x7c, 0x54, 0xb4, 0xd5, 0xef, 0xde, 0xd3,
+    0xe3, 0xee, 0x59, 0x7a, 0x29, 0x7e, 0xe7, 0x5b, 0xb3, 0x41, 0xfe, 0x72, 0x2f, 0xbe, 0x69, 0xad,
+    0x4f, 0xa7, 0x3c, 0x2f, 0x96, 0x18, 0xaa, 0x60, 0x98, 0x9d, 0xb7, 0xbd, 0x56, 0x63, 0xb3, 0x35,
+    0xc1, 0x3b, 0x40, 0x82, 0xd6, 0x33, 0x17, 0xb6, 0x97, 0x30, 0x51, 0xa1, 0xd6, 0x43, 0x4b, 0xa9,
+    0xab, 0xeb, 0x12, 0x2b, 0xed, 0xf0, 0x10, 0xe6, 0xd4, 0x87, 0x99, 0x55, 0x5a, 0x6a, 0x43, 0x9f,
+    0x8a, 0xa2, 0x60, 0x0f, 0x94, 0xbb, 0x64, 0x6e, 0x92, 0x48, 0x85, 0xf3, 0xfe, 0x54, 0xc7, 0x34,
+    0x1d, 0x42, 0x8d, 0xf8, 0x61, 0xcf, 0x06, 0x85, 0x7d, 0x60, 0xde, 0x99, 0xb7, 0x1b, 0xd9, 0x6a,
+    0x32, 0xc7, 0x4a, 0x9b, 0x2d, 0x71, 0x4a, 0x7b, 0x53, 0x1f, 0x15, 0x5d, 0x60, 0xbf, 0xfc, 0xb1,
+    0xdb, 0x4b, 0x80, 0x26, 0x9c, 0xb2, 0xfc, 0x05, 0xa5, 0x6c, 0x83, 0x02, 0xbc, 0x03, 0x00, 0x00
+};
+static const WebAsset WEB_AI_CSS = {"/ai.css", "text/css", WEB_AI_CSS_GZ, sizeof(WEB_AI_CSS_GZ), true, "\"d4153ac56de5f3db\""};
+#define WEB_AI_CSS_URL "/ai.css?v=32d8ce0c"
+
+// ai_guest.html: 915 bytes, 515 gzipped
+static const uint8_t WEB_AI_GUEST_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x53, 0x4b, 0x6f, 0xdb, 0x30,
+    0x0c, 0xfe, 0x2b, 0xdc, 0x49, 0x97, 0xc6, 0x6e, 0xd7, 0x1d, 0xda, 0xc2, 0xf6, 0x90, 0x3d, 0x8a,
+    0xed, 0x30, 0xac, 0x58, 0xd3, 0xc3, 0x4e, 0x05, 0x2d, 0x33, 0xb1, 0x10, 0x59, 0x32, 0x44, 0xda,
+    0x41, 0xf6, 0xeb, 0x47, 0xc7, 0x46, 0x91, 0xa2, 0x87, 0x61, 0x80, 0x21, 0x40, 0xd4, 0xf7, 0xe0,
+    0xcb, 0xc5, 0xbb, 0x2f, 0x3f, 0x3f, 0x6f, 0x7e, 0x3f, 0x7c, 0x85, 0x56, 0x3a, 0x5f, 0x15, 0xcb,
+    0x49, 0xd8, 0x54, 0x45, 0x47, 0x82, 0x10, 0xb0, 0xa3, 0xd2, 0x8c, 0x8e, 0x0e, 0x7d, 0x4c, 0x62,
+    0xc0, 0xc6, 0x20, 0x14, 0xa4, 0x34, 0x07, 0xd7, 0x48, 0x5b, 0x36, 0x34, 0x3a, 0x4b, 0xab, 0xd3,
+    0xe5, 0x02, 0x5c, 0x70, 0xe2, 0xd0, 0xaf, 0xd8, 0xa2, 0xa7, 0xf2, 0x2a, 0xbb, 0x34, 0x8b, 0x8a,
+    0x6d, 0x31, 0x31, 0x29, 0xeb, 0x69, 0x73, 0xbf, 0xba, 0xd1, 0xa8, 0x38, 0xf1, 0x54, 0xad, 0xbf,
+    0xc3, 0x3a, 0xa0, 0x3f, 0xb2, 0xe3, 0x22, 0x9f, 0x43, 0x85, 0x77, 0x61, 0x0f, 0x89, 0x7c, 0x69,
+    0x58, 0x8e, 0x9e, 0xb8, 0x25, 0x52, 0xdb, 0x36, 0xd1, 0xb6, 0x34, 0xf9, 0x29, 0x94, 0x59, 0xe6,
+    0x8f, 0x63, 0xf9, 0xe1, 0x76, 0x7b, 0x7b, 0x4b, 0xb4, 0x35, 0xff, 0xe0, 0xa0, 0x5b, 0x08, 0xd7,
+    0xef, 0x9b, 0x1b, 0x4b, 0x97, 0x56, 0x09, 0xf9, 0x5c, 0x61, 0x1d, 0x9b, 0x63, 0x55, 0x34, 0x6e,
+    0x04, 0xeb, 0x91, 0xb9, 0x34, 0x53, 0x75, 0xe8, 0x02, 0x25, 0xc5, 0xb4, 0x57, 0xaf, 0xf3, 0xd3,
+    0xfb, 0x39, 0xb4, 0x23, 0x66, 0xdc, 0xd1, 0x04, 0xbc, 0xae, 0xee, 0x09, 0x65, 0x48, 0x04, 0xeb,
+    0x11, 0x9d, 0xc7, 0xda, 0x13, 0x1c, 0x9c, 0xb4, 0xf0, 0x8b, 0x76, 0x8e, 0x25, 0xa1, 0xb8, 0x18,
+    0x54, 0xe0, 0xba, 0x2a, 0xfa, 0x49, 0x53, 0xcd, 0xbd, 0xbe, 0xe2, 0x22, 0x0d, 0xfa, 0xc5, 0xe0,
+    0x8f, 0x80, 0x2f, 0xec, 0x6d, 0x4c, 0x5a, 0xcf, 0x44, 0xa6, 0x44, 0x0d, 0x0c, 0x4c, 0x89, 0x33,
+    0xd8, 0xb4, 0x8a, 0xdc, 0x2e, 0x56, 0x7d, 0x8a, 0xa3, 0x6b, 0x88, 0xa1, 0xd7, 0xb7, 0xa8, 0x52,
+    0xee, 0x8f, 0x22, 0x17, 0x69, 0x17, 0xd8, 0xed, 0x5a, 0x61, 0xa8, 0x91, 0x35, 0x1a, 0x03, 0x1c,
+    0xe3, 0x90, 0xa0, 0x23, 0x64, 0xe5, 0x76, 0x3a, 0x40, 0xce, 0x8a, 0xbc, 0x9f, 0xf2, 0xd9, 0xc4,
+    0x49, 0x1e, 0xe4, 0x4c, 0xfb, 0x02, 0x7a, 0xaf, 0x48, 0x7a, 0x49, 0x41, 0x53, 0x05, 0xb4, 0x36,
+    0x0e, 0x41, 0x00, 0xe5, 0x0e, 0x8a, 0x3a, 0x55, 0x05, 0x2e, 0x0d, 0x6e, 0x45, 0x7a, 0xbe, 0xcb,
+    0x73, 0x17, 0x25, 0x0b, 0x74, 0x08, 0xd1, 0x67, 0x2e, 0x66, 0x63, 0x30, 0x20, 0x98, 0x76, 0xd3,
+    0xd0, 0x9f, 0x6b, 0x8f, 0x61, 0x6f, 0xaa, 0x6f, 0xa7, 0xe4, 0x1e, 0x29, 0xa8, 0xf4, 0x83, 0x6e,
+    0x13, 0xfa, 0x22, 0xc7, 0xea, 0x94, 0x47, 0xae, 0x9d, 0x7d, 0xd5, 0x5e, 0xb4, 0x53, 0xd3, 0x58,
+    0xdb, 0xab, 0xbd, 0xe8, 0x60, 0xbe, 0xea, 0x34, 0xcf, 0x4a, 0x78, 0x76, 0x61, 0x1b, 0x8d, 0x16,
+    0x25, 0x6d, 0x6c, 0x4a, 0xa3, 0x56, 0x8a, 0xae, 0x07, 0x11, 0x2d, 0x57, 0x8e, 0xbd, 0xae, 0x2d,
+    0x0f, 0x75, 0xe7, 0xa6, 0xa5, 0x9d, 0x35, 0x6b, 0x09, 0xab, 0xda, 0x0f, 0x3a, 0xb3, 0x4f, 0x68,
+    0xf7, 0x20, 0x51, 0x07, 0xc4, 0x83, 0x17, 0x1d, 0xee, 0x4c, 0xd3, 0x3c, 0x26, 0xb7, 0x37, 0x9e,
+    0xb1, 0xa1, 0xff, 0xf5, 0xd1, 0xb1, 0x99, 0xea, 0x87, 0x12, 0xe1, 0x91, 0x3c, 0x59, 0x79, 0x63,
+    0x31, 0x57, 0xbc, 0x9c, 0xf3, 0x22, 0xe6, 0xa7, 0xbf, 0xef, 0x2f, 0xbf, 0xf7, 0x77, 0x4e, 0x93,
+    0x03, 0x00, 0x00
+};
+static const WebAsset WEB_AI_GUEST_HTML = {"/ai_guest.html", "text/html", WEB_AI_GUEST_HTML_GZ, sizeof(WEB_AI_GUEST_HTML_GZ), false, "\"8a6d99afd9843fb4\""};
+
+// ai_result.tpl.html: 854 bytes, rendered by TemplateStream
+static const char WEB_AI_RESULT_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>AI Health Analysis</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/ai.css?v=32d8ce0c'>\n"
+    "</head><body><div class='container'>\n"
+    "<h1>AI Health Analysis</h1>\n"
+    "<div class='summary'>{{SUMMARY}}</div>\n"
+    "<div class='actions'>\n"
+    "<form action='/measurement_info' method='get'>\n"
+    "<button type='submit' class='btn-blue'>Back to Results</button></form>\n"
+    "<form action='/continue_measuring' method='get'>\n"
+    "<button type='submit'>New Measurement</button></form>\n"
+    "<form action='/mode' method='get'>\n"
+    "<button type='submit' class='btn-red'>Mode Select</button></form>\n"
+    "</div>\n"
+    "<p class='note'>This analysis is for informational purposes only and does not replace professional medical advice.</p>\n"
+    "</div></body></html>\n";
+
+// ai_waiting.tpl.html: 585 bytes, rendered by TemplateStream
+static const char WEB_AI_WAITING_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<meta http-equiv='refresh' content='1;url={{#JOB}}/ai_analysis_result?job={{JOB}}{{/JOB}}{{^JOB}}/ai_analysis{{/JOB}}'>\n"
+    "<title>Loading Analysis</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/ai.css?v=32d8ce0c'>\n"
+    "</head><body><div class='container'>\n"
+    "<h1>Preparing AI Analysis</h1>\n"
+    "<div class='loader'></div>\n"
+    "<p>Analyzing your health data...</p>\n"
+    "<p>Please wait while we process your measurements.</p>\n"
+    "</div></body></html>\n";
+
+// connect.css: 333 bytes, 233 gzipped
+static const uint8_t WEB_CONNECT_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x90, 0xcb, 0x6a, 0xc3, 0x30,
+    0x10, 0x45, 0x7f, 0x45, 0x50, 0x02, 0x2d, 0x34, 0x41, 0xae, 0xe3, 0xd0, 0xca, 0x9b, 0xfc, 0x8a,
+    0x1c, 0x8d, 0xed, 0xa1, 0xf6, 0x8c, 0x19, 0x8d, 0x49, 0x13, 0xe1, 0x7f, 0xaf, 0x1f, 0x7d, 0x2d,
+    0x8a, 0x36, 0xc3, 0xb9, 0x67, 0xa1, 0x7b, 0x2b, 0x0e, 0xb7, 0x34, 0xf8, 0x10, 0x90, 0x1a, 0xf7,
+    0x62, 0x87, 0x8f, 0xe9, 0x10, 0x07, 0x24, 0x02, 0x49, 0x57, 0x0c, 0xda, 0xba, 0xe3, 0xcc, 0xca,
+    0x16, 0xb0, 0x69, 0x75, 0xbb, 0x7b, 0x2f, 0x0d, 0xd2, 0xea, 0x1a, 0x3f, 0x2a, 0x97, 0x15, 0x4b,
+    0x00, 0xd9, 0x8b, 0x0f, 0x38, 0x46, 0x57, 0xd8, 0xdd, 0x17, 0x71, 0xc5, 0x6c, 0x44, 0xee, 0x30,
+    0x98, 0x87, 0x3a, 0x5f, 0xde, 0xb7, 0xaa, 0x3c, 0xfc, 0x0d, 0xf3, 0xe3, 0xdb, 0x6b, 0xa8, 0x4a,
+    0x4f, 0xd8, 0x7b, 0x45, 0x26, 0xb7, 0xfc, 0xc0, 0x64, 0xd1, 0x74, 0x48, 0xe0, 0xc5, 0x20, 0xd5,
+    0x48, 0xa8, 0x30, 0x9d, 0xdf, 0xe1, 0x56, 0x8b, 0xef, 0x21, 0x9a, 0x45, 0x49, 0x76, 0x97, 0x54,
+    0x3c, 0xc5, 0x9a, 0xa5, 0x77, 0xc2, 0xea, 0x15, 0x1e, 0x6d, 0x80, 0xe6, 0x69, 0xca, 0xec, 0x7f,
+    0x59, 0x7e, 0xda, 0xd2, 0xb9, 0xe3, 0x78, 0xb9, 0x40, 0x8c, 0xcf, 0x07, 0x10, 0x61, 0x49, 0x35,
+    0x93, 0xee, 0xaf, 0x5b, 0xc9, 0x8a, 0xbb, 0x50, 0xae, 0x20, 0xe2, 0x1d, 0x5c, 0x76, 0x9a, 0x37,
+    0xa9, 0x46, 0x55, 0xa6, 0x9f, 0x9d, 0xb2, 0xa5, 0x7b, 0x56, 0xfc, 0x8e, 0xb1, 0x02, 0x3b, 0x7d,
+    0x02, 0xbb, 0x1c, 0x5a, 0x0e, 0x4d, 0x01, 0x00, 0x00
+};
+static const WebAsset WEB_CONNECT_CSS = {"/connect.css", "text/css", WEB_CONNECT_CSS_GZ, sizeof(WEB_CONNECT_CSS_GZ), true, "\"9b17819ca5b789c1\""};
+#define WEB_CONNECT_CSS_URL "/connect.css?v=736ea0cd"
+
+// connect_result.tpl.html: 762 bytes, rendered by TemplateStream
+static const char WEB_CONNECT_RESULT_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>Connection Result</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/connect.css?v=736ea0cd'>\n"
+    "</head>\n"
+    "<body><div class='container'>\n"
+    "<h1>Connection Result</h1>\n"
+    "{{#SUCCESS}}<p class='success'>✅ WiFi connection successful!</p>\n"
+    "<p>Connected to: <strong>{{SSID}}</strong></p>\n"
+    "<p>IP: {{IP}}</p>\n"
+    "<p>Signal: {{SIGNAL}} (-{{RSSI}} dBm)</p>\n"
+    "<form action='/mode'><button type='submit'>Continue</button></form>{{/SUCCESS}}\n"
+    "{{^SUCCESS}}<p class='error'>❌ WiFi connection failed!</p>\n"
+    "<p>{{ERROR}}</p>\n"
+    "<form action='/wifi'><button type='submit'>Try Again</button></form>{{/SUCCESS}}\n"
+    "</div></body></html>\n";
+
+// connecting.tpl.html: 557 bytes, rendered by TemplateStream
+static const char WEB_CONNECTING_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>Connecting to WiFi...</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/connect.css?v=736ea0cd'>\n"
+    "<meta http-equiv='refresh' content='2;url=/connect_status?job={{JOB}}'>\n"
+    "</head>\n"
+    "<body><div class='container'>\n"
+    "<h1>Connecting to WiFi</h1>\n"
+    "<p>Connecting to network: <strong>{{SSID}}</strong></p>\n"
+    "<div class='spinner'></div>\n"
+    "<p>Please wait a moment... ({{ELAPSED}} s)</p>\n"
+    "</div></body></html>\n";
+
+// force_ap.html: 496 bytes, 338 gzipped
+static const uint8_t WEB_FORCE_AP_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x4d, 0x51, 0x4b, 0x4b, 0x03, 0x31,
+    0x10, 0xfe, 0x2b, 0xe3, 0x29, 0x17, 0xbb, 0x6b, 0xa9, 0x07, 0x8b, 0x9b, 0x48, 0xb1, 0x16, 0x2f,
+    0x62, 0x41, 0x45, 0x7a, 0x4c, 0x93, 0x29, 0x19, 0xcc, 0x26, 0x35, 0x93, 0x6e, 0xe9, 0xbf, 0x37,
+    0xfb, 0x28, 0x78, 0x19, 0xc8, 0xcc, 0xf7, 0x98, 0x6f, 0xd2, 0xdc, 0xac, 0xdf, 0x9f, 0x3f, 0x77,
+    0xdb, 0x17, 0x70, 0xb9, 0xf5, 0xaa, 0x99, 0x2a, 0x6a, 0xab, 0x9a, 0x16, 0xb3, 0x86, 0xa0, 0x5b,
+    0x94, 0xa2, 0x23, 0x3c, 0x1f, 0x63, 0xca, 0x02, 0x4c, 0x0c, 0x19, 0x43, 0x96, 0xe2, 0x4c, 0x36,
+    0x3b, 0x69, 0xb1, 0x23, 0x83, 0xb3, 0xe1, 0x71, 0x0b, 0x14, 0x28, 0x93, 0xf6, 0x33, 0x36, 0xda,
+    0xa3, 0x9c, 0x57, 0x77, 0x62, 0x52, 0x31, 0x4e, 0x27, 0xc6, 0xc2, 0xfa, 0xfa, 0xdc, 0xcc, 0x1e,
+    0xae, 0x5d, 0x97, 0xf3, 0x71, 0x86, 0xbf, 0x27, 0xea, 0xa4, 0x48, 0x78, 0x48, 0xc8, 0xee, 0x9f,
+    0xc1, 0xe2, 0xf1, 0x94, 0xbc, 0xac, 0x0b, 0x38, 0x53, 0xf6, 0xa8, 0x5e, 0x51, 0xfb, 0xec, 0x3e,
+    0x30, 0x30, 0xc2, 0x26, 0x26, 0x83, 0xb0, 0xda, 0xc2, 0x5b, 0xb4, 0xd8, 0xd4, 0x23, 0xa0, 0xf1,
+    0x14, 0x7e, 0x20, 0xa1, 0x97, 0x82, 0xf3, 0xc5, 0x17, 0x35, 0xc4, 0xb2, 0xb1, 0x2b, 0xd2, 0x52,
+    0xd4, 0x43, 0xab, 0x32, 0xcc, 0x4f, 0x9d, 0xbc, 0x5f, 0x1e, 0x96, 0x4b, 0xc4, 0x43, 0xd1, 0xae,
+    0xc7, 0xac, 0xfb, 0x68, 0x2f, 0xaa, 0xb1, 0xd4, 0x81, 0xf1, 0x9a, 0x59, 0x8a, 0x7e, 0x0d, 0x4d,
+    0x01, 0x53, 0xc1, 0xb8, 0xb9, 0x9a, 0xac, 0x46, 0x63, 0x5b, 0x58, 0x73, 0xd5, 0x1c, 0xaf, 0x58,
+    0x3e, 0x19, 0x83, 0xcc, 0x42, 0xad, 0x87, 0x6b, 0x00, 0x31, 0x84, 0x78, 0x2e, 0xd7, 0x80, 0xd5,
+    0x30, 0x80, 0x6d, 0xa4, 0x90, 0xa1, 0xed, 0x05, 0x62, 0xf0, 0x97, 0xaa, 0xa9, 0x8f, 0x85, 0xae,
+    0xbe, 0x69, 0x43, 0x7d, 0xde, 0x80, 0x26, 0x53, 0x0c, 0xe0, 0x34, 0xc3, 0x1e, 0x31, 0x80, 0x25,
+    0x9e, 0xda, 0x68, 0xaf, 0xe0, 0x5d, 0x3c, 0xc1, 0x99, 0xbc, 0x2f, 0x88, 0x92, 0xd1, 0x52, 0x1a,
+    0xa6, 0x90, 0x23, 0xb8, 0xd8, 0x62, 0x6f, 0xb6, 0x00, 0xc6, 0x42, 0xb3, 0x5c, 0x55, 0x23, 0xa9,
+    0x2e, 0x79, 0x4a, 0x1d, 0xb3, 0xd5, 0xc3, 0xd7, 0xfe, 0x01, 0x85, 0x4d, 0x01, 0xff, 0xf0, 0x01,
+    0x00, 0x00
+};
+static const WebAsset WEB_FORCE_AP_HTML = {"/force_ap.html", "text/html", WEB_FORCE_AP_HTML_GZ, sizeof(WEB_FORCE_AP_HTML_GZ), false, "\"ba216d0060297806\""};
+
+// login.html: 659 bytes, 372 gzipped
+static const uint8_t WEB_LOGIN_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x52, 0x4d, 0x4f, 0xc3, 0x30,
+    0x0c, 0xfd, 0x2b, 0xe1, 0x94, 0x0b, 0x5b, 0x99, 0xc4, 0x81, 0xa1, 0xa4, 0x48, 0x7c, 0x89, 0x03,
+    0x12, 0x48, 0x8c, 0x03, 0x27, 0x94, 0x36, 0xde, 0x6a, 0x91, 0x26, 0x25, 0x71, 0x3b, 0xed, 0xdf,
+    0xe3, 0x7e, 0x6c, 0x83, 0x49, 0x5c, 0x12, 0xbf, 0xd8, 0x7e, 0xcf, 0x79, 0x89, 0x3a, 0xbb, 0x7f,
+    0xb9, 0x5b, 0x7d, 0xbc, 0x3e, 0x88, 0x8a, 0x6a, 0x97, 0xab, 0x69, 0x05, 0x63, 0x73, 0x55, 0x03,
+    0x19, 0xe1, 0x4d, 0x0d, 0x5a, 0x76, 0x08, 0xdb, 0x26, 0x44, 0x92, 0xa2, 0x0c, 0x9e, 0xc0, 0x93,
+    0x96, 0x5b, 0xb4, 0x54, 0x69, 0x0b, 0x1d, 0x96, 0x30, 0x1b, 0xc0, 0xb9, 0x40, 0x8f, 0x84, 0xc6,
+    0xcd, 0x52, 0x69, 0x1c, 0xe8, 0xc5, 0xfc, 0x42, 0x4e, 0x2c, 0x65, 0x65, 0x62, 0x02, 0xee, 0x7a,
+    0x5f, 0x3d, 0xce, 0xae, 0xf8, 0x94, 0x90, 0x1c, 0xe4, 0x4f, 0x60, 0x1c, 0x55, 0x6f, 0xe0, 0x13,
+    0x88, 0xe7, 0xb0, 0x41, 0xaf, 0xb2, 0x31, 0xa1, 0x1c, 0xfa, 0x2f, 0x11, 0xc1, 0x69, 0x99, 0x68,
+    0xe7, 0x20, 0x55, 0x00, 0x2c, 0x5e, 0x45, 0x58, 0x6b, 0x99, 0x0d, 0x47, 0xf3, 0x32, 0xa5, 0x9b,
+    0x4e, 0x5f, 0x2e, 0xd7, 0xcb, 0x25, 0xc0, 0x9a, 0x39, 0xb3, 0x71, 0xec, 0x22, 0xd8, 0x5d, 0xae,
+    0x2c, 0x76, 0xa2, 0x74, 0x26, 0x25, 0x2d, 0xfb, 0x91, 0x0d, 0x7a, 0x88, 0x5c, 0x53, 0x2d, 0xf2,
+    0xf7, 0x04, 0x71, 0xaf, 0xc6, 0x50, 0xad, 0x43, 0xac, 0x85, 0x29, 0x09, 0x83, 0x67, 0x6e, 0xd7,
+    0x27, 0x3e, 0x53, 0x5b, 0xd4, 0xc8, 0x82, 0x3c, 0x7c, 0x15, 0xac, 0x96, 0x4d, 0x48, 0xc4, 0xdd,
+    0xce, 0x14, 0xe0, 0x04, 0x37, 0x68, 0x09, 0xb5, 0x41, 0x27, 0xf3, 0x87, 0x7e, 0xbb, 0x56, 0xd9,
+    0x90, 0x61, 0xed, 0x98, 0x2b, 0xf4, 0x4d, 0x4b, 0x82, 0x76, 0x0d, 0xec, 0xab, 0x04, 0xda, 0x43,
+    0x38, 0xfa, 0x39, 0x81, 0x08, 0xdf, 0x2d, 0x46, 0xb0, 0x63, 0xe3, 0x2f, 0xf6, 0x86, 0x07, 0xdf,
+    0x86, 0x68, 0x65, 0xfe, 0x3a, 0x45, 0xff, 0x6b, 0x1c, 0x6a, 0x07, 0x99, 0x23, 0x1a, 0x95, 0x8e,
+    0xf8, 0xaf, 0xd8, 0x6f, 0x86, 0xfd, 0x6d, 0x3b, 0xe3, 0x5a, 0x86, 0x83, 0x37, 0xbd, 0x9f, 0xbd,
+    0x33, 0xa7, 0xfe, 0xd4, 0xc1, 0xc2, 0xd1, 0x97, 0x0d, 0xf4, 0xb6, 0x14, 0x2d, 0x51, 0xf0, 0x27,
+    0x64, 0x93, 0xf9, 0x85, 0x29, 0xbf, 0x66, 0x05, 0x31, 0xdf, 0x2d, 0x47, 0x2a, 0x1b, 0x6b, 0x0f,
+    0xe4, 0x19, 0xbf, 0x13, 0xaf, 0xe3, 0x9b, 0x65, 0xc3, 0xef, 0xfb, 0x01, 0x1c, 0x75, 0x7b, 0x41,
+    0x93, 0x02, 0x00, 0x00
+};
+static const WebAsset WEB_LOGIN_HTML = {"/login.html", "text/html", WEB_LOGIN_HTML_GZ, sizeof(WEB_LOGIN_HTML_GZ), false, "\"78d107c5cd2bba3f\""};
+
+// login_status.tpl.html: 843 bytes, rendered by TemplateStream
+static const char WEB_LOGIN_STATUS_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>HealthSense Login</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "{{#SUCCESS}}<meta http-equiv='refresh' content='2;url=/measurement'>{{/SUCCESS}}\n"
+    "</head>\n"
+    "<body>\n"
+    "<div class='container'>\n"
+    "<h1>Login Status</h1>\n"
+    "{{#SUCCESS}}<p class='success'>Login successful!</p>\n"
+    "<p>Welcome back, {{EMAIL}}!</p>\n"
+    "<p>You will be redirected to measurement in 2 seconds...</p>{{/SUCCESS}}\n"
+    "{{^SUCCESS}}<p class='error'>Login failed!</p>\n"
+    "<p>Invalid email or password. Please try again.</p>\n"
+    "<form action='/login' method='get'>\n"
+    "<button type='submit' class='back-btn'>Back to Login</button>\n"
+    "</form>\n"
+    "<form action='/mode' method='get'>\n"
+    "<button type='submit'>Back to Mode Selection</button>\n"
+    "</form>{{/SUCCESS}}\n"
+    "</div></body></html>\n";
+
+// login_waiting.tpl.html: 468 bytes, rendered by TemplateStream
+static const char WEB_LOGIN_WAITING_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>Logging in...</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/connect.css?v=736ea0cd'>\n"
+    "<meta http-equiv='refresh' content='1;url=/login_status?job={{JOB}}'>\n"
+    "</head>\n"
+    "<body><div class='container'>\n"
+    "<h1>Logging in</h1>\n"
+    "<div class='spinner'></div>\n"
+    "<p>Checking your account...</p>\n"
+    "</div></body></html>\n";
+
+// measurement_info.css: 669 bytes, 331 gzipped
+static const uint8_t WEB_MEASUREMENT_INFO_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x52, 0xdb, 0x6e, 0xc3, 0x20,
+    0x0c, 0xfd, 0x95, 0x48, 0xd5, 0xde, 0x9a, 0x08, 0x52, 0x5a, 0x75, 0xe4, 0xbd, 0xff, 0x01, 0xc1,
+    0x4d, 0xd0, 0x12, 0x1c, 0x11, 0xb2, 0x66, 0x8b, 0xf8, 0xf7, 0x81, 0x72, 0xe9, 0x45, 0x9d, 0x78,
+    0x39, 0x60, 0xfb, 0x1c, 0xfb, 0x18, 0x89, 0xea, 0x67, 0xea, 0x84, 0x52, 0xda, 0x54, 0x9c, 0x92,
+    0x6e, 0xf4, 0x59, 0x89, 0xc6, 0x09, 0x6d, 0xc0, 0x4e, 0xad, 0x18, 0xd3, 0x9b, 0x56, 0xae, 0xe6,
+    0xec, 0x18, 0x43, 0x35, 0x9d, 0xae, 0x21, 0x98, 0xf6, 0xfa, 0x17, 0x78, 0x9e, 0xc7, 0x97, 0x7c,
+    0x2a, 0xb1, 0x41, 0xcb, 0x77, 0x8c, 0xb1, 0xe2, 0x1e, 0xa4, 0xe7, 0x6e, 0x2c, 0x5a, 0x61, 0x2b,
+    0x6d, 0x38, 0x3d, 0x76, 0x63, 0x42, 0x92, 0x48, 0x5e, 0x2c, 0x4a, 0xa9, 0x44, 0xe7, 0xb0, 0xe5,
+    0x21, 0x52, 0x48, 0xb4, 0x0a, 0xec, 0xfa, 0x42, 0x43, 0x6e, 0x8f, 0x8d, 0x56, 0xc9, 0x0e, 0x00,
+    0x7c, 0x66, 0x41, 0xc4, 0x82, 0x47, 0x5d, 0xf6, 0x4a, 0x3d, 0xeb, 0xde, 0x40, 0x57, 0xb5, 0xe3,
+    0x12, 0x1b, 0xe5, 0xb3, 0xda, 0xae, 0x7d, 0x5d, 0x19, 0x3b, 0x1c, 0x4e, 0x3e, 0xeb, 0x3b, 0xdc,
+    0x7a, 0xcd, 0xe9, 0xe7, 0xe9, 0x72, 0xf0, 0x99, 0x12, 0x4e, 0xa4, 0x4e, 0xc8, 0x06, 0xa6, 0x79,
+    0x4c, 0x4a, 0xc8, 0xc7, 0xc6, 0x4d, 0xee, 0xdc, 0xf3, 0x4c, 0xec, 0xde, 0x6d, 0x20, 0x6a, 0x44,
+    0xd7, 0x03, 0x5f, 0xc1, 0x23, 0x59, 0xe2, 0xea, 0xfd, 0xd3, 0x55, 0x6d, 0x0e, 0x47, 0x5b, 0x1c,
+    0x8c, 0x2e, 0x15, 0x8d, 0xae, 0x0c, 0x2f, 0xc1, 0x38, 0xb0, 0xff, 0x5b, 0xa0, 0x94, 0x7a, 0x21,
+    0x9e, 0xa4, 0x28, 0xbf, 0x2a, 0x8b, 0x83, 0x51, 0x61, 0x36, 0x12, 0x8f, 0x97, 0x43, 0xa8, 0x33,
+    0x4f, 0x5b, 0x4c, 0xa2, 0x33, 0xeb, 0x24, 0x11, 0xbe, 0x5a, 0x54, 0xb4, 0xda, 0x2c, 0xbb, 0xa5,
+    0x79, 0xdc, 0xcc, 0x8c, 0xc5, 0xe0, 0xd0, 0x67, 0xd2, 0x99, 0x54, 0x36, 0x03, 0xec, 0x37, 0xc4,
+    0x6b, 0xfc, 0x0e, 0x1f, 0xe2, 0x51, 0x7c, 0x35, 0x31, 0xa6, 0xa0, 0x15, 0xa6, 0x5a, 0xd2, 0x67,
+    0xfc, 0xa6, 0xe0, 0x72, 0xf9, 0x3c, 0x13, 0x32, 0x17, 0x58, 0x50, 0xfb, 0x15, 0xbc, 0x49, 0x5d,
+    0x96, 0xf6, 0x07, 0x03, 0x1f, 0xfb, 0x12, 0x9d, 0x02, 0x00, 0x00
+};
+static const WebAsset WEB_MEASUREMENT_INFO_CSS = {"/measurement_info.css", "text/css", WEB_MEASUREMENT_INFO_CSS_GZ, sizeof(WEB_MEASUREMENT_INFO_CSS_GZ), true, "\"03d6af58e3636423\""};
+#define WEB_MEASUREMENT_INFO_CSS_URL "/measurement_info.css?v=c6f77848"
+
+// measurement_info.tpl.html: 1902 bytes, rendered by TemplateStream
+static const char WEB_MEASUREMENT_INFO_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>Measurement Results</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/measurement_info.css?v=c6f77848'>\n"
+    "</head>\n"
+    "<body>\n"
+    "<div class='container'>\n"
+    "<h1>Measurement Results</h1>\n"
+    "{{#LOGGED_IN}}<p class='user'>User Mode - Data Saved to Account</p>{{/LOGGED_IN}}\n"
+    "{{^LOGGED_IN}}<p class='guest'>Guest Mode - Data Not Saved</p>{{/LOGGED_IN}}\n"
+    "<div class='card'>\n"
+    "<h2>Final Results</h2>\n"
+    "<div class='reading hr'>Heart Rate: {{HR}} BPM</div>\n"
+    "<div class='reading spo2'>SpO2: {{SPO2}} %</div>\n"
+    "<p>Based on {{VALID_COUNT}} valid measurements</p>\n"
+    "</div>\n"
+    "<div class='card'>\n"
+    "<h2>Measurement Process</h2>\n"
+    "<p>Valid readings collected during measurement:</p>\n"
+    "<table class='data-table'>\n"
+    "<tr><th>Reading</th><th>Heart Rate</th><th>SpO2</th></tr>\n"
+    "{{READING_ROWS}}\n"
+    "</table></div>\n"
+    "<div class='card' style='text-align:center'>\n"
+    "<h2>Actions</h2>\n"
+    "<form action='/continue_measuring' method='get' style='display:inline-block;margin:5px'><button type='submit' style='font-size:16px;padding:12px 25px'>Re-measure</button></form>\n"
+    "<form action='/measurement' method='get' style='display:inline-block;margin:5px'><button type='submit' class='btn-blue'>Back to Measure Page</button></form>\n"
+    "{{#LOGGED_IN}}<form action='/ai_analysis' method='get' style='display:inline-block;margin:5px'><button type='submit' class='btn-orange'>AI Analysis</button></form>{{/LOGGED_IN}}\n"
+    "<form action='/mode' method='get' style='display:inline-block;margin:5px'><button type='submit' class='btn-red'>Mode Select</button></form>\n"
+    "</div>\n"
+    "{{#GUEST}}<div class='card'>\n"
+    "<h2>Want More Features?</h2>\n"
+    "<p>Register an account to save your measurements and access AI analysis.</p>\n"
+    "<p><a href='https://iot.newnol.io.vn' target='_blank'>Visit HealthSense Portal</a></p>\n"
+    "</div>{{/GUEST}}\n"
+    "</div></body></html>\n";
+
+// measurement_stream.css: 473 bytes, 295 gzipped
+static const uint8_t WEB_MEASUREMENT_STREAM_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x50, 0xc1, 0x6e, 0xc3, 0x20,
+    0x0c, 0xfd, 0x15, 0xa4, 0xaa, 0xd2, 0x76, 0x68, 0x04, 0x21, 0x65, 0x0d, 0xb9, 0xec, 0xb4, 0xff,
+    0x20, 0x83, 0x24, 0xd6, 0x12, 0x1c, 0x01, 0x55, 0xdb, 0x21, 0xfe, 0x7d, 0xa4, 0x4d, 0xd5, 0x1c,
+    0x26, 0x5f, 0x6c, 0x3f, 0xbf, 0x67, 0xfb, 0xb5, 0xa8, 0x6f, 0x71, 0x56, 0x5a, 0x83, 0xed, 0x25,
+    0xa3, 0xf3, 0x35, 0x0d, 0x2c, 0x76, 0x68, 0xc3, 0xc1, 0xc3, 0xaf, 0x91, 0x65, 0x99, 0x3b, 0xc5,
+    0x88, 0x4a, 0x1b, 0x17, 0x2f, 0xa0, 0xc3, 0x20, 0x45, 0x1e, 0x6a, 0x06, 0x03, 0xfd, 0x10, 0x1e,
+    0x79, 0x8b, 0x2e, 0xa3, 0x07, 0xa7, 0x34, 0x9c, 0xbd, 0x3c, 0xd2, 0xfd, 0xda, 0x91, 0xc7, 0xf9,
+    0x4a, 0x3c, 0x8e, 0xa0, 0xc9, 0xae, 0xe3, 0x4b, 0x3c, 0x47, 0x03, 0xce, 0x5b, 0x90, 0x57, 0xf5,
+    0x49, 0xb7, 0x8d, 0xb2, 0x30, 0xa9, 0x00, 0x68, 0xa5, 0x9f, 0xc1, 0x12, 0x56, 0x1c, 0x3d, 0x19,
+    0xc1, 0x1a, 0xe5, 0x08, 0xd8, 0x0e, 0x2c, 0x04, 0xd3, 0x4c, 0xca, 0xf5, 0x60, 0x65, 0x99, 0xf7,
+    0x12, 0x75, 0x0e, 0x98, 0x3e, 0x7f, 0xcc, 0xad, 0x73, 0x6a, 0x32, 0x9e, 0x2c, 0xac, 0x48, 0xf7,
+    0x31, 0x38, 0x65, 0x7d, 0x87, 0x6e, 0x92, 0x0e, 0x83, 0x0a, 0xe6, 0x8d, 0x6a, 0xd3, 0xbf, 0x27,
+    0x46, 0xff, 0xc3, 0xb8, 0x78, 0xa0, 0xa9, 0xf0, 0xb9, 0x3e, 0xfb, 0x97, 0x17, 0xf9, 0xc0, 0xe7,
+    0xba, 0x25, 0x27, 0xb4, 0xb9, 0xdb, 0x72, 0x79, 0x7c, 0xde, 0xe2, 0xa8, 0x9b, 0x6f, 0x1c, 0xd1,
+    0xc9, 0x1d, 0xab, 0x3f, 0x84, 0x2e, 0x9b, 0x97, 0x6b, 0xec, 0xb4, 0xb8, 0xe6, 0x8c, 0x5a, 0x94,
+    0xb6, 0x6e, 0xd2, 0x8d, 0xe6, 0xf2, 0x02, 0x4d, 0xc5, 0xe0, 0xe2, 0x2a, 0xd3, 0x55, 0x15, 0xe7,
+    0x22, 0x1f, 0x32, 0x63, 0xf9, 0xec, 0x95, 0xac, 0x16, 0x5f, 0x3c, 0x15, 0x16, 0x83, 0x89, 0x2b,
+    0x93, 0xdf, 0x99, 0x64, 0x11, 0xd8, 0xee, 0xac, 0x72, 0xb9, 0xb2, 0x84, 0x10, 0xe9, 0x0f, 0x59,
+    0xff, 0x02, 0x0c, 0xd9, 0x01, 0x00, 0x00
+};
+static const WebAsset WEB_MEASUREMENT_STREAM_CSS = {"/measurement_stream.css", "text/css", WEB_MEASUREMENT_STREAM_CSS_GZ, sizeof(WEB_MEASUREMENT_STREAM_CSS_GZ), true, "\"495bdc67ec557975\""};
+#define WEB_MEASUREMENT_STREAM_CSS_URL "/measurement_stream.css?v=0af35f39"
+
+// measurement_stream.tpl.html: 2219 bytes, rendered by TemplateStream
+static const char WEB_MEASUREMENT_STREAM_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta charset='UTF-8'>\n"
+    "<meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<title>Measuring...</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/measurement_stream.css?v=0af35f39'>\n"
+    "</head><body><div class='container'>\n"
+    "<h1>Measurement in Progress</h1>\n"
+    "{{#LOGGED_IN}}<p class='user'>User Mode - Data will be saved to your account</p>{{/LOGGED_IN}}\n"
+    "{{^LOGGED_IN}}<p class='guest'>Guest Mode - Data will not be saved</p>{{/LOGGED_IN}}\n"
+    "<div class='loader'></div>\n"
+    "<div class='status' id='finger'>Please wait while we collect your measurements</div>\n"
+    "<div class='reading hr'>Heart Rate: <span id='hr'>--</span></div>\n"
+    "<div class='reading spo2'>SpO2: <span id='spo2'>--</span></div>\n"
+    "<p id='progress'>0 / {{REQUIRED}} valid readings</p>\n"
+    "<p class='note'>Values are also displayed on the device LCD screen.<br>\n"
+    "This page will automatically update when measurement is complete.</p>\n"
+    "<script>\n"
+    "function show(id, text) { document.getElementById(id).textContent = text; }\n"
+    "function done() { window.location.href = '/measurement_info'; }\n"
+    "function poll() {\n"
+    "  fetch('/check_measurement_status').then(function(r) {\n"
+    "    if (r.redirected) { window.location.href = r.url; return ''; }\n"
+    "    return r.text();\n"
+    "  }).then(function(s) { if (s === 'complete') done(); }).catch(function() {});\n"
+    "}\n"
+    "if (window.EventSource) {\n"
+    "  // Live updates pushed by the device; the browser reconnects on its own\n"
+    "  var es = new EventSource('/events');\n"
+    "  es.addEventListener('finger', function(e) {\n"
+    "    var d = JSON.parse(e.data);\n"
+    "    show('finger', d.detected ? 'Finger detected - keep still' : 'Place your finger on the sensor');\n"
+    "  });\n"
+    "  // Events carry a probe index; this page follows the first probe\n"
+    "  es.addEventListener('reading', function(e) {\n"
+    "    var d = JSON.parse(e.data);\n"
+    "    if (d.probe) return;\n"
+    "    show('hr', d.hr_valid ? d.hr + ' BPM' : '--');\n"
+    "    show('spo2', d.spo2_valid ? d.spo2 + ' %' : '--');\n"
+    "    show('progress', d.progress + ' / ' + d.required + ' valid readings');\n"
+    "  });\n"
+    "  es.addEventListener('complete', function(e) {\n"
+    "    if (JSON.parse(e.data).probe) return;\n"
+    "    es.close(); done();\n"
+    "  });\n"
+    "} else {\n"
+    "  setInterval(poll, 3000);\n"
+    "}\n"
+    "</script>\n"
+    "</div></body></html>\n";
+
+// mode.html: 644 bytes, 347 gzipped
+static const uint8_t WEB_MODE_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x52, 0xc1, 0x4e, 0xc3, 0x30,
+    0x0c, 0xfd, 0x95, 0x70, 0xca, 0x85, 0xae, 0x4c, 0xe2, 0xc0, 0x50, 0x52, 0x0e, 0x83, 0xc1, 0x05,
+    0x81, 0xd8, 0x10, 0xe2, 0x84, 0xb2, 0xd6, 0x6d, 0x2c, 0xd2, 0xa4, 0x4a, 0xdc, 0x4d, 0xfb, 0x7b,
+    0xbc, 0x76, 0x08, 0x04, 0x12, 0x1a, 0x97, 0x28, 0x79, 0xb6, 0xdf, 0x7b, 0xb6, 0xa3, 0x4e, 0xae,
+    0x1f, 0xe6, 0xab, 0xd7, 0xc7, 0x1b, 0x61, 0xa9, 0x75, 0x85, 0x3a, 0x9c, 0x60, 0xaa, 0x42, 0xb5,
+    0x40, 0x46, 0x78, 0xd3, 0x82, 0x96, 0x1b, 0x84, 0x6d, 0x17, 0x22, 0x49, 0x51, 0x06, 0x4f, 0xe0,
+    0x49, 0xcb, 0x2d, 0x56, 0x64, 0x75, 0x05, 0x1b, 0x2c, 0x21, 0x1b, 0x1e, 0xa7, 0x02, 0x3d, 0x12,
+    0x1a, 0x97, 0xa5, 0xd2, 0x38, 0xd0, 0xd3, 0xc9, 0x99, 0x3c, 0xb0, 0x94, 0xd6, 0xc4, 0x04, 0x5c,
+    0xf5, 0xbc, 0x5a, 0x64, 0x17, 0x8c, 0x12, 0x92, 0x83, 0xe2, 0x0e, 0x8c, 0x23, 0xbb, 0x04, 0x9f,
+    0x40, 0xdc, 0x87, 0x0a, 0xc4, 0x12, 0x1c, 0x94, 0x84, 0xc1, 0xab, 0x7c, 0xcc, 0x50, 0x0e, 0xfd,
+    0xbb, 0x88, 0xe0, 0xb4, 0x4c, 0xb4, 0x73, 0x90, 0x2c, 0x00, 0xbb, 0xb0, 0x11, 0x6a, 0x2d, 0xf3,
+    0x01, 0x9a, 0x94, 0x29, 0x5d, 0x6d, 0xf4, 0xf9, 0xac, 0x9e, 0xcd, 0x00, 0x6a, 0x26, 0xcf, 0x47,
+    0xff, 0xeb, 0x50, 0xed, 0x0a, 0x55, 0xe1, 0x46, 0x94, 0xce, 0xa4, 0xa4, 0xe5, 0xde, 0xbb, 0x41,
+    0x0f, 0x91, 0x73, 0xec, 0xf4, 0x4f, 0x75, 0x0e, 0xab, 0xae, 0x98, 0xdb, 0x10, 0x38, 0xb8, 0x0b,
+    0x7d, 0x14, 0xa1, 0x83, 0x68, 0x08, 0x7d, 0x23, 0x5a, 0xce, 0xbd, 0x54, 0x79, 0x57, 0xa8, 0x3a,
+    0xc4, 0x56, 0x98, 0xa1, 0x84, 0xdd, 0xb8, 0xd0, 0xa0, 0x97, 0x82, 0x1b, 0xb6, 0xa1, 0xd2, 0xb2,
+    0x61, 0xa3, 0x6c, 0xa2, 0x27, 0x0a, 0x5e, 0xd0, 0xae, 0xe3, 0x31, 0xa6, 0x7e, 0xdd, 0x22, 0xa3,
+    0xcf, 0x09, 0xe2, 0x20, 0xa9, 0xf2, 0x31, 0xce, 0x9e, 0xf7, 0x5c, 0x3f, 0x19, 0x9b, 0x1e, 0x12,
+    0x1d, 0xc3, 0xf8, 0xd9, 0xe1, 0x50, 0x90, 0xad, 0xc9, 0xcb, 0xe2, 0x76, 0x7f, 0x3d, 0x46, 0x24,
+    0x02, 0xcf, 0xa5, 0xc6, 0xa6, 0x8f, 0xf0, 0xb6, 0xc5, 0x1a, 0xff, 0xa3, 0xf7, 0xad, 0x76, 0x54,
+    0x7d, 0xfa, 0x02, 0xc4, 0x0b, 0x2e, 0xf0, 0x97, 0x76, 0xce, 0xfb, 0xe0, 0x73, 0xdc, 0x4d, 0x3e,
+    0x7c, 0xb7, 0x0f, 0x85, 0x66, 0xc8, 0x47, 0x84, 0x02, 0x00, 0x00
+};
+static const WebAsset WEB_MODE_HTML = {"/mode.html", "text/html", WEB_MODE_HTML_GZ, sizeof(WEB_MODE_HTML_GZ), false, "\"fca8296b277bf7f3\""};
+
+// root.tpl.html: 996 bytes, rendered by TemplateStream
+static const char WEB_ROOT_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>HealthSense WiFi Setup</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "</head>\n"
+    "<body>\n"
+    "<div class='container'>\n"
+    "<h1>HealthSense Setup</h1>\n"
+    "{{#CONNECTED}}<p class='status connected'>WiFi Connected to: {{SSID}}</p>\n"
+    "<p class='status'>Station IP: {{STATION_IP}}</p>{{/CONNECTED}}\n"
+    "{{^CONNECTED}}<p class='status disconnected'>WiFi Not Connected</p>{{/CONNECTED}}\n"
+    "<p class='status'>Hotspot IP: {{AP_IP}}</p>\n"
+    "<p class='hint'>Access this device from both WiFi network and hotspot</p>\n"
+    "<p>Configure your WiFi connection:</p>\n"
+    "<form action='/wifi' method='get'><button type='submit'>Setup WiFi</button></form>\n"
+    "{{#CONNECTED}}<form action='/mode' method='get'><button type='submit'>Continue to Mode Selection</button></form>{{/CONNECTED}}\n"
+    "<form action='/status' method='get'><button type='submit' class='guest-btn'>Connection Status</button></form>\n"
+    "</div></body></html>\n";
+
+// status.css: 647 bytes, 329 gzipped
+static const uint8_t WEB_STATUS_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x92, 0xd1, 0x8e, 0x83, 0x20,
+    0x10, 0x45, 0x7f, 0xa5, 0x49, 0x5f, 0xab, 0x51, 0x69, 0xbb, 0x8a, 0xef, 0xfe, 0x07, 0xc2, 0x60,
+    0xc9, 0x5a, 0x86, 0x20, 0x6c, 0xdb, 0x35, 0xfc, 0xfb, 0x62, 0xad, 0x49, 0x6d, 0x4c, 0x36, 0x3c,
+    0x30, 0x61, 0xe6, 0x9e, 0xc0, 0x09, 0x2d, 0x8a, 0xc7, 0x68, 0x98, 0x10, 0x4a, 0x77, 0x34, 0xcf,
+    0xcc, 0xbd, 0x76, 0x70, 0x77, 0x09, 0xeb, 0x55, 0xa7, 0x69, 0x0f, 0xd2, 0x85, 0x94, 0xa3, 0x76,
+    0x4c, 0x69, 0xb0, 0x63, 0x8b, 0x56, 0x80, 0x4d, 0x2c, 0x13, 0xca, 0x0f, 0xf4, 0x64, 0xee, 0x21,
+    0x6d, 0x99, 0x9e, 0x3a, 0x0b, 0xa1, 0x8c, 0x80, 0xf5, 0xd4, 0x31, 0x9e, 0x5c, 0x99, 0xed, 0x94,
+    0x7e, 0xe2, 0x77, 0x59, 0x48, 0xc1, 0x5a, 0x8c, 0x30, 0xc6, 0xbf, 0x3b, 0x8b, 0x5e, 0x0b, 0xba,
+    0x97, 0x12, 0x5a, 0x80, 0x9a, 0x63, 0x8f, 0x96, 0xee, 0x05, 0x29, 0x64, 0x21, 0x5f, 0x1c, 0x9a,
+    0xc7, 0xd0, 0x80, 0xbd, 0x12, 0xbb, 0x38, 0xc6, 0x85, 0x28, 0x42, 0x3a, 0x78, 0xce, 0x61, 0x18,
+    0x56, 0x08, 0x28, 0xe5, 0x09, 0xaa, 0x05, 0x41, 0xca, 0x12, 0x08, 0xdf, 0x40, 0xf0, 0x12, 0xce,
+    0xbc, 0x0a, 0xa9, 0xd2, 0x12, 0x47, 0x19, 0x5f, 0x96, 0x48, 0x76, 0x55, 0xfd, 0x83, 0x5e, 0x51,
+    0xe3, 0x60, 0x18, 0x87, 0x7a, 0x75, 0xb1, 0x6a, 0x5a, 0xf5, 0x4a, 0xd0, 0x3f, 0xef, 0xab, 0x9f,
+    0xd4, 0x41, 0xfd, 0x02, 0xcd, 0x8b, 0xd8, 0xbc, 0x5d, 0x94, 0x83, 0xe4, 0x89, 0xa6, 0xc6, 0x42,
+    0x72, 0xb3, 0xcc, 0x84, 0xd6, 0x3b, 0x87, 0xfa, 0x30, 0x6f, 0xf4, 0x82, 0x3f, 0xb0, 0x16, 0x52,
+    0xe4, 0xd5, 0xb9, 0x21, 0x0b, 0x38, 0x9a, 0xde, 0x91, 0x09, 0xa5, 0x84, 0xbb, 0x50, 0xe6, 0x1d,
+    0x46, 0xf1, 0x4e, 0x27, 0x16, 0xc4, 0x61, 0x29, 0x36, 0x20, 0xf2, 0x78, 0x24, 0xe4, 0x3c, 0x8f,
+    0xa2, 0x65, 0xba, 0x83, 0xc3, 0x5b, 0xbd, 0x11, 0x68, 0x9a, 0xaa, 0xcc, 0xb2, 0x39, 0x60, 0xbc,
+    0x35, 0xfd, 0x2b, 0x30, 0xd7, 0x1b, 0x81, 0x8a, 0x17, 0x5f, 0x6d, 0x16, 0x7c, 0x3f, 0x7e, 0xfc,
+    0x9a, 0x0f, 0x25, 0x2f, 0x7f, 0xc9, 0xd4, 0xa2, 0xc5, 0x24, 0xf1, 0x4d, 0x52, 0x34, 0x18, 0xfe,
+    0x00, 0xff, 0x35, 0x3a, 0x7b, 0x87, 0x02, 0x00, 0x00
+};
+static const WebAsset WEB_STATUS_CSS = {"/status.css", "text/css", WEB_STATUS_CSS_GZ, sizeof(WEB_STATUS_CSS_GZ), true, "\"3affb235f6775a6e\""};
+#define WEB_STATUS_CSS_URL "/status.css?v=b3d706ee"
+
+// status.tpl.html: 1124 bytes, rendered by TemplateStream
+static const char WEB_STATUS_TPL_HTML[] PROGMEM =
+    "<!DOCTYPE html><html>\n"
+    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>\n"
+    "<meta charset='UTF-8'>\n"
+    "<title>Connection Status</title>\n"
+    "<link rel='stylesheet' href='/style.css?v=49f99eef'>\n"
+    "<link rel='stylesheet' href='/status.css?v=b3d706ee'>\n"
+    "</head><body><div class='container'>\n"
+    "<h1>Connection Status</h1>\n"
+    "{{#CONNECTED}}<div class='banner success'><b>✓ Connected</b> to {{SSID}}</div>{{/CONNECTED}}\n"
+    "{{^CONNECTED}}<div class='banner error'><b>✗ Disconnected</b> - {{WIFI_ERROR}}</div>{{/CONNECTED}}\n"
+    "<div class='info'>Mode: {{WIFI_MODE}}\n"
+    "{{#CONNECTED}}IP: {{STATION_IP}}\n"
+    "Signal: -{{RSSI}} dBm\n"
+    "{{/CONNECTED}}Hotspot IP: {{AP_IP}}\n"
+    "Memory: {{HEAP_KB}} KB free\n"
+    "</div>\n"
+    "<ul>\n"
+    "{{#CONNECTED}}<li>Connect via: {{STATION_IP}}</li>{{/CONNECTED}}\n"
+    "<li>Hotspot: {{AP_SSID}} → {{AP_IP}}</li></ul>\n"
+    "<form action='/' method='get'><button type='submit'>Home</button></form>\n"
+    "<button onclick='location.reload()' class='btn-orange'>Refresh</button>\n"
+    "{{^CONNECTED}}<form action='/wifi' method='get' style='display:inline'><button type='submit' class='btn-purple'>WiFi Setup</button></form>{{/CONNECTED}}\n"
+    "</div></body></html>\n";
+
+// style.css: 1205 bytes, 518 gzipped
+static const uint8_t WEB_STYLE_CSS_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x53, 0xdb, 0x8e, 0x9b, 0x30,
+    0x10, 0xfd, 0x15, 0xa4, 0xa8, 0x52, 0x2b, 0x05, 0x64, 0x2e, 0xc9, 0x6e, 0x8c, 0xfa, 0xb0, 0xaa,
+    0x94, 0x9f, 0xa8, 0xf2, 0x60, 0xb0, 0x0d, 0x56, 0xc1, 0x46, 0xbe, 0x34, 0x64, 0x11, 0xff, 0x5e,
+    0x9b, 0x40, 0x62, 0xb2, 0xd9, 0x6a, 0xe5, 0xb7, 0x99, 0x39, 0xc7, 0x67, 0xe6, 0xcc, 0x14, 0x02,
+    0x5f, 0x06, 0x2a, 0xb8, 0x0e, 0x29, 0x6a, 0x59, 0x73, 0x81, 0x6f, 0x92, 0xa1, 0x66, 0xab, 0x10,
+    0x57, 0xa1, 0x22, 0x92, 0xd1, 0xbc, 0x45, 0xb2, 0x62, 0x1c, 0x82, 0xbc, 0x43, 0x18, 0x33, 0x5e,
+    0xc1, 0x78, 0xd7, 0xf5, 0xb9, 0x26, 0xbd, 0x0e, 0x51, 0xc3, 0x2a, 0x0e, 0x4b, 0xc2, 0x35, 0x91,
+    0x79, 0x81, 0xca, 0x3f, 0x95, 0x14, 0x86, 0x63, 0xb8, 0xa1, 0xc0, 0xbd, 0x31, 0x2a, 0x2d, 0x31,
+    0x62, 0x9c, 0xc8, 0xa1, 0x45, 0x7d, 0x78, 0x66, 0x58, 0xd7, 0x30, 0x03, 0xc0, 0xe2, 0x17, 0xd6,
+    0x00, 0x19, 0x2d, 0xd6, 0x58, 0x4a, 0xd7, 0x5f, 0x15, 0x42, 0x62, 0x22, 0x43, 0x89, 0x30, 0x33,
+    0x0a, 0xbe, 0x4e, 0x91, 0x3e, 0x54, 0x35, 0xc2, 0xe2, 0x6c, 0x09, 0xe2, 0xae, 0x0f, 0x6c, 0x59,
+    0x20, 0xab, 0x02, 0x7d, 0x07, 0x5b, 0xf7, 0xa2, 0xf8, 0xc7, 0x58, 0xc7, 0x43, 0x29, 0x1a, 0x21,
+    0xe1, 0x26, 0x4d, 0xd3, 0x7c, 0xea, 0x50, 0xb1, 0x77, 0x02, 0x93, 0xfb, 0xef, 0xa1, 0x16, 0x1d,
+    0xb4, 0x2a, 0x95, 0x46, 0xda, 0xa8, 0xeb, 0x14, 0xce, 0x84, 0x55, 0xb5, 0x86, 0x2f, 0x00, 0x2c,
+    0x45, 0x85, 0xd0, 0x5a, 0xb4, 0x93, 0x94, 0xa9, 0x21, 0x4e, 0x4a, 0x4d, 0xf0, 0x42, 0x9e, 0xfd,
+    0x7a, 0x3b, 0xee, 0x2c, 0x07, 0x66, 0xea, 0x43, 0x8e, 0x66, 0x59, 0x9a, 0xee, 0xc7, 0xc2, 0x58,
+    0x02, 0xbe, 0x65, 0xbc, 0x33, 0xfa, 0xb7, 0xbe, 0x74, 0xe4, 0xa7, 0x32, 0x45, 0xcb, 0xf4, 0x69,
+    0xf0, 0xdb, 0xbe, 0x12, 0xe5, 0x0b, 0xd4, 0x1b, 0x82, 0xed, 0x38, 0x88, 0x93, 0xdb, 0x20, 0x20,
+    0x17, 0x9c, 0x3c, 0x0c, 0x25, 0xb3, 0xd9, 0xd2, 0x48, 0x65, 0xa1, 0x9d, 0x60, 0x93, 0x1d, 0xf3,
+    0x80, 0x1d, 0x18, 0xe4, 0xd7, 0xc9, 0xc7, 0x00, 0x7c, 0x9b, 0xd5, 0xc0, 0x5a, 0xfc, 0x25, 0xf2,
+    0x89, 0xa6, 0x6b, 0x62, 0xad, 0x6c, 0x87, 0x40, 0x76, 0x18, 0xbd, 0x5a, 0xd2, 0x22, 0xd6, 0x9c,
+    0x7c, 0x74, 0x87, 0x94, 0x3a, 0x5b, 0x49, 0xab, 0xa0, 0xdb, 0x91, 0xd3, 0x70, 0xff, 0xdb, 0xef,
+    0x68, 0xad, 0x6f, 0xee, 0xcc, 0x59, 0xa9, 0x44, 0xc3, 0x70, 0xb0, 0xc1, 0x18, 0x3f, 0xe9, 0x71,
+    0x32, 0x9e, 0xbd, 0x3b, 0x8e, 0x39, 0x69, 0x23, 0x63, 0x54, 0x19, 0xa2, 0x74, 0x58, 0x68, 0xbe,
+    0xd2, 0x9d, 0xc4, 0x87, 0xfd, 0x31, 0xf5, 0xb2, 0x4f, 0x7a, 0x03, 0xc5, 0x0b, 0xc6, 0x68, 0x8c,
+    0x5c, 0xec, 0x03, 0xc1, 0xec, 0xdf, 0x2d, 0xf9, 0x04, 0x8f, 0xd3, 0x84, 0x26, 0x74, 0x8c, 0x24,
+    0xb1, 0xee, 0x53, 0x56, 0x19, 0x49, 0x3e, 0xa1, 0xf1, 0x77, 0x2e, 0x05, 0x6e, 0x97, 0x1e, 0x30,
+    0xff, 0x61, 0x57, 0xa6, 0x2c, 0x89, 0x52, 0x8f, 0x3b, 0x47, 0xa4, 0x14, 0xf2, 0x61, 0xd9, 0x22,
+    0x63, 0xaf, 0x76, 0x5d, 0x98, 0xfb, 0x8b, 0x5d, 0x88, 0x06, 0x7b, 0xd7, 0x10, 0x67, 0xdd, 0x32,
+    0xbf, 0x05, 0x74, 0x3c, 0x1e, 0x5e, 0xc1, 0x17, 0x40, 0x25, 0x92, 0x78, 0xf8, 0x8a, 0x71, 0xce,
+    0xed, 0xdb, 0x41, 0x27, 0x77, 0xeb, 0xdd, 0x45, 0x39, 0xef, 0xfd, 0x51, 0x1d, 0xdc, 0x1b, 0xa3,
+    0xda, 0xee, 0xf0, 0xe0, 0x7d, 0xe8, 0x50, 0xb3, 0xbc, 0xfd, 0x7e, 0x3f, 0xfe, 0x03, 0x86, 0x51,
+    0xab, 0xd7, 0xb5, 0x04, 0x00, 0x00
+};
+static const WebAsset WEB_STYLE_CSS = {"/style.css", "text/css", WEB_STYLE_CSS_GZ, sizeof(WEB_STYLE_CSS_GZ), true, "\"39e8b65b04cd59d4\""};
+#define WEB_STYLE_CSS_URL "/style.css?v=49f99eef"
+
+// wifi.html: 725 bytes, 404 gzipped
+static const uint8_t WEB_WIFI_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x75, 0x52, 0xc1, 0x6e, 0xdb, 0x30,
+    0x0c, 0xfd, 0x15, 0xed, 0xa4, 0xcb, 0x52, 0x2f, 0xc0, 0x0e, 0xcd, 0x20, 0x79, 0xc0, 0xba, 0x16,
+    0x3d, 0x75, 0x05, 0xda, 0x61, 0xd8, 0x51, 0x96, 0x98, 0x89, 0x88, 0x2c, 0x79, 0x12, 0xed, 0x2c,
+    0x7f, 0x3f, 0xda, 0xf2, 0x9a, 0xa2, 0x5d, 0x2f, 0x82, 0x48, 0x3d, 0x3e, 0x3e, 0x3e, 0x4a, 0xbd,
+    0xfb, 0xfa, 0xed, 0xea, 0xf1, 0xe7, 0xfd, 0xb5, 0xf0, 0xd4, 0x87, 0x56, 0xad, 0x27, 0x18, 0xd7,
+    0xaa, 0x1e, 0xc8, 0x88, 0x68, 0x7a, 0xd0, 0x72, 0x42, 0x38, 0x0e, 0x29, 0x93, 0x14, 0x36, 0x45,
+    0x82, 0x48, 0x5a, 0x1e, 0xd1, 0x91, 0xd7, 0x0e, 0x26, 0xb4, 0xb0, 0x59, 0x82, 0xf7, 0x02, 0x23,
+    0x12, 0x9a, 0xb0, 0x29, 0xd6, 0x04, 0xd0, 0xdb, 0x8b, 0x0f, 0x72, 0x65, 0xb1, 0xde, 0xe4, 0x02,
+    0x5c, 0xf5, 0xfd, 0xf1, 0x66, 0x73, 0xc9, 0x59, 0x42, 0x0a, 0xd0, 0xde, 0x82, 0x09, 0xe4, 0x1f,
+    0x20, 0x16, 0x10, 0x3f, 0xf0, 0x06, 0xc5, 0x03, 0xd0, 0x38, 0xa8, 0xa6, 0xbe, 0xaa, 0x80, 0xf1,
+    0x20, 0x32, 0x04, 0x2d, 0x0b, 0x9d, 0x02, 0x14, 0x0f, 0xc0, 0x0a, 0x7c, 0x86, 0xbd, 0x96, 0xcd,
+    0x92, 0xba, 0xb0, 0xa5, 0x7c, 0x9e, 0xf4, 0xc7, 0xdd, 0x7e, 0xb7, 0x03, 0xd8, 0x33, 0x71, 0x53,
+    0xb5, 0x77, 0xc9, 0x9d, 0x5a, 0xe5, 0x70, 0x12, 0x36, 0x98, 0x52, 0xb4, 0x9c, 0x75, 0x1b, 0x8c,
+    0x90, 0x19, 0xe3, 0xb7, 0xed, 0xd2, 0xed, 0x2a, 0xc5, 0x08, 0x96, 0x30, 0x45, 0x2e, 0xdb, 0xb6,
+    0x6a, 0x9f, 0x72, 0x2f, 0xcc, 0x92, 0xe0, 0x06, 0xb6, 0xbe, 0x4a, 0xc1, 0x13, 0xf8, 0xe4, 0xb4,
+    0x1c, 0x52, 0x21, 0xae, 0x0e, 0xa6, 0x83, 0x20, 0x18, 0xcb, 0xb2, 0x0a, 0x3a, 0x59, 0xb9, 0xee,
+    0x80, 0x8e, 0x29, 0x1f, 0xc4, 0x1d, 0xfb, 0xf5, 0x49, 0x35, 0x0b, 0x88, 0x65, 0xe4, 0x56, 0x61,
+    0x1c, 0x46, 0x12, 0x74, 0x1a, 0xd8, 0x47, 0x82, 0x3f, 0x4c, 0x88, 0x6e, 0x2d, 0x5d, 0xdd, 0xad,
+    0xf7, 0x21, 0x18, 0x0b, 0x3e, 0x05, 0x07, 0xcc, 0x7c, 0xcd, 0x2e, 0xe7, 0xea, 0xc9, 0x8c, 0x91,
+    0x6c, 0xc3, 0xef, 0x11, 0x33, 0xb8, 0xca, 0xf9, 0x4c, 0xc3, 0xc0, 0xe3, 0x71, 0xe7, 0x7f, 0x3a,
+    0xee, 0xd7, 0xf0, 0x6d, 0x0d, 0x4f, 0x05, 0x8b, 0x8e, 0x73, 0x54, 0xb5, 0x9c, 0xe3, 0xff, 0xe8,
+    0x39, 0xf7, 0x7a, 0xc5, 0x5a, 0xc6, 0xae, 0x47, 0x9e, 0x6d, 0x32, 0x61, 0xe4, 0x70, 0xb5, 0x76,
+    0x5e, 0xc8, 0xec, 0xea, 0x4b, 0x6f, 0xcf, 0xa6, 0xfe, 0x82, 0x19, 0xd4, 0x8d, 0x44, 0x29, 0xbe,
+    0xa0, 0x5a, 0x37, 0xd7, 0x19, 0x7b, 0xd8, 0x74, 0x14, 0x65, 0xfb, 0x85, 0x6f, 0xaa, 0xa9, 0xd8,
+    0x27, 0xe2, 0x86, 0x97, 0xcc, 0x67, 0x5d, 0x78, 0xb3, 0xfc, 0xdf, 0xbf, 0x46, 0xbc, 0x2a, 0xe6,
+    0xd5, 0x02, 0x00, 0x00
+};
+static const WebAsset WEB_WIFI_HTML = {"/wifi.html", "text/html", WEB_WIFI_HTML_GZ, sizeof(WEB_WIFI_HTML_GZ), false, "\"f020388a8e26d973\""};
+
+// Assets served as-is at their path, sorted by path for the route dispatcher
+static const WebAsset* const WEB_STATIC_ROUTES[] = {
+    &WEB_AI_CSS,
+    &WEB_CONNECT_CSS,
+    &WEB_MEASUREMENT_INFO_CSS,
+    &WEB_MEASUREMENT_STREAM_CSS,
+    &WEB_STATUS_CSS,
+    &WEB_STYLE_CSS
+};
+#define WEB_STATIC_ROUTE_COUNT (sizeof(WEB_STATIC_ROUTES) / sizeof(WEB_STATIC_ROUTES[0]))
+
+#endif // WEB_ASSETS_H
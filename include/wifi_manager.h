@@ -4,21 +4,50 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WebServer.h>
-#include <DNSServer.h>
 #include <ESPmDNS.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <esp_wifi.h>
 #include "common_types.h"
+#include "template_stream.h"
+#include "event_stream.h"
+#include "waveform_stream.h"
+#include "background_job.h"
+#include "captive_portal.h"
+#include "captive_dns.h"
+#include "uplink_client.h"
+#include "measurement_queue.h"
+#include "measurement_uploader.h"
+#include "ai_summary_cache.h"
+#include "uplink_worker.h"
 
 // Forward declaration of DisplayManager class
 class DisplayManager;
+struct WebAsset;
 
 
 class WiFiManager {
 private:
-    WebServer* server;
-    DNSServer* dnsServer;
+    // One entry per URL; the table in wifi_manager.cpp is sorted by path
+    // (enforced at compile time) and binary-searched for every request
+    struct Route {
+        const char* path;
+        HTTPMethod method;          // HTTP_ANY accepts every method
+        void (WiFiManager::*handler)();
+    };
+    static const Route routes[];
+    class RouteDispatcher;          // The single RequestHandler registered with the WebServer
+    
+    static constexpr bool pathBefore(const char* a, const char* b) {
+        return *a != *b ? (unsigned char)*a < (unsigned char)*b : (*a != '\0' && pathBefore(a + 1, b + 1));
+    }
+    static constexpr bool routesSorted(const Route* table, size_t count) {
+        return count < 2 || (pathBefore(table[0].path, table[1].path) && routesSorted(table + 1, count - 1));
+    }
+    
+    TakeoverWebServer* server;  // /events connections are taken over by EventStream
+    RouteDispatcher* dispatcher;
+    CaptiveDns dns;             // Resolves every name to the AP while clients are on it
     const char* ap_ssid;
     const char* ap_password;
     IPAddress apIP;
@@ -27,6 +56,8 @@ private:
     String userEmail;
     String userUID;
     String serverURL;
+    UplinkClient uplink;        // Kept-alive connection to serverURL shared by all API calls
+    UplinkWorker uplinkWorker;  // Runs every backend request off the loop task, by priority
     bool isConnected;
     bool isGuestMode;
     bool isLoggedIn;
@@ -35,9 +66,34 @@ private:
     unsigned long lastWifiCheck;
     const unsigned long wifiCheckInterval;
     int lastWifiErrorCode; // Store the last WiFi error code
-    
-    // CSS for web interface
-    String commonCSS;
+    EventStream events;    // Server-Sent Events subscribers of /events
+    WaveformStream waveform; // WebSocket PPG viewers on WAVEFORM_PORT
+    CaptivePortal captivePortal; // Canned answers for OS connectivity probes
+    BackgroundJob connectJob;  // WiFi connection started from /connect
+    BackgroundJob aiJob;       // AI summary request started from /ai_analysis
+    BackgroundJob loginJob;    // Login request started from /login_submit
+    String pendingSSID;        // Owned by connectJob while it runs
+    String pendingPassword;
+    int pendingWifiErrorCode;  // connectJob's result, applied to lastWifiErrorCode in serviceJobs()
+    String aiSummary;          // Owned by aiJob while it runs
+    AISummaryFetch aiFetch;
+    bool aiOnline;             // isConnected when aiJob was submitted
+    AISummaryCache aiCache;    // Last summary, served without waiting for the server
+    String loginEmail;         // Owned by loginJob while it runs
+    String loginPassword;
+    String loginUID;
+    bool loginOnline;
+    MeasurementQueue measurementQueue; // Finished measurements waiting for upload
+    MeasurementUploader uploader; // Batches the queue into as few requests as possible
+    BackgroundJob drainJob;    // Uploads measurementQueue while connected
+    BackgroundJob directJob;   // Uploads directRecord when the flash queue is unavailable
+    QueuedMeasurement directRecord; // Owned by directJob while it runs
+    bool directOnline;
+    bool drainRequested;
+    bool uploadForced;         // requestUpload(): don't wait for the batch window
+    bool freshResult;          // The queue holds a measurement taken since the last drain
+    bool drainOnline;          // isConnected as last seen by serviceJobs()
+    unsigned long lastDrainAttempt;
     
     // Function pointers for callbacks
     void (*setupUICallback)();
@@ -51,9 +107,11 @@ private:
     void handleRoot();
     void handleWiFi();
     void handleConnect();
+    void handleConnectStatus();
     void handleModeSelect();
     void handleLogin();
     void handleLoginSubmit();
+    void handleLoginStatus();
     void handleGuest();
     void handleMeasurement();
     void handleMeasurementInfo();
@@ -66,13 +124,63 @@ private:
     void handleForceAP();
     void handleNotFound();
     void handleAIAnalysis();
+    void handleAIAnalysisResult();
     void handleReturnToMeasurement();
-    String getCommonCSS();
+    void handleProbes();
+    void handleDiagnostics();
+    void handleEvents();
+    
+    // Versioned JSON API for the backend and test rigs (/api/v1/...)
+    void handleApiStatus();
+    void handleApiMeasurement();
+    void handleApiResult();
+    void handleApiConfig();
+    void sendApiJson(int code, const JsonDocument& doc);
+    void sendApiError(int code, const char* error);
+    void handleFavicon();
+    void sendWebAsset(const WebAsset& asset);
+    bool dispatch(HTTPMethod method, const char* path, bool execute);
+    void sendConnectingPage(uint32_t jobId);
+    void sendAIWaitingPage(uint32_t jobId);
+    void sendAIResultPage(const String& summary);
+    uint32_t startAIJob(bool revalidation);
+    bool isAIFetchCurrent() const;
+    String getAIUserKey() const;
+    void sendLoginWaitingPage(uint32_t jobId);
+    uint32_t requestedJobId();
     
-    // API communication
-    bool authenticateUser(String email, String password);
+    // Background jobs: the run* functions execute on the job task (connectJob)
+    // or the uplink worker (all others), serviceJobs() applies their results from loop()
+    static bool runConnectJob(void* context);
+    static bool runAIJob(void* context);
+    static bool runLoginJob(void* context);
+    static bool runDrainJob(void* context);
+    static bool runDirectJob(void* context);
+    void serviceJobs();
+    bool attemptWiFiConnection(const String& ssid, const String& password, int& errorCode);
+    void finishWiFiConnection(bool connected);
+    
+    // TemplateStream callbacks for the templated pages (context is the WiFiManager)
+    static bool pageSection(const char* name, void* context);
+    static void statusValue(const char* name, TemplateStream& out, void* context);
+    static void measurementInfoValue(const char* name, TemplateStream& out, void* context);
+    static bool connectSection(const char* name, void* context);
+    static void connectValue(const char* name, TemplateStream& out, void* context);
+    static void measurementStreamValue(const char* name, TemplateStream& out, void* context);
+    static bool loginSection(const char* name, void* context);
+    static void loginValue(const char* name, TemplateStream& out, void* context);
+    // Context is the job id (uint32_t*) or the summary (const String*) instead
+    static bool jobPageSection(const char* name, void* context);
+    static void jobPageValue(const char* name, TemplateStream& out, void* context);
+    static void aiResultValue(const char* name, TemplateStream& out, void* context);
+    
+    // API communication. These run on the uplink worker, so they only use their
+    // arguments and the job-owned fields, never state that loop() reassigns
+    // (isConnected, isLoggedIn, userUID, ...); the job snapshots what it needs
+    // when it is submitted.
+    bool authenticateUser(const String& email, const String& password, String& uid);
     bool sendMeasurementData(String uid, int32_t heartRate, int32_t spo2);
-    bool getAIHealthSummary(String& summary);
+    bool getAIHealthSummary(String& summary, AISummaryFetch& fetch);
 
 public:
     WiFiManager(const char* ap_ssid, const char* ap_password, const char* serverURL = "http://yourapiserver.com");
@@ -86,7 +194,7 @@ public:
     void saveUserCredentials(String email, String uid);
     void sendSensorData(int32_t heartRate, int32_t spo2);
     bool sendDeviceData(int32_t heartRate, int32_t spo2, String userId = "");
-    bool requestAIHealthSummary(String& summary);
+    bool requestAIHealthSummary(String& summary, AISummaryFetch& fetch);
     
     // Setters for callbacks
     void setSetupUICallback(void (*callback)());
@@ -109,9 +217,18 @@ public:
     String getConnectionInfo() const;
     int getLastWifiErrorCode() const { return lastWifiErrorCode; }
     
+    // Live measurement events for /events subscribers (called from SensorManager callbacks)
+    void publishFingerStatus(bool fingerDetected);
+    void publishReadings(int32_t heartRate, bool validHR, int32_t spo2, bool validSPO2, int probe = 0);
+    void publishMeasurementComplete(int32_t avgHR, int32_t avgSpO2, int probe = 0);
+    void publishWaveform(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count);
+    
     // Control measurement state
     void startMeasurement();
     void stopMeasurement();
+    
+    // Uploads the measurement queue without waiting for a full batch; false when offline
+    bool requestUpload();
     void resetMeasurementStreamState();
     
     // WiFi stability helper
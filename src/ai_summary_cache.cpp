@@ -0,0 +1,57 @@
+#include "ai_summary_cache.h"
+
+AISummaryCache::AISummaryCache() :
+    valid(false),
+    sequence(0),
+    fetchedAt(0),
+    hits(0),
+    misses(0),
+    revalidations(0),
+    notModified(0) {
+    etag[0] = '\0';
+}
+
+bool AISummaryCache::lookup(const String& userId, uint32_t sequence) {
+    bool hit = valid && sequence == this->sequence && userId == this->userId;
+    if (hit) {
+        hits++;
+    } else {
+        misses++;
+    }
+    return hit;
+}
+
+bool AISummaryCache::isStale() const {
+    return millis() - fetchedAt > AI_SUMMARY_TTL_MS;
+}
+
+void AISummaryCache::prepareFetch(AISummaryFetch& fetch, const String& userId, uint32_t sequence, bool revalidation) {
+    fetch.userId = userId;
+    fetch.sequence = sequence;
+    fetch.revalidation = revalidation;
+    fetch.etag[0] = '\0';
+    fetch.notModified = false;
+    fetch.ifNoneMatch[0] = '\0';
+    if (revalidation) {
+        strncpy(fetch.ifNoneMatch, etag, AI_SUMMARY_ETAG_SIZE);
+        revalidations++;
+    }
+}
+
+void AISummaryCache::update(const AISummaryFetch& fetch, const String& newSummary) {
+    if (fetch.notModified) {
+        // Only meaningful for the entry the conditional request was made for
+        if (valid && fetch.userId == userId && fetch.sequence == sequence) {
+            fetchedAt = millis();
+            notModified++;
+        }
+        return;
+    }
+
+    valid = true;
+    userId = fetch.userId;
+    sequence = fetch.sequence;
+    summary = newSummary;
+    strncpy(etag, fetch.etag, AI_SUMMARY_ETAG_SIZE);
+    fetchedAt = millis();
+}
@@ -0,0 +1,97 @@
+#include "background_job.h"
+
+uint32_t BackgroundJob::nextId = 1;
+
+BackgroundJob::BackgroundJob(const char* name) :
+    name(name),
+    work(nullptr),
+    context(nullptr),
+    id(0),
+    state(JOB_UNKNOWN),
+    success(false),
+    completionPending(false),
+    startedAt(0),
+    finishedAt(0) {
+}
+
+uint32_t BackgroundJob::start(Work work, void* context) {
+    if (reserve(work, context) == 0) {
+        return 0;
+    }
+
+    if (xTaskCreatePinnedToCore(taskEntry, name, BACKGROUND_JOB_STACK, this,
+                                BACKGROUND_JOB_PRIORITY, nullptr, BACKGROUND_JOB_CORE) != pdPASS) {
+        Serial.print("❌ Could not start background job ");
+        Serial.println(name);
+        cancel();
+        return 0;
+    }
+
+    Serial.print("⚙️ Background job ");
+    Serial.print(name);
+    Serial.print(" #");
+    Serial.print(id);
+    Serial.println(" started");
+    return id;
+}
+
+uint32_t BackgroundJob::reserve(Work work, void* context) {
+    if (state == JOB_RUNNING) {
+        return 0;
+    }
+
+    this->work = work;
+    this->context = context;
+    id = nextId++;
+    success = false;
+    completionPending = false;
+    startedAt = millis();
+    state = JOB_RUNNING;
+    return id;
+}
+
+void BackgroundJob::cancel() {
+    state = JOB_UNKNOWN;
+    id = 0;
+}
+
+void BackgroundJob::run() {
+    bool result = work(context);
+
+    // Publish the result before the state so a reader that sees JOB_DONE sees both
+    success = result;
+    finishedAt = millis();
+    completionPending = true;
+    state = JOB_DONE;
+
+    Serial.print("⚙️ Background job ");
+    Serial.print(name);
+    Serial.println(result ? " finished" : " failed");
+}
+
+void BackgroundJob::taskEntry(void* param) {
+    static_cast<BackgroundJob*>(param)->run();
+    vTaskDelete(nullptr);
+}
+
+JobState BackgroundJob::getState(uint32_t jobId) const {
+    if (jobId == 0 || jobId != id) {
+        return JOB_UNKNOWN;
+    }
+    return state;
+}
+
+unsigned long BackgroundJob::getElapsedMs() const {
+    if (state == JOB_RUNNING) {
+        return millis() - startedAt;
+    }
+    return finishedAt - startedAt;
+}
+
+bool BackgroundJob::takeCompletion() {
+    if (!completionPending) {
+        return false;
+    }
+    completionPending = false;
+    return true;
+}
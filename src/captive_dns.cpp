@@ -0,0 +1,157 @@
+#include "captive_dns.h"
+
+#define DNS_HEADER_SIZE 12
+#define DNS_TYPE_A 1
+#define DNS_TYPE_AAAA 28
+#define DNS_CLASS_IN 1
+#define DNS_RCODE_NXDOMAIN 3
+
+CaptiveDns::CaptiveDns() :
+    running(false),
+    task(nullptr),
+    stopRequested(false),
+    queries(0),
+    answered(0),
+    noData(0),
+    nxDomain(0),
+    dropped(0) {
+    memset(answer, 0, sizeof(answer));
+}
+
+bool CaptiveDns::start(const IPAddress& ip, bool ownTask) {
+    // Answer record for every A query: name is a pointer to the question (offset 12)
+    answer[0] = 0xC0;
+    answer[1] = DNS_HEADER_SIZE;
+    answer[2] = 0;
+    answer[3] = DNS_TYPE_A;
+    answer[4] = 0;
+    answer[5] = DNS_CLASS_IN;
+    answer[6] = (DNS_TTL_SECONDS >> 24) & 0xFF;
+    answer[7] = (DNS_TTL_SECONDS >> 16) & 0xFF;
+    answer[8] = (DNS_TTL_SECONDS >> 8) & 0xFF;
+    answer[9] = DNS_TTL_SECONDS & 0xFF;
+    answer[10] = 0;
+    answer[11] = 4;
+    for (int i = 0; i < 4; i++) {
+        answer[12 + i] = ip[i];
+    }
+
+    if (!running) {
+        if (!udp.begin(DNS_PORT)) {
+            return false;
+        }
+        running = true;
+    }
+
+    if (ownTask && task == nullptr) {
+        stopRequested = false;
+        if (xTaskCreatePinnedToCore(taskEntry, "captive_dns", DNS_TASK_STACK, this,
+                                    DNS_TASK_PRIORITY, &task, DNS_TASK_CORE) != pdPASS) {
+            // loop() keeps serving queries instead
+            task = nullptr;
+            Serial.println("⚠️ DNS task not started, answering from loop()");
+        }
+    }
+    return true;
+}
+
+void CaptiveDns::stop() {
+    if (task != nullptr) {
+        // Let the task finish its current drain and exit on its own
+        stopRequested = true;
+        while (task != nullptr) {
+            vTaskDelay(1);
+        }
+    }
+    if (running) {
+        udp.stop();
+        running = false;
+    }
+}
+
+void CaptiveDns::taskEntry(void* param) {
+    CaptiveDns* dns = static_cast<CaptiveDns*>(param);
+    while (!dns->stopRequested) {
+        dns->processRequests();
+        vTaskDelay(pdMS_TO_TICKS(DNS_TASK_INTERVAL_MS));
+    }
+    dns->task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void CaptiveDns::loop() {
+    if (task == nullptr) {
+        processRequests();
+    }
+}
+
+int CaptiveDns::processRequests() {
+    if (!running) {
+        return 0;
+    }
+
+    int handled = 0;
+    while (handled < DNS_MAX_QUERIES_PER_CALL) {
+        int length = udp.parsePacket();
+        if (length <= 0) {
+            break;
+        }
+        handled++;
+        queries++;
+
+        if (length > DNS_MAX_PACKET) {
+            dropped++;
+        } else {
+            udp.read(packet, length);
+            handlePacket(length);
+        }
+        udp.flush(); // Releases the receive buffer so the next packet can be parsed
+    }
+    return handled;
+}
+
+void CaptiveDns::handlePacket(int length) {
+    // Only standard queries (QR=0, opcode 0) with exactly one question
+    if (length < DNS_HEADER_SIZE || (packet[2] & 0xF8) != 0 || packet[4] != 0 || packet[5] != 1) {
+        dropped++;
+        return;
+    }
+
+    // Walk the question name; queries never use compression pointers
+    int pos = DNS_HEADER_SIZE;
+    while (pos < length && packet[pos] != 0) {
+        if (packet[pos] & 0xC0) {
+            dropped++;
+            return;
+        }
+        pos += packet[pos] + 1;
+    }
+    int end = pos + 5; // Terminating zero, QTYPE, QCLASS
+    if (end > length || end + (int)sizeof(answer) > DNS_MAX_PACKET) {
+        dropped++;
+        return;
+    }
+    uint16_t qtype = (packet[pos + 1] << 8) | packet[pos + 2];
+    uint16_t qclass = (packet[pos + 3] << 8) | packet[pos + 4];
+
+    // Reply in place: same id and question, additional records (EDNS) dropped
+    packet[2] = 0x84 | (packet[2] & 0x01); // QR, AA, RD copied from the query
+    packet[3] = 0;                          // NOERROR
+    memset(packet + 6, 0, 6);               // ANCOUNT, NSCOUNT, ARCOUNT
+
+    if (qtype == DNS_TYPE_A && qclass == DNS_CLASS_IN) {
+        memcpy(packet + end, answer, sizeof(answer));
+        packet[7] = 1;
+        end += sizeof(answer);
+        answered++;
+    } else if (qtype == DNS_TYPE_AAAA) {
+        noData++;
+    } else {
+        packet[3] = DNS_RCODE_NXDOMAIN;
+        nxDomain++;
+    }
+
+    udp.beginPacket(udp.remoteIP(), udp.remotePort());
+    udp.write(packet, end);
+    udp.endPacket();
+}
@@ -0,0 +1,76 @@
+#include "captive_portal.h"
+
+static const char APPLE_SUCCESS[] PROGMEM = "<HTML><HEAD><TITLE>Success</TITLE></HEAD><BODY>Success</BODY></HTML>";
+
+// Known connectivity checks. Paths are matched first, hosts only for paths not listed here.
+static const CaptiveProbe PROBES[] = {
+    // Android / ChromeOS
+    {"connectivitycheck.gstatic.com", "/generate_204",              204, "text/plain", ""},
+    {"connectivitycheck.android.com", "/generate_204",              204, "text/plain", ""},
+    {"clients3.google.com",           "/generate_204",              204, "text/plain", ""},
+    {nullptr,                         "/gen_204",                   204, "text/plain", ""},
+    {nullptr,                         "/mobile/status.php",         204, "text/plain", ""},
+    // Apple
+    {"captive.apple.com",             "/hotspot-detect.html",       200, "text/html",  APPLE_SUCCESS},
+    {nullptr,                         "/library/test/success.html", 200, "text/html",  APPLE_SUCCESS},
+    // Windows
+    {"www.msftconnecttest.com",       "/connecttest.txt",           200, "text/plain", "Microsoft Connect Test"},
+    {"www.msftncsi.com",              "/ncsi.txt",                  200, "text/plain", "Microsoft NCSI"},
+    // Firefox
+    {"detectportal.firefox.com",      "/success.txt",               200, "text/plain", "success\n"},
+    {nullptr,                         "/canonical.html",            200, "text/html",  "<meta http-equiv=\"refresh\" content=\"0;url=https://support.mozilla.org/kb/captive-portal\"/>"},
+};
+
+#define PROBE_COUNT (sizeof(PROBES) / sizeof(PROBES[0]))
+
+CaptivePortal::CaptivePortal() {
+    portalURL[0] = '\0';
+    redirectBody[0] = '\0';
+}
+
+void CaptivePortal::begin(const IPAddress& apIP) {
+    snprintf(portalURL, sizeof(portalURL), "http://%u.%u.%u.%u/", apIP[0], apIP[1], apIP[2], apIP[3]);
+    snprintf(redirectBody, sizeof(redirectBody),
+             "<!DOCTYPE html><html><head><meta charset='UTF-8'>"
+             "<meta http-equiv='refresh' content='0;url=%s'><title>Redirecting...</title></head>"
+             "<body>Redirecting to <a href='%s'>HealthSense Setup</a>...</body></html>",
+             portalURL, portalURL);
+}
+
+const CaptiveProbe* CaptivePortal::match(WebServer& server) const {
+    String path = server.uri();
+    for (size_t i = 0; i < PROBE_COUNT; i++) {
+        if (path == PROBES[i].path) {
+            return &PROBES[i];
+        }
+    }
+
+    String host = server.hostHeader();
+    for (size_t i = 0; i < PROBE_COUNT; i++) {
+        if (PROBES[i].host != nullptr && host.equalsIgnoreCase(PROBES[i].host)) {
+            return &PROBES[i];
+        }
+    }
+    return nullptr;
+}
+
+void CaptivePortal::answerProbe(WebServer& server, const CaptiveProbe& probe, bool portalRequired) const {
+    if (portalRequired) {
+        redirect(server);
+        return;
+    }
+
+    // OSes cache a positive check; make sure they ask again next time they join
+    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    if (probe.onlineCode == 204) {
+        server.send(204);
+    } else {
+        server.send_P(probe.onlineCode, probe.contentType, probe.onlineBody);
+    }
+}
+
+void CaptivePortal::redirect(WebServer& server) const {
+    server.sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server.sendHeader("Location", portalURL, true);
+    server.send_P(302, "text/html", redirectBody);
+}
@@ -301,6 +301,28 @@ void DisplayManager::updateSensorReadings(int32_t heartRate, bool validHR, int32
     }
 }
 
+void DisplayManager::showProbeReadings(int probe, int32_t heartRate, bool validHR, int32_t spo2, bool validSPO2) {
+    // Compact one-line readout for additional probes, between SpO2 and the IP line
+    tft->fillRect(0, 120, 160, 10, ST7735_BLACK);
+    tft->setCursor(5, 120);
+    tft->setTextColor(ST7735_MAGENTA);
+    tft->print("P");
+    tft->print(probe + 1);
+    tft->print(" HR:");
+    if (validHR) {
+        tft->print(heartRate);
+    } else {
+        tft->print("--");
+    }
+    tft->print(" SpO2:");
+    if (validSPO2) {
+        tft->print(abs(spo2));
+        tft->print("%");
+    } else {
+        tft->print("--%");
+    }
+}
+
 void DisplayManager::showMeasuringStatus() {
     extern SensorManager sensorManager;
     
@@ -0,0 +1,135 @@
+#include "event_stream.h"
+#include "nonblocking_send.h"
+
+EventStream::EventStream() :
+    lastKeepAlive(0),
+    eventsPublished(0),
+    eventsDropped(0) {
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++) {
+        subscribers[i].used = 0;
+        subscribers[i].active = false;
+    }
+}
+
+bool EventStream::subscribe(WiFiClient& client) {
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers[i];
+        if (sub.active) {
+            continue;
+        }
+
+        sub.client = client;
+        sub.client.setNoDelay(true);
+        sub.used = 0;
+        sub.active = true;
+
+        char header[192];
+        int length = snprintf(header, sizeof(header),
+                              "HTTP/1.1 200 OK\r\n"
+                              "Content-Type: text/event-stream\r\n"
+                              "Cache-Control: no-cache\r\n"
+                              "Connection: keep-alive\r\n"
+                              "Access-Control-Allow-Origin: *\r\n"
+                              "\r\n"
+                              "retry: %d\n\n", EVENT_RETRY_MS);
+        queue(sub, header, length);
+        flush(sub);
+
+        Serial.print("📡 SSE subscriber connected, slot ");
+        Serial.println(i);
+        return sub.active;
+    }
+
+    Serial.println("📡 SSE subscriber rejected - all slots in use");
+    return false;
+}
+
+void EventStream::publish(const char* event, const char* data) {
+    if (getSubscriberCount() == 0) {
+        return;
+    }
+
+    char frame[EVENT_MAX_FRAME];
+    int length = snprintf(frame, sizeof(frame), "event: %s\ndata: %s\n\n", event, data);
+    if (length <= 0 || length >= (int)sizeof(frame)) {
+        return;
+    }
+
+    eventsPublished++;
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].active && !queue(subscribers[i], frame, length)) {
+            eventsDropped++;
+        }
+    }
+}
+
+void EventStream::loop() {
+    unsigned long now = millis();
+    bool keepAlive = (now - lastKeepAlive >= EVENT_KEEPALIVE_MS);
+    if (keepAlive) {
+        lastKeepAlive = now;
+    }
+
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++) {
+        Subscriber& sub = subscribers[i];
+        if (!sub.active) {
+            continue;
+        }
+        if (!sub.client.connected()) {
+            Serial.print("📡 SSE subscriber disconnected, slot ");
+            Serial.println(i);
+            release(sub);
+            continue;
+        }
+        if (keepAlive) {
+            queue(sub, ": ping\n\n", 8);
+        }
+        flush(sub);
+    }
+}
+
+int EventStream::getSubscriberCount() const {
+    int count = 0;
+    for (int i = 0; i < EVENT_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool EventStream::queue(Subscriber& sub, const char* data, size_t length) {
+    // Never block acquisition on a slow reader: drop the whole event instead
+    if (sub.used + length > EVENT_CLIENT_BUFFER) {
+        return false;
+    }
+    memcpy(sub.buffer + sub.used, data, length);
+    sub.used += length;
+    return true;
+}
+
+void EventStream::flush(Subscriber& sub) {
+    if (sub.used == 0) {
+        return;
+    }
+
+    int sent = sendNonBlocking(sub.client, (const uint8_t*)sub.buffer, sub.used);
+    if (sent < 0) {
+        release(sub);
+        return;
+    }
+    size_t written = sent;
+
+    // Keep whatever the socket didn't accept for the next pass
+    if (written < sub.used) {
+        memmove(sub.buffer, sub.buffer + written, sub.used - written);
+    }
+    sub.used -= written;
+}
+
+void EventStream::release(Subscriber& sub) {
+    sub.client.stop();
+    sub.client = WiFiClient();
+    sub.used = 0;
+    sub.active = false;
+}
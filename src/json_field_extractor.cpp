@@ -0,0 +1,279 @@
+#include "json_field_extractor.h"
+
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+JsonFieldExtractor::JsonFieldExtractor() : fieldCount(0) {
+    reset();
+}
+
+int JsonFieldExtractor::addField(const char* key, char* buffer, size_t size) {
+    if (fieldCount >= JSON_EXTRACT_MAX_FIELDS || size == 0) {
+        return -1;
+    }
+
+    Field& field = fields[fieldCount];
+    field.key = key;
+    field.buffer = buffer;
+    field.size = size;
+    field.length = 0;
+    field.found = false;
+    field.truncated = false;
+    buffer[0] = '\0';
+    return fieldCount++;
+}
+
+void JsonFieldExtractor::reset() {
+    depth = 0;
+    expectKey = false;
+    readingKey = false;
+    inString = false;
+    escaped = false;
+    inScalar = false;
+    unicodeDigits = -1;
+    unicodeValue = 0;
+    highSurrogate = 0;
+    target = -1;
+    keyLength = 0;
+
+    for (int i = 0; i < fieldCount; i++) {
+        fields[i].length = 0;
+        fields[i].found = false;
+        fields[i].truncated = false;
+        fields[i].buffer[0] = '\0';
+    }
+}
+
+size_t JsonFieldExtractor::write(uint8_t c) {
+    feed((char)c);
+    return 1;
+}
+
+size_t JsonFieldExtractor::write(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        feed((char)data[i]);
+    }
+    return length;
+}
+
+void JsonFieldExtractor::feed(char c) {
+    if (inString) {
+        if (unicodeDigits >= 0) {
+            int digit = -1;
+            if (c >= '0' && c <= '9') digit = c - '0';
+            else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+
+            if (digit >= 0) {
+                unicodeValue = (unicodeValue << 4) | digit;
+                if (++unicodeDigits < 4) {
+                    return;
+                }
+                unicodeDigits = -1;
+
+                if (unicodeValue >= 0xDC00 && unicodeValue <= 0xDFFF && highSurrogate != 0) {
+                    emitCodepoint(0x10000 + ((uint32_t)(highSurrogate - 0xD800) << 10) + (unicodeValue - 0xDC00));
+                    return;
+                }
+                flushHighSurrogate();
+                if (unicodeValue >= 0xD800 && unicodeValue <= 0xDBFF) {
+                    highSurrogate = unicodeValue;
+                } else if ((unicodeValue >= 0xDC00 && unicodeValue <= 0xDFFF) || unicodeValue == 0) {
+                    // Lone low surrogate, or \u0000 which would cut the C string short
+                    emitCodepoint(REPLACEMENT_CHARACTER);
+                } else {
+                    emitCodepoint(unicodeValue);
+                }
+                return;
+            }
+
+            // Malformed \u escape: replace it and read c as ordinary input
+            unicodeDigits = -1;
+            flushHighSurrogate();
+            emitCodepoint(REPLACEMENT_CHARACTER);
+        }
+
+        if (escaped) {
+            escaped = false;
+            handleEscape(c);
+        } else if (c == '\\') {
+            escaped = true;
+        } else if (c == '"') {
+            flushHighSurrogate();
+            inString = false;
+            if (readingKey) {
+                readingKey = false;
+                target = findField();
+                if (target >= 0) {
+                    Field& field = fields[target];
+                    field.length = 0;
+                    field.found = false;
+                    field.truncated = false;
+                    field.buffer[0] = '\0';
+                }
+            } else if (target >= 0) {
+                endValue();
+            }
+        } else {
+            flushHighSurrogate();
+            emitByte((uint8_t)c);
+        }
+        return;
+    }
+
+    if (inScalar) {
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            inScalar = false;
+            endValue();
+        } else {
+            emitByte((uint8_t)c);
+            return;
+        }
+    }
+
+    switch (c) {
+        case '"':
+            inString = true;
+            if (depth == 1 && expectKey) {
+                readingKey = true;
+                expectKey = false;
+                keyLength = 0;
+            }
+            break;
+        case '{':
+        case '[':
+            depth++;
+            if (depth == 1 && c == '{') {
+                expectKey = true;
+            } else {
+                target = -1; // Nested values are skipped
+            }
+            break;
+        case '}':
+        case ']':
+            depth--;
+            break;
+        case ',':
+            if (depth == 1) {
+                expectKey = true;
+                target = -1;
+            }
+            break;
+        case ':':
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            break;
+        default:
+            if (depth == 1 && target >= 0) {
+                inScalar = true;
+                emitByte((uint8_t)c);
+            }
+            break;
+    }
+}
+
+void JsonFieldExtractor::handleEscape(char c) {
+    if (c == 'u') {
+        unicodeDigits = 0;
+        unicodeValue = 0;
+        return;
+    }
+
+    flushHighSurrogate();
+    switch (c) {
+        case 'b': emitByte('\b'); break;
+        case 'f': emitByte('\f'); break;
+        case 'n': emitByte('\n'); break;
+        case 'r': emitByte('\r'); break;
+        case 't': emitByte('\t'); break;
+        default:  emitByte((uint8_t)c); break; // \" \\ \/
+    }
+}
+
+// A high surrogate that isn't followed by a low one is replaced, not dropped
+void JsonFieldExtractor::flushHighSurrogate() {
+    if (highSurrogate != 0) {
+        emitCodepoint(REPLACEMENT_CHARACTER);
+    }
+}
+
+void JsonFieldExtractor::emitCodepoint(uint32_t codepoint) {
+    highSurrogate = 0;
+
+    if (codepoint < 0x80) {
+        emitByte(codepoint);
+    } else if (codepoint < 0x800) {
+        emitByte(0xC0 | (codepoint >> 6));
+        emitByte(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        emitByte(0xE0 | (codepoint >> 12));
+        emitByte(0x80 | ((codepoint >> 6) & 0x3F));
+        emitByte(0x80 | (codepoint & 0x3F));
+    } else {
+        emitByte(0xF0 | (codepoint >> 18));
+        emitByte(0x80 | ((codepoint >> 12) & 0x3F));
+        emitByte(0x80 | ((codepoint >> 6) & 0x3F));
+        emitByte(0x80 | (codepoint & 0x3F));
+    }
+}
+
+void JsonFieldExtractor::emitByte(uint8_t b) {
+    if (readingKey) {
+        // An overlong key is marked by keyLength == JSON_EXTRACT_KEY_SIZE and matches nothing
+        if (keyLength < JSON_EXTRACT_KEY_SIZE - 1) {
+            key[keyLength++] = (char)b;
+        } else {
+            keyLength = JSON_EXTRACT_KEY_SIZE;
+        }
+        return;
+    }
+
+    if (target < 0) {
+        return;
+    }
+
+    Field& field = fields[target];
+    if (field.truncated) {
+        return;
+    }
+    if (field.length + 1 < field.size) {
+        field.buffer[field.length++] = (char)b;
+        field.buffer[field.length] = '\0';
+        return;
+    }
+
+    // Full: cut before a UTF-8 sequence that didn't fit completely
+    field.truncated = true;
+    size_t start = field.length;
+    while (start > 0 && ((uint8_t)field.buffer[start - 1] & 0xC0) == 0x80) {
+        start--;
+    }
+    if (start > 0) {
+        uint8_t lead = (uint8_t)field.buffer[start - 1];
+        size_t needed = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+        if (field.length - (start - 1) < needed) {
+            field.length = start - 1;
+        }
+    }
+    field.buffer[field.length] = '\0';
+}
+
+void JsonFieldExtractor::endValue() {
+    if (target >= 0) {
+        fields[target].found = true;
+    }
+    target = -1;
+}
+
+int JsonFieldExtractor::findField() const {
+    if (keyLength >= JSON_EXTRACT_KEY_SIZE) {
+        return -1;
+    }
+    for (int i = 0; i < fieldCount; i++) {
+        if (strlen(fields[i].key) == keyLength && memcmp(fields[i].key, key, keyLength) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
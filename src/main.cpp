@@ -9,12 +9,16 @@
 #include "wifi_manager.h"
 #include "display_manager.h"
 #include "sensor_manager.h"
+#include "sensor_scheduler.h"
 #include "mqtt_manager.h"
+#include "tone_player.h"
 #include "images.h"
 
 // Define pins for the ESP32
 #define SDA_PIN 21  // Default SDA pin for ESP32
 #define SCL_PIN 22  // Default SCL pin for ESP32
+#define SDA2_PIN 25 // SDA pin of the second I2C controller (second probe)
+#define SCL2_PIN 26 // SCL pin of the second I2C controller (second probe)
 
 // Define pins for ST7735 TFT display
 #define TFT_CS     5
@@ -22,13 +26,20 @@
 #define TFT_DC     2
 #define BUZZER_PIN 15  // Buzzer connected to pin 15 on ESP32
 
+#define SENSOR_SETTLE_MS 3000 // Time to place a finger after the probes are initialized
+
 // Create instances
 Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
 DisplayManager display(&tft, eva, eva_width, eva_height);
 // IoT API server URL with the correct login endpoint
 WiFiManager wifiManager("HealthSense", "123123123", "https://iot.newnol.io.vn");
 SensorManager sensorManager(100); // buffer size 100
-MQTTManager mqttManager(BUZZER_PIN); // MQTT manager with buzzer pin
+#if SENSOR_PROBE_COUNT > 1
+SensorManager secondProbe(100); // Optional second probe on Wire1
+#endif
+SensorScheduler sensorScheduler; // Interleaves FIFO reads across all probes
+TonePlayer tonePlayer; // Non-blocking buzzer melodies on LEDC channel 0
+MQTTManager mqttManager(BUZZER_PIN, tonePlayer); // MQTT manager with buzzer pin
 
 // Global app state (using the common AppState enum from common_types.h)
 AppState currentState = STATE_SETUP;
@@ -41,6 +52,9 @@ void initializeSensor();
 void updateConnectionStatus(bool connected, bool guestMode, bool loggedIn);
 void sendSensorData(String uid, int32_t heartRate, int32_t spo2);
 void handleAIAnalysisRequest(String summaryText);
+void publishSessionEvent(const char* event);
+void reportProbeResult(int probe, int32_t avgHR, int32_t avgSpO2);
+void startNewMeasurement();
 
 void setup() {
   Serial.begin(9600);
@@ -50,36 +64,75 @@ void setup() {
   
   // Initialize sensor manager
   sensorManager.begin(SDA_PIN, SCL_PIN);
+  sensorScheduler.addProbe(&sensorManager);
+  
+#if SENSOR_PROBE_COUNT > 1
+  // Second probe on the ESP32's other I2C controller, with its own session
+  secondProbe.begin(SDA2_PIN, SCL2_PIN, Wire1);
+  secondProbe.setUpdateReadingsCallback([](int32_t hr, bool validHR, int32_t spo2, bool validSPO2) {
+    display.showProbeReadings(1, hr, validHR, spo2, validSPO2);
+    wifiManager.publishReadings(hr, validHR, spo2, validSPO2, 1);
+  });
+  secondProbe.setMeasurementCompleteCallback([](int32_t avgHR, int32_t avgSpO2) {
+    Serial.print(F("=== PROBE 2 MEASUREMENT COMPLETE === HR: "));
+    Serial.print(avgHR);
+    Serial.print(F(", SpO2: "));
+    Serial.println(avgSpO2);
+    reportProbeResult(1, avgHR, avgSpO2);
+  });
+  // Each probe starts its own session when a finger is placed on it
+  secondProbe.setUpdateFingerStatusCallback([](bool fingerDetected) {
+    if (fingerDetected && wifiManager.isMeasurementActive() &&
+        !secondProbe.isMeasurementInProgress() && !secondProbe.isMeasurementReady()) {
+      Serial.println(F("👆 Finger detected on probe 2, starting measurement..."));
+      secondProbe.startMeasurement();
+    }
+  });
+  sensorScheduler.addProbe(&secondProbe);
+#endif
   
   // Set up callbacks for WiFi manager
   wifiManager.setSetupUICallback(setupUI);
   wifiManager.setInitializeSensorCallback(initializeSensor);
   wifiManager.setUpdateConnectionStatusCallback(updateConnectionStatus);
   wifiManager.setSendDataCallback(sendSensorData);
-  wifiManager.setStartNewMeasurementCallback([]() {
-    Serial.println(F("Starting new measurement from web interface..."));
-    if (sensorManager.isReady()) {
-      // Clear screen first
-      display.clearScreen();
-      // Setup sensor UI after clearing
-      display.setupSensorUI();
-      // Start the measurement
-      sensorManager.startMeasurement();
-    }
-  });
+  wifiManager.setStartNewMeasurementCallback(startNewMeasurement);
   
   // Set up AI Analysis callback
   wifiManager.setHandleAIAnalysisCallback(handleAIAnalysisRequest);
   
   // Set up MQTT manager with callback to check if device is measuring
   mqttManager.setIsMeasuringCallback([]() -> bool {
-    return sensorManager.isMeasurementInProgress();
+    return sensorScheduler.isMeasurementInProgress();
+  });
+  
+  // Same policy for anything already playing or queued: no melodies during a measurement
+  tonePlayer.setQuietCallback([]() -> bool {
+    return sensorScheduler.isMeasurementInProgress();
+  });
+  
+  // Remote commands received over MQTT
+  mqttManager.setStartMeasurementCallback([]() -> bool {
+    // Same rule as the web API: a session (guest or logged in) must be chosen first
+    if (!sensorScheduler.isReady() || (!wifiManager.isInGuestMode() && !wifiManager.isUserLoggedIn())) {
+      return false;
+    }
+    wifiManager.startMeasurement();
+    startNewMeasurement();
+    return true;
+  });
+  mqttManager.setStopMeasurementCallback([]() {
+    wifiManager.stopMeasurement();
+  });
+  mqttManager.setUploadCallback([]() -> bool {
+    return wifiManager.requestUpload();
   });
   
   // Set up callbacks for sensor manager
   sensorManager.setUpdateReadingsCallback([](int32_t hr, bool validHR, int32_t spo2, bool validSPO2) {
     // Always update the display with current readings and validity flags
     display.updateSensorReadings(hr, validHR, spo2, validSPO2);
+    wifiManager.publishReadings(hr, validHR, spo2, validSPO2);
     
     // Log current readings for monitoring
     if (validHR && validSPO2) {
@@ -90,8 +143,14 @@ void setup() {
     }
   });
   
+  // Stream every hop of raw samples to waveform viewers
+  sensorManager.setHopCallback([](const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count) {
+    wifiManager.publishWaveform(red, ir, timestamps, count);
+  });
+  
   sensorManager.setUpdateFingerStatusCallback([](bool fingerDetected) {
     display.showFingerStatus(fingerDetected);
+    wifiManager.publishFingerStatus(fingerDetected);
     
     // Start measurement when finger is detected (if not already measuring)
     if (fingerDetected && !sensorManager.isMeasurementInProgress() && 
@@ -107,6 +166,7 @@ void setup() {
       display.setupSensorUI();
       // Start the measurement
       sensorManager.startMeasurement();
+      publishSessionEvent("start");
     } else if (fingerDetected && sensorManager.isMeasurementInProgress()) {
       Serial.println(F("👆 Finger detected but measurement already in progress"));
     } else if (fingerDetected && !wifiManager.isMeasurementActive()) {
@@ -130,19 +190,10 @@ void setup() {
     Serial.println(avgHR);
     Serial.print(F("Final averaged SpO2: "));
     Serial.println(avgSpO2);
+    reportProbeResult(0, avgHR, avgSpO2);
     
-    // Update display with final results
-    display.updateSensorReadings(avgHR, true, avgSpO2, true);
-    
-    // Send final averaged data to server (only if in user mode and logged in)
-    wifiManager.sendSensorData(avgHR, avgSpO2);
-    
-    // IMPORTANT FIX: Stop measurement in WiFiManager too
-    wifiManager.stopMeasurement();
-    Serial.println(F("Stopped measurement in WiFiManager"));
-    
+    // The main loop stops the session once every probe has finished
     Serial.println(F("Measurement cycle complete. Sensor stopped."));
-    Serial.println(F("Press 'Start New Measurement' to measure again."));
   });
   
   // Begin WiFi manager (will set up AP mode)
@@ -160,6 +211,7 @@ void setup() {
 void loop() {
   // Always process WiFi and web server
   wifiManager.loop();
+  tonePlayer.loop();
   
   // Process MQTT if WiFi is connected
   if (WiFi.status() == WL_CONNECTED) {
@@ -196,8 +248,8 @@ void loop() {
       break;
       
     case STATE_MEASURING:
-      // First check if sensor is connected and working
-      if (!sensorManager.checkI2CConnection()) {
+      // First check if the sensors are connected and working
+      if (!sensorScheduler.checkI2CConnection()) {
         // If we're having I2C issues, show a message and wait
         static unsigned long lastErrorMsgTime = 0;
         if (millis() - lastErrorMsgTime > 5000) {  // Show error every 5 seconds
@@ -250,36 +302,46 @@ void loop() {
         display.clearScreen();
         // Setup sensor UI after clearing
         display.setupSensorUI();
-        // Start the measurement
-        sensorManager.startMeasurement();
+      }
+      if (wifiManager.isMeasurementActive()) {
+        // Start (or restart after a timeout) every probe that isn't measuring yet
+        sensorScheduler.resumeMeasurement();
       }
       
-      if (sensorManager.isReady() && wifiManager.isMeasurementActive()) {
+      // The scheduler skips probes that aren't ready, so one missing probe
+      // doesn't stop the others
+      if (sensorScheduler.isReady() && wifiManager.isMeasurementActive()) {
         
-        if (!initialReadingDone) {
+        if (!initialReadingDone && sensorManager.isReady()) {
           display.showMeasuringStatus();
           sensorManager.readSensor();
           initialReadingDone = true;
         }
         
         // Always continue processing readings for continuous measurement
-        // This will keep collecting samples until we have 5 valid readings
-        sensorManager.processReadings();
+        // This will keep collecting samples until we have 5 valid readings.
+        // The scheduler interleaves FIFO reads for all probes without blocking.
+        sensorScheduler.service();
         
-        // Check if measurement just completed
-        if (sensorManager.isMeasurementReady()) {
-          Serial.println(F("✅ Main loop detected measurement completion"));
+        // The session ends once every active probe has its result
+        if (sensorScheduler.isMeasurementComplete()) {
+          Serial.println(F("✅ Main loop detected measurement completion on all probes"));
+          wifiManager.stopMeasurement();
+          publishSessionEvent("end");
+          Serial.println(F("Press 'Start New Measurement' to measure again."));
         }
         
       } else {
         // Reset flag when measurement is not active
         initialReadingDone = false;
         
-        if (wifiManager.isMeasurementActive() && !sensorManager.isReady()) {
-          // If we're supposed to be measuring but sensor isn't ready,
-          // try to reinitialize it
+        if (wifiManager.isMeasurementActive() && !sensorScheduler.isReady()) {
+          // If we're supposed to be measuring but no probe is ready,
+          // try to reinitialize them
           Serial.println(F("⚠️ WiFi measurement active but sensor not ready - reinitializing sensor"));
-          sensorManager.initializeSensor();
+          for (int i = 0; i < sensorScheduler.getProbeCount(); i++) {
+            sensorScheduler.getProbe(i)->initializeSensor();
+          }
           delay(100);
         }
       }
@@ -301,6 +363,13 @@ void initializeSensor() {
   display.setupSensorUI();
   sensorManager.initializeSensor();
   sensorManager.setReady(true);
+#if SENSOR_PROBE_COUNT > 1
+  secondProbe.initializeSensor();
+#endif
+  
+  // One settle period for all probes
+  Serial.println(F("Place finger on sensor. Initializing in 3 seconds..."));
+  delay(SENSOR_SETTLE_MS);
   
   // Start a new measurement cycle when sensor is initialized
   Serial.println(F("Sensor initialized, ready for measurement when finger is detected"));
@@ -328,12 +397,12 @@ void updateConnectionStatus(bool connected, bool guestMode, bool loggedIn) {
     // Connected but not logged in yet
     display.showConnectionSuccess(WiFi.localIP().toString());
     currentState = STATE_LOGIN;
-    sensorManager.setReady(false);
+    sensorScheduler.setReady(false);
   } else {
     // Not connected - show specific error code from WiFiManager
     display.showConnectionFailure(wifiManager.getLastWifiErrorCode());
     currentState = STATE_SETUP;
-    sensorManager.setReady(false);
+    sensorScheduler.setReady(false);
   }
 }
 
@@ -358,3 +427,41 @@ void handleAIAnalysisRequest(String summaryText) {
   display.displayAIHealthSummary(summaryText);
   Serial.println("AI Health Summary displayed");
 }
+
+// Publish a measurement session event over MQTT, tagged with the logged-in user
+void publishSessionEvent(const char* event) {
+  String uid = wifiManager.isUserLoggedIn() && !wifiManager.isInGuestMode() ? wifiManager.getUserUID() : String();
+  mqttManager.publishSession(event, uid.c_str());
+}
+
+// A probe's final result goes to the display, the event stream, the upload
+// queue (one record per probe) and MQTT, tagged with the probe index
+void reportProbeResult(int probe, int32_t avgHR, int32_t avgSpO2) {
+  if (probe == 0) {
+    display.updateSensorReadings(avgHR, true, avgSpO2, true);
+  } else {
+    display.showProbeReadings(probe, avgHR, true, avgSpO2, true);
+  }
+  wifiManager.publishMeasurementComplete(avgHR, avgSpO2, probe);
+  
+  // Send final averaged data to server (only if in user mode and logged in)
+  wifiManager.sendSensorData(avgHR, avgSpO2);
+  
+  // Low-latency copy for MQTT subscribers; the upload queue stays the record of truth
+  String uid = wifiManager.isUserLoggedIn() && !wifiManager.isInGuestMode() ? wifiManager.getUserUID() : String();
+  mqttManager.publishResult(avgHR, avgSpO2, uid.c_str(), probe);
+}
+
+// Start a measurement on every probe (web interface and remote command)
+void startNewMeasurement() {
+  Serial.println(F("Starting new measurement..."));
+  if (sensorScheduler.isReady()) {
+    // Clear screen first
+    display.clearScreen();
+    // Setup sensor UI after clearing
+    display.setupSensorUI();
+    // Start the measurement on every probe
+    sensorScheduler.startMeasurement();
+    publishSessionEvent("start");
+  }
+}
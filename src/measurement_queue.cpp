@@ -0,0 +1,201 @@
+#include "measurement_queue.h"
+#include <LittleFS.h>
+#include <Preferences.h>
+
+#define RECORD_SIZE sizeof(QueuedMeasurement)
+#define CRC_LENGTH offsetof(QueuedMeasurement, crc)
+
+static_assert(sizeof(QueuedMeasurement) == 64, "The ring file layout depends on 64-byte records");
+
+MeasurementQueue::MeasurementQueue() :
+    ready(false),
+    lock(nullptr),
+    nextSequence(1),
+    ackedSequence(0),
+    dropped(0) {
+}
+
+bool MeasurementQueue::begin() {
+    if (lock == nullptr) {
+        lock = xSemaphoreCreateMutex();
+    }
+
+    if (!LittleFS.begin(true)) {
+        Serial.println(F("❌ LittleFS mount failed, offline measurements will not be kept"));
+        return false;
+    }
+
+    // Preallocate the whole ring once so appends only ever overwrite a slot
+    size_t size = 0;
+    if (LittleFS.exists(MEASUREMENT_QUEUE_FILE)) {
+        File file = LittleFS.open(MEASUREMENT_QUEUE_FILE, "r");
+        size = file.size();
+        file.close();
+    }
+    if (size < MEASUREMENT_QUEUE_CAPACITY * RECORD_SIZE) {
+        File file = LittleFS.open(MEASUREMENT_QUEUE_FILE, "a");
+        QueuedMeasurement empty;
+        memset(&empty, 0, RECORD_SIZE);
+        for (; size < MEASUREMENT_QUEUE_CAPACITY * RECORD_SIZE; size += RECORD_SIZE) {
+            file.write((const uint8_t*)&empty, RECORD_SIZE);
+        }
+        file.close();
+    }
+
+    recover();
+    ready = true;
+
+    Serial.print(F("📦 Measurement queue: "));
+    Serial.print(pending());
+    Serial.print(F(" pending, next sequence "));
+    Serial.println(nextSequence);
+    return true;
+}
+
+void MeasurementQueue::recover() {
+    Preferences prefs;
+    prefs.begin(MEASUREMENT_QUEUE_NVS, true);
+    ackedSequence = prefs.getUInt("acked", 0);
+    prefs.end();
+
+    // The tail is the highest intact record; torn writes fail their CRC
+    uint32_t highest = 0;
+    File file = LittleFS.open(MEASUREMENT_QUEUE_FILE, "r");
+    QueuedMeasurement record;
+    for (uint32_t slot = 0; slot < MEASUREMENT_QUEUE_CAPACITY; slot++) {
+        if (file.read((uint8_t*)&record, RECORD_SIZE) != RECORD_SIZE) {
+            break;
+        }
+        if (record.sequence != 0 &&
+            record.sequence % MEASUREMENT_QUEUE_CAPACITY == slot &&
+            record.crc == crc32((const uint8_t*)&record, CRC_LENGTH) &&
+            record.sequence > highest) {
+            highest = record.sequence;
+        }
+    }
+    file.close();
+
+    nextSequence = (highest > ackedSequence ? highest : ackedSequence) + 1;
+    if (nextSequence - 1 - ackedSequence > MEASUREMENT_QUEUE_CAPACITY) {
+        ackedSequence = nextSequence - 1 - MEASUREMENT_QUEUE_CAPACITY;
+    }
+}
+
+uint32_t MeasurementQueue::append(int32_t heartRate, int32_t spo2, const String& userId) {
+    if (!ready) {
+        return 0;
+    }
+
+    QueuedMeasurement record;
+    memset(&record, 0, RECORD_SIZE);
+    record.heartRate = heartRate;
+    record.spo2 = spo2;
+    strncpy(record.userId, userId.c_str(), MEASUREMENT_QUEUE_USER_ID_SIZE - 1);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    record.sequence = nextSequence;
+    record.crc = crc32((const uint8_t*)&record, CRC_LENGTH);
+
+    // Full: the slot still holds the oldest unsent record, give it up
+    if (nextSequence - ackedSequence > MEASUREMENT_QUEUE_CAPACITY) {
+        ackedSequence = nextSequence - MEASUREMENT_QUEUE_CAPACITY;
+        dropped++;
+        saveAcked();
+    }
+
+    File file = LittleFS.open(MEASUREMENT_QUEUE_FILE, "r+");
+    bool written = file &&
+                   file.seek((record.sequence % MEASUREMENT_QUEUE_CAPACITY) * RECORD_SIZE) &&
+                   file.write((const uint8_t*)&record, RECORD_SIZE) == RECORD_SIZE;
+    file.close();
+
+    if (written) {
+        nextSequence++;
+    }
+    xSemaphoreGive(lock);
+
+    if (!written) {
+        Serial.println(F("❌ Could not write measurement to the queue"));
+        return 0;
+    }
+    return record.sequence;
+}
+
+int MeasurementQueue::peek(QueuedMeasurement* records, int maxCount) {
+    if (!ready) {
+        return 0;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    File file = LittleFS.open(MEASUREMENT_QUEUE_FILE, "r");
+    int count = 0;
+    uint32_t sequence = ackedSequence + 1;
+    while (file && count < maxCount && sequence < nextSequence) {
+        if (readSlot(file, sequence, records[count])) {
+            count++;
+        } else if (count > 0) {
+            break; // Skipped once it reaches the head
+        } else {
+            // A damaged slot must not stall everything queued behind it
+            Serial.print(F("⚠️ Skipping unreadable queued measurement #"));
+            Serial.println(sequence);
+            ackedSequence = sequence;
+            dropped++;
+            saveAcked();
+        }
+        sequence++;
+    }
+    file.close();
+    xSemaphoreGive(lock);
+    return count;
+}
+
+void MeasurementQueue::ack(uint32_t sequence) {
+    if (!ready) {
+        return;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (sequence > ackedSequence && sequence < nextSequence) {
+        ackedSequence = sequence;
+        saveAcked();
+    }
+    xSemaphoreGive(lock);
+}
+
+uint32_t MeasurementQueue::pending() {
+    if (!ready) {
+        return 0;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    uint32_t count = nextSequence - 1 - ackedSequence;
+    xSemaphoreGive(lock);
+    return count;
+}
+
+bool MeasurementQueue::readSlot(File& file, uint32_t sequence, QueuedMeasurement& record) {
+    bool ok = file.seek((sequence % MEASUREMENT_QUEUE_CAPACITY) * RECORD_SIZE) &&
+              file.read((uint8_t*)&record, RECORD_SIZE) == RECORD_SIZE;
+
+    return ok && record.sequence == sequence &&
+           record.crc == crc32((const uint8_t*)&record, CRC_LENGTH);
+}
+
+void MeasurementQueue::saveAcked() {
+    Preferences prefs;
+    prefs.begin(MEASUREMENT_QUEUE_NVS, false);
+    prefs.putUInt("acked", ackedSequence);
+    prefs.end();
+}
+
+uint32_t MeasurementQueue::crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
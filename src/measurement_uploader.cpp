@@ -0,0 +1,174 @@
+#include "measurement_uploader.h"
+#include "common_types.h"
+#include "utils.h"
+
+MeasurementUploader::MeasurementUploader(UplinkClient& uplink, MeasurementQueue& queue) :
+    uplink(uplink),
+    queue(queue),
+    batchSupported(true),
+    windowOpen(false),
+    windowStart(0),
+    batchCount(0),
+    requests(0),
+    uploaded(0),
+    bytes(0) {
+}
+
+void MeasurementUploader::noteQueued() {
+    if (!windowOpen) {
+        windowStart = millis();
+        windowOpen = true;
+    }
+}
+
+bool MeasurementUploader::isDue(uint32_t pending) const {
+    if (pending == 0) {
+        return false;
+    }
+    return pending >= UPLOAD_BATCH_MAX || !windowOpen || millis() - windowStart >= UPLOAD_BATCH_WINDOW_MS;
+}
+
+int MeasurementUploader::freezeBatch() {
+    // A batch that failed is retried as is, as long as the queue head hasn't moved
+    if (batchCount > 0 && batch[0].sequence == queue.getAckedSequence() + 1) {
+        return batchCount;
+    }
+    
+    int count = queue.peek(batch, UPLOAD_BATCH_MAX);
+    
+    // X-User-Id is per request, so a batch stops where the user changes
+    for (int i = 1; i < count; i++) {
+        if (strcmp(batch[i].userId, batch[0].userId) != 0) {
+            count = i;
+            break;
+        }
+    }
+    batchCount = count;
+    return count;
+}
+
+int MeasurementUploader::uploadBatch() {
+    int count = freezeBatch();
+    if (count == 0) {
+        windowOpen = false;
+        return 0;
+    }
+
+    bool success = false;
+    if (batchSupported) {
+        success = postBatch(count);
+    }
+    if (!batchSupported) {
+        // Fallback: one request per record, acknowledged as it goes through.
+        // Each record keeps its own key, so the batch needn't stay frozen.
+        batchCount = 0;
+        for (int i = 0; i < count; i++) {
+            if (!postSingle(batch[i])) {
+                return -1;
+            }
+            queue.ack(batch[i].sequence);
+            uploaded++;
+        }
+        success = true;
+    } else if (success) {
+        queue.ack(batch[count - 1].sequence);
+        uploaded += count;
+        batchCount = 0;
+    }
+
+    if (!success) {
+        return -1;
+    }
+    if (queue.pending() == 0) {
+        windowOpen = false;
+    }
+    return count;
+}
+
+int MeasurementUploader::buildBody(int count) {
+    int length = snprintf(body, sizeof(body), "{\"records\":[");
+    for (int i = 0; i < count && length < (int)sizeof(body); i++) {
+        length += snprintf(body + length, sizeof(body) - length,
+                           "%s{\"id\":\"%s-%lu\",\"heart_rate\":%ld,\"spo2\":%ld}",
+                           i > 0 ? "," : "", getDeviceUid(), (unsigned long)batch[i].sequence,
+                           (long)batch[i].heartRate, (long)abs(batch[i].spo2));
+    }
+    if (length < (int)sizeof(body)) {
+        length += snprintf(body + length, sizeof(body) - length, "]}");
+    }
+    return length < (int)sizeof(body) ? length : -1;
+}
+
+bool MeasurementUploader::postBatch(int count) {
+    int length = buildBody(count);
+    if (length < 0) {
+        Serial.println(F("❌ Upload batch exceeds UPLOAD_BODY_SIZE"));
+        return false;
+    }
+
+    char idempotencyKey[56];
+    snprintf(idempotencyKey, sizeof(idempotencyKey), "%s-%lu-%lu", getDeviceUid(),
+             (unsigned long)batch[0].sequence, (unsigned long)batch[count - 1].sequence);
+
+    UplinkHeader headers[] = {
+        {"Content-Type", "application/json"},
+        {"X-Device-Id", DEVICE_ID},
+        {"X-Device-Secret", DEVICE_SECRET},
+        {"Idempotency-Key", idempotencyKey},
+        {"X-User-Id", batch[0].userId}
+    };
+    int headerCount = batch[0].userId[0] != '\0' ? 5 : 4;
+
+    Serial.print(F("📤 Uploading "));
+    Serial.print(count);
+    Serial.print(F(" measurements ("));
+    Serial.print(length);
+    Serial.println(F(" bytes)"));
+
+    int code = uplink.request("POST", UPLOAD_BATCH_PATH, String(body), headers, headerCount, UPLOAD_TIMEOUT_MS);
+    requests++;
+    bytes += length;
+
+    if (code == 404 || code == 405) {
+        Serial.println(F("ℹ️ Server has no batch endpoint, uploading records one by one"));
+        batchSupported = false;
+        return false;
+    }
+    if (code < 200 || code >= 300) {
+        Serial.print(F("❌ Batch upload failed: "));
+        Serial.println(code);
+        return false;
+    }
+    return true;
+}
+
+bool MeasurementUploader::postSingle(const QueuedMeasurement& record) {
+    // The record id doubles as the Idempotency-Key
+    char idempotencyKey[40];
+    snprintf(idempotencyKey, sizeof(idempotencyKey), "%s-%lu", getDeviceUid(), (unsigned long)record.sequence);
+
+    int length = snprintf(body, sizeof(body), "{\"id\":\"%s\",\"heart_rate\":%ld,\"spo2\":%ld}",
+                          idempotencyKey, (long)record.heartRate, (long)abs(record.spo2));
+
+    UplinkHeader headers[] = {
+        {"Content-Type", "application/json"},
+        {"X-Device-Id", DEVICE_ID},
+        {"X-Device-Secret", DEVICE_SECRET},
+        {"Idempotency-Key", idempotencyKey},
+        {"X-User-Id", record.userId}
+    };
+    int headerCount = record.userId[0] != '\0' ? 5 : 4;
+
+    int code = uplink.request("POST", UPLOAD_SINGLE_PATH, String(body), headers, headerCount, UPLOAD_TIMEOUT_MS);
+    requests++;
+    bytes += length;
+
+    if (code < 200 || code >= 300) {
+        Serial.print(F("❌ Measurement #"));
+        Serial.print(record.sequence);
+        Serial.print(F(" upload failed: "));
+        Serial.println(code);
+        return false;
+    }
+    return true;
+}
@@ -1,6 +1,9 @@
 #include "mqtt_manager.h"
 #include "utils.h"
 #include "pitches.h"
+#include "msgpack_writer.h"
+#include "tone_player.h"
+#include <WiFi.h>
 
 // Root CA certificate for HiveMQ Cloud
 // This is the DigiCert Global Root CA used by HiveMQ Cloud
@@ -30,14 +33,34 @@ const char* root_ca = \
 
 // Notification melody (simple short melody for the buzzer)
 // Higher and clearer notes for better notification alert
-const int notification_melody[] = {
+const Melody notification_melody = MELODY(
     NOTE_C6, NOTE_E6, NOTE_G6, NOTE_C7,
     NOTE_G6, NOTE_E6, NOTE_C6, REST,
     NOTE_E6, NOTE_G6, NOTE_C7, REST,
     NOTE_G6, NOTE_E6, NOTE_C6, REST
+);
+
+// Melodies the alert command can play
+struct AlertMelody {
+    const char* name;
+    const Melody* melody;
+    int tempoDivisor;
+};
+
+static const AlertMelody alertMelodies[] = {
+    {"notification", &notification_melody, 4},
+    {"win",          &win_melody,          25},
+    {"lose",         &lose_melody,         25}
 };
 
-const int notification_melody_len = sizeof(notification_melody) / sizeof(notification_melody[0]);
+const MQTTManager::Command MQTTManager::commands[] = {
+    {"alert",  &MQTTManager::commandAlert},  // {"melody": "notification" | "win" | "lose"}
+    {"config", &MQTTManager::commandConfig}, // {"heartbeat_s": 10..3600, "notifications": true | false}
+    {"start",  &MQTTManager::commandStart},
+    {"status", &MQTTManager::commandStatus}, // Answered on .../status
+    {"stop",   &MQTTManager::commandStop},
+    {"upload", &MQTTManager::commandUpload}  // Upload the measurement queue without waiting for a full batch
+};
 
 // Static pointer to the current instance for use in callback
 static MQTTManager* currentInstance = nullptr;
@@ -49,11 +72,18 @@ void MQTTManager::messageCallbackWrapper(char* topic, byte* payload, unsigned in
     }
 }
 
-MQTTManager::MQTTManager(int buzzer_pin) : 
+MQTTManager::MQTTManager(int buzzer_pin, TonePlayer& tones) : 
     connected(false), 
     lastReconnectAttempt(0),
     buzzerPin(buzzer_pin),
-    isMeasuringCallback(nullptr)
+    tonePlayer(tones),
+    lastHeartbeat(0),
+    heartbeatInterval(MQTT_HEARTBEAT_INTERVAL_MS),
+    notificationsEnabled(true),
+    isMeasuringCallback(nullptr),
+    startMeasurementCallback(nullptr),
+    stopMeasurementCallback(nullptr),
+    uploadCallback(nullptr)
 {
     // Create the MQTT client with the secure WiFi client
     mqttClient = new PubSubClient(wifiClient);
@@ -61,8 +91,8 @@ MQTTManager::MQTTManager(int buzzer_pin) :
     // Store instance for callback
     currentInstance = this;
     
-    // Get device ID
-    deviceId = DEVICE_ID;
+    // Per-unit id for the client id and topics; DEVICE_ID is shared by every unit
+    deviceId = getDeviceUid();
     
     // Log buzzer pin for debugging
     Serial.print("MQTT Manager initialized with buzzer pin: ");
@@ -117,6 +147,11 @@ void MQTTManager::loop() {
     } else {
         // Process incoming MQTT messages
         mqttClient->loop();
+        
+        if (lastHeartbeat == 0 || millis() - lastHeartbeat >= heartbeatInterval) {
+            lastHeartbeat = millis();
+            publishStatus("heartbeat");
+        }
     }
 }
 
@@ -153,9 +188,10 @@ bool MQTTManager::subscribe() {
         return false;
     }
     
-    // Subscribe to the device-specific topic with QoS level 1
-    String topic = deviceId;
-    bool success = mqttClient->subscribe(topic.c_str(), MQTT_QOS_LEVEL);
+    // Legacy notification topic, shared by every unit on purpose: the backend
+    // broadcasts notifications there without knowing individual devices
+    const char* topic = DEVICE_ID;
+    bool success = mqttClient->subscribe(topic, MQTT_QOS_LEVEL);
     
     if (success) {
         Serial.print("Subscribed to topic: ");
@@ -165,6 +201,18 @@ bool MQTTManager::subscribe() {
         Serial.println(topic);
     }
     
+    // Remote commands, one subtopic per command
+    char commandTopic[MQTT_TOPIC_SIZE];
+    snprintf(commandTopic, sizeof(commandTopic), MQTT_TOPIC_PREFIX "%s/cmd/+", deviceId.c_str());
+    if (mqttClient->subscribe(commandTopic, MQTT_QOS_LEVEL)) {
+        Serial.print("Subscribed to topic: ");
+        Serial.println(commandTopic);
+    } else {
+        Serial.print("Failed to subscribe to topic: ");
+        Serial.println(commandTopic);
+        success = false;
+    }
+    
     return success;
 }
 
@@ -188,16 +236,129 @@ bool MQTTManager::publish(const char* topic, const char* message) {
     return success;
 }
 
+bool MQTTManager::publishResult(int32_t heartRate, int32_t spo2, const char* userId, int probe) {
+    MsgPackWriter writer(payload, sizeof(payload));
+    writer.beginMap(5);
+    writer.writeString("probe");
+    writer.writeInt(probe);
+    writer.writeString("hr");
+    writer.writeInt(heartRate);
+    writer.writeString("spo2");
+    writer.writeInt(spo2);
+    writer.writeString("user");
+    if (userId[0] != '\0') {
+        writer.writeString(userId);
+    } else {
+        writer.writeNil();
+    }
+    writer.writeString("t");
+    writer.writeUInt(millis() / 1000);
+    
+    if (writer.hasOverflowed()) {
+        Serial.println(F("❌ MQTT result exceeds MQTT_PAYLOAD_SIZE"));
+        return false;
+    }
+    return publishBinary("result", writer.getLength(), false);
+}
+
+bool MQTTManager::publishSession(const char* event, const char* userId) {
+    MsgPackWriter writer(payload, sizeof(payload));
+    writer.beginMap(3);
+    writer.writeString("ev");
+    writer.writeString(event);
+    writer.writeString("user");
+    if (userId[0] != '\0') {
+        writer.writeString(userId);
+    } else {
+        writer.writeNil();
+    }
+    writer.writeString("t");
+    writer.writeUInt(millis() / 1000);
+    
+    if (writer.hasOverflowed()) {
+        Serial.println(F("❌ MQTT session event exceeds MQTT_PAYLOAD_SIZE"));
+        return false;
+    }
+    // Retained, so a subscriber learns whether a measurement is running
+    return publishBinary("session", writer.getLength(), true);
+}
+
+bool MQTTManager::publishStatus(const char* kind) {
+    MsgPackWriter writer(payload, sizeof(payload));
+    writer.beginMap(4);
+    writer.writeString("up");
+    writer.writeUInt(millis() / 1000);
+    writer.writeString("heap");
+    writer.writeUInt(ESP.getFreeHeap());
+    writer.writeString("rssi");
+    writer.writeInt(WiFi.RSSI());
+    writer.writeString("measuring");
+    writer.writeBool(isMeasuringCallback != nullptr && isMeasuringCallback());
+    
+    return publishBinary(kind, writer.getLength(), false);
+}
+
+void MQTTManager::publishAck(const char* command, const char* id, bool ok, const char* error) {
+    MsgPackWriter writer(payload, sizeof(payload));
+    writer.beginMap(ok ? 3 : 4);
+    writer.writeString("cmd");
+    writer.writeString(command);
+    writer.writeString("id");
+    if (id[0] != '\0') {
+        writer.writeString(id);
+    } else {
+        writer.writeNil();
+    }
+    writer.writeString("ok");
+    writer.writeBool(ok);
+    if (!ok) {
+        writer.writeString("error");
+        writer.writeString(error);
+    }
+    
+    if (!writer.hasOverflowed()) {
+        publishBinary("ack", writer.getLength(), false);
+    }
+}
+
+bool MQTTManager::publishBinary(const char* kind, size_t length, bool retained) {
+    if (!mqttClient->connected()) {
+        return false;
+    }
+    
+    char topic[MQTT_TOPIC_SIZE];
+    snprintf(topic, sizeof(topic), MQTT_TOPIC_PREFIX "%s/%s", deviceId.c_str(), kind);
+    
+    bool success = mqttClient->publish(topic, payload, length, retained);
+    if (!success) {
+        Serial.print(F("Failed to publish to topic: "));
+        Serial.println(topic);
+    }
+    return success;
+}
+
 void MQTTManager::handleMessage(char* topic, byte* payload, unsigned int length) {
-    // Convert payload to null-terminated string
-    char* message = new char[length + 1];
-    memcpy(message, payload, length);
-    message[length] = '\0';
+    // Commands: MQTT_TOPIC_PREFIX<device id>/cmd/<command>
+    size_t prefixLength = strlen(MQTT_TOPIC_PREFIX);
+    size_t idLength = deviceId.length();
+    if (strncmp(topic, MQTT_TOPIC_PREFIX, prefixLength) == 0 &&
+        strncmp(topic + prefixLength, deviceId.c_str(), idLength) == 0 &&
+        strncmp(topic + prefixLength + idLength, "/cmd/", 5) == 0) {
+        handleCommand(topic + prefixLength + idLength + 5, payload, length);
+        return;
+    }
     
+    // Anything else is on the legacy notification topic
     Serial.print("Message arrived [");
     Serial.print(topic);
     Serial.print("]: ");
-    Serial.println(message);
+    Serial.write(payload, length);
+    Serial.println();
+    
+    if (!notificationsEnabled) {
+        Serial.println("Notifications disabled - skipping notification");
+        return;
+    }
     
     // Check if the device is currently measuring
     bool isMeasuring = false;
@@ -215,24 +376,150 @@ void MQTTManager::handleMessage(char* topic, byte* payload, unsigned int length)
     } else {
         Serial.println("Measurement in progress - skipping notification");
     }
+}
+
+void MQTTManager::handleCommand(const char* command, byte* payload, unsigned int length) {
+    // PubSubClient builds outgoing messages in the buffer this message arrived
+    // in, so copy what the ack needs before a handler can publish anything
+    char name[MQTT_COMMAND_NAME_SIZE];
+    strncpy(name, command, sizeof(name) - 1);
+    name[sizeof(name) - 1] = '\0';
+    char id[MQTT_COMMAND_ID_SIZE] = "";
+    
+    Serial.print(F("📨 MQTT command: "));
+    Serial.println(name);
+    
+    // Arguments are an optional JSON object, parsed in place: the document's
+    // strings point into the payload, which is not copied
+    StaticJsonDocument<MQTT_COMMAND_JSON_CAPACITY> args;
+    if (length > 0) {
+        DeserializationError err = deserializeJson(args, (char*)payload, length);
+        if (err) {
+            publishAck(name, id, false, "invalid_json");
+            return;
+        }
+        const char* requestId = args["id"].as<const char*>();
+        if (requestId != nullptr) {
+            strncpy(id, requestId, sizeof(id) - 1);
+            id[sizeof(id) - 1] = '\0';
+        }
+    }
     
-    // Free the message buffer
-    delete[] message;
+    const char* error = "unknown_command";
+    bool ok = false;
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(commands[i].name, name) == 0) {
+            error = "failed";
+            ok = (this->*commands[i].handler)(args, error);
+            break;
+        }
+    }
+    
+    publishAck(name, id, ok, error);
+}
+
+bool MQTTManager::commandAlert(JsonDocument& args, const char*& error) {
+    const char* melody = args["melody"].as<const char*>();
+    if (melody == nullptr) {
+        melody = "notification";
+    }
+    
+    for (size_t i = 0; i < sizeof(alertMelodies) / sizeof(alertMelodies[0]); i++) {
+        if (strcmp(alertMelodies[i].name, melody) == 0) {
+            // Alerts play even during a measurement
+            tonePlayer.play(*alertMelodies[i].melody, alertMelodies[i].tempoDivisor, TONE_PRIORITY_ALERT);
+            return true;
+        }
+    }
+    error = "unknown_melody";
+    return false;
+}
+
+bool MQTTManager::commandConfig(JsonDocument& args, const char*& error) {
+    bool hasHeartbeat = !args["heartbeat_s"].isNull();
+    bool hasNotifications = !args["notifications"].isNull();
+    if (!hasHeartbeat && !hasNotifications) {
+        error = "no_settings";
+        return false;
+    }
+    
+    // Validate everything before applying anything
+    long heartbeatSeconds = args["heartbeat_s"].as<long>();
+    if (hasHeartbeat && (!args["heartbeat_s"].is<long>() || heartbeatSeconds < 10 || heartbeatSeconds > 3600)) {
+        error = "invalid_heartbeat_s";
+        return false;
+    }
+    if (hasNotifications && !args["notifications"].is<bool>()) {
+        error = "invalid_notifications";
+        return false;
+    }
+    
+    if (hasHeartbeat) {
+        heartbeatInterval = heartbeatSeconds * 1000UL;
+    }
+    if (hasNotifications) {
+        notificationsEnabled = args["notifications"].as<bool>();
+    }
+    return true;
+}
+
+bool MQTTManager::commandStart(JsonDocument& args, const char*& error) {
+    if (startMeasurementCallback == nullptr || !startMeasurementCallback()) {
+        error = "not_ready";
+        return false;
+    }
+    return true;
+}
+
+bool MQTTManager::commandStatus(JsonDocument& args, const char*& error) {
+    if (!publishStatus("status")) {
+        error = "publish_failed";
+        return false;
+    }
+    return true;
+}
+
+bool MQTTManager::commandStop(JsonDocument& args, const char*& error) {
+    if (stopMeasurementCallback == nullptr) {
+        error = "unsupported";
+        return false;
+    }
+    stopMeasurementCallback();
+    return true;
+}
+
+bool MQTTManager::commandUpload(JsonDocument& args, const char*& error) {
+    if (uploadCallback == nullptr || !uploadCallback()) {
+        error = "offline";
+        return false;
+    }
+    return true;
 }
 
 void MQTTManager::setIsMeasuringCallback(bool (*callback)()) {
     isMeasuringCallback = callback;
 }
 
+void MQTTManager::setStartMeasurementCallback(bool (*callback)()) {
+    startMeasurementCallback = callback;
+}
+
+void MQTTManager::setStopMeasurementCallback(void (*callback)()) {
+    stopMeasurementCallback = callback;
+}
+
+void MQTTManager::setUploadCallback(bool (*callback)()) {
+    uploadCallback = callback;
+}
+
 void MQTTManager::playNotification() {
-    // Play the notification melody for about 8 seconds
-    // The tempo divisor controls the playback speed - adjust to make it about 8 seconds
+    // Queued on the tone player, which plays it from loop() over the next ~5 seconds
     Serial.print("Playing notification on buzzer pin: ");
     Serial.println(buzzerPin);
     
     // Use a tempo divisor of 4 for clearer, more distinct notes
     // This will make each note last longer and be more noticeable
-    playMelody(buzzerPin, notification_melody, notification_melody_len, 4);
-    
-    Serial.println("Notification melody finished");
+    if (!tonePlayer.play(notification_melody, 4, TONE_PRIORITY_NOTIFICATION)) {
+        Serial.println("Notification melody dropped");
+    }
 }
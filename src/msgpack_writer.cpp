@@ -0,0 +1,103 @@
+#include "msgpack_writer.h"
+
+MsgPackWriter::MsgPackWriter(uint8_t* buffer, size_t size) :
+    buffer(buffer),
+    size(size),
+    length(0),
+    overflowed(false) {
+}
+
+void MsgPackWriter::put(uint8_t b) {
+    if (length < size) {
+        buffer[length++] = b;
+    } else {
+        overflowed = true;
+    }
+}
+
+void MsgPackWriter::putBigEndian(uint32_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        put((uint8_t)(value >> shift));
+    }
+}
+
+void MsgPackWriter::beginMap(uint16_t count) {
+    if (count < 16) {
+        put(0x80 | count);              // fixmap
+    } else {
+        put(0xDE);                      // map 16
+        putBigEndian(count, 2);
+    }
+}
+
+void MsgPackWriter::beginArray(uint16_t count) {
+    if (count < 16) {
+        put(0x90 | count);              // fixarray
+    } else {
+        put(0xDC);                      // array 16
+        putBigEndian(count, 2);
+    }
+}
+
+void MsgPackWriter::writeString(const char* value) {
+    writeRaw(value, strlen(value));
+}
+
+void MsgPackWriter::writeRaw(const char* data, size_t count) {
+    if (count < 32) {
+        put(0xA0 | count);              // fixstr
+    } else if (count <= 0xFF) {
+        put(0xD9);                      // str 8
+        put(count);
+    } else {
+        put(0xDA);                      // str 16
+        putBigEndian(count, 2);
+    }
+
+    if (length + count > size) {
+        overflowed = true;
+        return;
+    }
+    memcpy(buffer + length, data, count);
+    length += count;
+}
+
+void MsgPackWriter::writeInt(int32_t value) {
+    if (value >= 0) {
+        writeUInt(value);
+    } else if (value >= -32) {
+        put((uint8_t)value);            // negative fixint
+    } else if (value >= -128) {
+        put(0xD0);                      // int 8
+        put((uint8_t)value);
+    } else if (value >= -32768) {
+        put(0xD1);                      // int 16
+        putBigEndian((uint32_t)value, 2);
+    } else {
+        put(0xD2);                      // int 32
+        putBigEndian((uint32_t)value, 4);
+    }
+}
+
+void MsgPackWriter::writeUInt(uint32_t value) {
+    if (value < 0x80) {
+        put(value);                     // positive fixint
+    } else if (value <= 0xFF) {
+        put(0xCC);                      // uint 8
+        put(value);
+    } else if (value <= 0xFFFF) {
+        put(0xCD);                      // uint 16
+        putBigEndian(value, 2);
+    } else {
+        put(0xCE);                      // uint 32
+        putBigEndian(value, 4);
+    }
+}
+
+void MsgPackWriter::writeBool(bool value) {
+    put(value ? 0xC3 : 0xC2);
+}
+
+void MsgPackWriter::writeNil() {
+    put(0xC0);
+}
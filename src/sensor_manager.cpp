@@ -1,30 +1,67 @@
 #include "sensor_manager.h"
 #include "display_manager.h" // Include the DisplayManager header
 
+// Upper bounds of the jitter histogram buckets, in percent of the raw sample period
+static const uint32_t JITTER_BUCKET_LIMITS_PCT[JITTER_BUCKET_COUNT - 1] = {1, 5, 10, 25, 50};
+
+static int jitterBucket(uint32_t deviation, uint32_t periodUs) {
+    int bucket = 0;
+    while (bucket < JITTER_BUCKET_COUNT - 1 &&
+           (uint64_t)deviation * 100 >= (uint64_t)JITTER_BUCKET_LIMITS_PCT[bucket] * periodUs) {
+        bucket++;
+    }
+    return bucket;
+}
+
 SensorManager::SensorManager(int bufferSize) : 
     bufferLength(bufferSize),
     spo2(0),
     validSPO2(0),
     heartRate(0),
     validHeartRate(0),
+    greenHeartRate(0),
+    multiLedMode(SENSOR_USE_GREEN_LED),
+    multiLedActive(false),
     sensorReady(false),
     lastI2CErrorTime(0),
     i2cErrorCount(0),
     sda_pin(0),
     scl_pin(0),
+    wire(&Wire),
+    hopFill(0),
     validReadingCount(0),
     isMeasuring(false),
     averagedHR(0),
     averagedSpO2(0),
     measurementComplete(false),
     measurementStartTime(0),
+    acquisitionMode(SENSOR_ACQUISITION_MODE),
+    decimatedHead(0),
+    decimatedCount(0),
+    rawSamplePeriodUs(SAMPLE_PERIOD_US),
+    rawStreamStarted(false),
+    nextRawTime(0),
+    lastRawRed(0),
+    lastRawIR(0),
+    lastRawGreen(0),
+    sampleStreamStarted(false),
+    lastSampleTime(0),
+    samplesUntilClean(0),
     updateReadingsCallback(nullptr),
     updateFingerStatusCallback(nullptr),
-    measurementCompleteCallback(nullptr) {
+    measurementCompleteCallback(nullptr),
+    hopCallback(nullptr) {
     
     particleSensor = new MAX30105();
     irBuffer = new uint32_t[bufferSize];
     redBuffer = new uint32_t[bufferSize];
+    greenBuffer = new uint32_t[bufferSize];
+    timeBuffer = new uint32_t[bufferSize];
+    for (int i = 0; i < bufferSize; i++) {
+        timeBuffer[i] = 0;
+    }
+    
+    resetDiagnostics();
     
     // Initialize valid readings array
     for (int i = 0; i < REQUIRED_VALID_READINGS; i++) {
@@ -37,12 +74,15 @@ SensorManager::~SensorManager() {
     delete particleSensor;
     delete[] irBuffer;
     delete[] redBuffer;
+    delete[] greenBuffer;
+    delete[] timeBuffer;
 }
 
-void SensorManager::begin(int sda_pin, int scl_pin) {
+void SensorManager::begin(int sda_pin, int scl_pin, TwoWire& bus) {
     this->sda_pin = sda_pin;
     this->scl_pin = scl_pin;
-    Wire.begin(sda_pin, scl_pin);
+    wire = &bus;
+    wire->begin(sda_pin, scl_pin);
     sensorReady = false;
     lastI2CErrorTime = millis();
     i2cErrorCount = 0;
@@ -50,7 +90,7 @@ void SensorManager::begin(int sda_pin, int scl_pin) {
 
 void SensorManager::initializeSensor() {
     // Initialize sensor 
-    if (!particleSensor->begin(Wire, I2C_SPEED_FAST)) // Use default I2C port, 400kHz speed
+    if (!particleSensor->begin(*wire, I2C_SPEED_FAST)) // Use this sensor's I2C port, 400kHz speed
     {
         Serial.println(F("MAX30105 was not found. Please check wiring/power."));
         sensorReady = false;
@@ -59,29 +99,20 @@ void SensorManager::initializeSensor() {
 
     Serial.println(F("Configuring sensor for optimal readings..."));
     
-    // Use SparkFun example settings exactly
-    byte ledBrightness = 60;    // SparkFun example value
-    byte sampleAverage = 4;     // SparkFun example value  
-    byte ledMode = 2;           // SparkFun example: RED + IR
-    byte sampleRate = 100;      // SparkFun example value
-    int pulseWidth = 411;       // SparkFun example value
-    int adcRange = 4096;        // SparkFun example value
-    
-    // Configure sensor with SparkFun example settings
-    particleSensor->setup(ledBrightness, sampleAverage, ledMode, sampleRate, pulseWidth, adcRange);
+    configureSensor();
     
     Serial.println(F("Sensor configured for optimal readings."));
-    Serial.println(F("Place finger on sensor. Initializing in 3 seconds..."));
-    
-    // Allow time for setup
-    delay(3000);
     
+    // No settle time here: the caller gives the user time to place a finger,
+    // once for all probes
     Serial.println(F("Sensor initialized."));
     
     // Clear buffers before starting
     for (int i = 0; i < bufferLength; i++) {
         redBuffer[i] = 0;
         irBuffer[i] = 0;
+        greenBuffer[i] = 0;
+        timeBuffer[i] = 0;
     }
     
     sensorReady = true;
@@ -96,14 +127,15 @@ void SensorManager::readSensor() {
     Serial.println(F("Starting initial sensor reading..."));
     
     // Follow SparkFun example exactly: read the first 100 samples to determine signal range
+    hopFill = 0;
     for (byte i = 0; i < bufferLength; i++) {
-        while (!particleSensor->available()) { // do we have new data?
-            particleSensor->check(); // Check the sensor for new data
+        uint32_t red, ir, green, timestampUs;
+        if (!readNextSample(red, ir, green, timestampUs)) {
+            Serial.println(F("❌ Sensor FIFO stopped delivering samples"));
+            sensorReady = false;
+            return;
         }
-
-        redBuffer[i] = particleSensor->getRed();
-        irBuffer[i] = particleSensor->getIR();
-        particleSensor->nextSample(); // We're finished with this sample so move to next sample
+        storeSample(i, red, ir, green, timestampUs);
 
         Serial.print(F("red="));
         Serial.print(redBuffer[i], DEC);
@@ -112,7 +144,7 @@ void SensorManager::readSensor() {
     }
 
     // Calculate heart rate and SpO2 after first 100 samples (first 4 seconds of samples)
-    maxim_heart_rate_and_oxygen_saturation(irBuffer, bufferLength, redBuffer, &spo2, &validSPO2, &heartRate, &validHeartRate);
+    computeReadings();
     
     // Update the readings via callback
     if (updateReadingsCallback) {
@@ -125,6 +157,391 @@ void SensorManager::readSensor() {
     }
 }
 
+void SensorManager::configureSensor() {
+    // Latch the LED mode: the FIFO layout follows what the sensor was set up
+    // with, not a setMultiLedMode() call made since
+    multiLedActive = multiLedMode;
+    
+    // Use SparkFun example settings exactly
+    byte ledBrightness = 60;    // SparkFun example value
+    byte sampleAverage = 4;     // SparkFun example value  
+    byte ledMode = multiLedActive ? LED_MODE_MULTI : LED_MODE_SPO2; // SparkFun example: RED + IR (+ GREEN)
+    int sampleRate = 100;       // SparkFun example value
+    int pulseWidth = 411;       // SparkFun example value
+    int adcRange = 4096;        // SparkFun example value
+    
+    // In host decimation modes the sensor runs unaveraged at a higher rate and the
+    // FIR decimators bring the stream back down to PROCESSING_RATE_HZ
+    if (acquisitionMode == ACQ_HOST_DECIMATE_400) {
+        sampleAverage = 1;
+        sampleRate = 400;
+        redDecimator.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+        irDecimator.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+        greenDecimator.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+        Serial.println(F("Acquisition: 400Hz raw, host FIR decimation x16"));
+    } else if (acquisitionMode == ACQ_HOST_DECIMATE_800) {
+        sampleAverage = 1;
+        sampleRate = 800;
+        redDecimator.configure(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT, FIR_DECIM32_FACTOR);
+        irDecimator.configure(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT, FIR_DECIM32_FACTOR);
+        greenDecimator.configure(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT, FIR_DECIM32_FACTOR);
+        Serial.println(F("Acquisition: 800Hz raw, host FIR decimation x32"));
+    } else {
+        // Without taps the decimators pass samples straight through
+        redDecimator.configure(nullptr, 0, 1);
+        irDecimator.configure(nullptr, 0, 1);
+        greenDecimator.configure(nullptr, 0, 1);
+        Serial.println(F("Acquisition: 100Hz with on-chip averaging x4"));
+    }
+    rawSamplePeriodUs = (1000000UL * sampleAverage) / sampleRate;
+    
+    // Narrow the pulse until every LED slot fits the sample period, e.g. 215us for
+    // RED + IR at 800Hz and 118us once GREEN takes a third slot
+    pulseWidth = max30105PulseWidthFor(sampleRate, multiLedActive ? 3 : 2, pulseWidth);
+    Serial.print(F("LED pulse width (us): "));
+    Serial.println(pulseWidth);
+    
+    if (multiLedActive) {
+        Serial.println(F("LED mode: RED + IR + GREEN"));
+    }
+    
+    decimatedHead = 0;
+    decimatedCount = 0;
+    
+    hopFill = 0;
+    
+    // setup() also flushes the FIFO, so timing restarts from the next sample
+    rawStreamStarted = false;
+    sampleStreamStarted = false;
+    samplesUntilClean = 0;
+    
+    // setup() soft-resets the part, which also clears PROX_INT_EN
+    proximity.reset();
+    
+    particleSensor->setup(ledBrightness, sampleAverage, ledMode, sampleRate, pulseWidth, adcRange);
+}
+
+bool SensorManager::readNextSample(uint32_t& red, uint32_t& ir, uint32_t& green, uint32_t& timestampUs) {
+    // Keep polling the sensor until a new sample is available, but don't hang the
+    // firmware on a sensor that dropped off the bus
+    unsigned long start = millis();
+    while (!tryReadSample(red, ir, green, timestampUs)) {
+        if (millis() - start > SENSOR_READ_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SensorManager::tryReadSample(uint32_t& red, uint32_t& ir, uint32_t& green, uint32_t& timestampUs) {
+    // Burst-read the FIFO when the queue runs dry. All modes go through drainFifo()
+    // so every sample gets a timestamp and FIFO overflows are noticed.
+    if (decimatedCount == 0) {
+        drainFifo();
+        if (decimatedCount == 0) {
+            return false;
+        }
+    }
+    
+    red = decimatedRed[decimatedHead];
+    ir = decimatedIR[decimatedHead];
+    green = decimatedGreen[decimatedHead];
+    timestampUs = decimatedTime[decimatedHead];
+    decimatedHead = (decimatedHead + 1) % DECIMATED_QUEUE_SIZE;
+    decimatedCount--;
+    return true;
+}
+
+int SensorManager::serviceFifo(int maxSamples) {
+    int moved = 0;
+    
+    while (moved < maxSamples && hopFill < SAMPLE_HOP) {
+        uint32_t red, ir, green, timestampUs;
+        if (!tryReadSample(red, ir, green, timestampUs)) {
+            break;
+        }
+        
+        // Make room for the new hop only once its first sample actually arrives
+        if (hopFill == 0) {
+            shiftWindow();
+        }
+        
+        storeSample(bufferLength - SAMPLE_HOP + hopFill, red, ir, green, timestampUs);
+        hopFill++;
+        moved++;
+    }
+    
+    return moved;
+}
+
+void SensorManager::storeSample(int index, uint32_t red, uint32_t ir, uint32_t green, uint32_t timestampUs) {
+    redBuffer[index] = red;
+    irBuffer[index] = ir;
+    greenBuffer[index] = green;
+    timeBuffer[index] = timestampUs;
+    
+    if (samplesUntilClean > 0) {
+        samplesUntilClean--;
+    }
+    
+    // Timestamps come from the sample clock, so the spacing only grows at a gap;
+    // timing jitter is measured against the host clock in drainFifo()
+    diagnostics.samplesAcquired++;
+    if (sampleStreamStarted) {
+        uint32_t interval = timestampUs - lastSampleTime;
+        if (interval > diagnostics.maxIntervalUs) {
+            diagnostics.maxIntervalUs = interval;
+        }
+    }
+    lastSampleTime = timestampUs;
+    sampleStreamStarted = true;
+}
+
+void SensorManager::shiftWindow() {
+    // Dumping the first 25 sets of samples in the memory and shift the last 75 sets of samples to the top
+    for (int i = SAMPLE_HOP; i < bufferLength; i++) {
+        redBuffer[i - SAMPLE_HOP] = redBuffer[i];
+        irBuffer[i - SAMPLE_HOP] = irBuffer[i];
+        timeBuffer[i - SAMPLE_HOP] = timeBuffer[i];
+    }
+    if (multiLedActive) {
+        for (int i = SAMPLE_HOP; i < bufferLength; i++) {
+            greenBuffer[i - SAMPLE_HOP] = greenBuffer[i];
+        }
+    }
+}
+
+// Read one 18-bit FIFO channel (3 bytes, MSB first) from the pending Wire transfer
+static uint32_t readFifoChannel(TwoWire& bus) {
+    uint32_t value = (uint32_t)bus.read() << 16;
+    value |= (uint32_t)bus.read() << 8;
+    value |= (uint32_t)bus.read();
+    return value & 0x3FFFF;
+}
+
+bool SensorManager::readFifoPointers(FifoPointers& pointers) {
+    // Read all three pointer registers in one transfer on this probe's bus so the
+    // write pointer can't advance between reading it and the read pointer
+    wire->beginTransmission(MAX30105_ADDRESS);
+    wire->write(MAX30105_REG_FIFO_WR_PTR);
+    if (wire->endTransmission(false) != 0) {
+        return false;
+    }
+    if (wire->requestFrom((uint8_t)MAX30105_ADDRESS, (uint8_t)3) != 3) {
+        return false;
+    }
+    pointers.writePtr = wire->read();
+    pointers.overflow = wire->read();
+    pointers.readPtr = wire->read();
+    return true;
+}
+
+void SensorManager::drainFifo() {
+    // The SparkFun driver only keeps a 4-sample ring and has no notion of time, so
+    // read everything waiting in the FIFO ourselves in as few transfers as possible
+    // and timestamp each sample from its position relative to the newest one
+    FifoPointers pointers;
+    if (!readFifoPointers(pointers)) {
+        return;
+    }
+    uint32_t now = micros();
+    
+    int samples = fifoPendingSamples(pointers);
+    if (samples == 0) {
+        return;
+    }
+    uint8_t overflow = pointers.overflow;
+    
+    const uint32_t period = rawSamplePeriodUs;
+    if (!rawStreamStarted) {
+        // Anchor the sample clock on the first read: the newest sample was taken
+        // at most one period before `now`
+        nextRawTime = now - (uint32_t)(samples - 1) * period;
+    }
+    
+    int missing = 0;
+    if (overflow > 0 && rawStreamStarted) {
+        missing = overflow;
+        // The counter saturates, so fall back to the elapsed time for long stalls
+        int32_t behind = (int32_t)(now - nextRawTime);
+        if (overflow == MAX30105_OVF_SATURATED && behind > 0) {
+            int elapsed = (int)(behind / (int32_t)period) + 1 - samples;
+            if (elapsed > missing) {
+                missing = elapsed;
+            }
+        }
+        diagnostics.fifoOverflows++;
+        diagnostics.samplesDropped += missing;
+        Serial.print(F("⚠️ FIFO overflow, samples lost: "));
+        Serial.println(missing);
+    }
+    
+    // Pull the sample clock back in line if the sensor oscillator has drifted
+    // against micros() by more than the one period the model can't resolve
+    int32_t correction = sampleClockCorrection(nextRawTime + (uint32_t)(missing + samples - 1) * period,
+                                               now, period);
+    if (rawStreamStarted) {
+        // How far the host's read time falls outside what the model allows:
+        // the sensor oscillator's drift and jitter against micros()
+        uint32_t deviation = (correction < 0) ? (uint32_t)-correction : (uint32_t)correction;
+        diagnostics.jitterHistogram[jitterBucket(deviation, period)]++;
+        if (correction != 0) {
+            nextRawTime += correction;
+            diagnostics.clockCorrections++;
+        }
+    }
+    uint32_t firstTime = nextRawTime + (uint32_t)missing * period;
+    nextRawTime = firstTime + (uint32_t)samples * period;
+    
+    const int channels = multiLedActive ? 3 : 2; // RED + IR (+ GREEN)
+    const int bytesPerSample = channels * MAX30105_BYTES_PER_LED;
+    int bytesLeft = samples * bytesPerSample;
+    int index = 0;
+    
+    wire->beginTransmission(MAX30105_ADDRESS);
+    wire->write(MAX30105_REG_FIFO_DATA);
+    if (wire->endTransmission() != 0) {
+        abortFifoRead(samples);
+        return;
+    }
+    
+    while (bytesLeft > 0) {
+        // Keep each transfer within the Wire buffer and aligned to whole samples
+        int toGet = bytesLeft;
+        if (toGet > I2C_BUFFER_LENGTH) {
+            toGet = I2C_BUFFER_LENGTH - (I2C_BUFFER_LENGTH % bytesPerSample);
+        }
+        bytesLeft -= toGet;
+        
+        if (wire->requestFrom((uint8_t)MAX30105_ADDRESS, (uint8_t)toGet) != toGet) {
+            abortFifoRead(samples - index);
+            return;
+        }
+        
+        for (; toGet >= bytesPerSample; toGet -= bytesPerSample, index++) {
+            uint32_t red = readFifoChannel(*wire);
+            uint32_t ir = readFifoChannel(*wire);
+            uint32_t green = multiLedActive ? readFifoChannel(*wire) : 0;
+            uint32_t timestampUs = firstTime + (uint32_t)index * period;
+            
+            if (index == 0 && missing > 0 && rawStreamStarted) {
+                if ((uint32_t)missing * period <= GAP_FILL_MAX_US) {
+                    // Short gap: resample linearly between the last good sample and this one
+                    for (int m = 1; m <= missing; m++) {
+                        pushRawSample(lastRawRed + (int32_t)(red - lastRawRed) * m / (missing + 1),
+                                      lastRawIR + (int32_t)(ir - lastRawIR) * m / (missing + 1),
+                                      lastRawGreen + (int32_t)(green - lastRawGreen) * m / (missing + 1),
+                                      timestampUs - (uint32_t)(missing + 1 - m) * period);
+                    }
+                    diagnostics.samplesInterpolated += missing;
+                } else {
+                    // Too long to bridge: HR would be computed over a distorted time base
+                    markGap();
+                }
+            }
+            
+            pushRawSample(red, ir, green, timestampUs);
+        }
+    }
+}
+
+void SensorManager::abortFifoRead(int samplesLost) {
+    // A NACK or bus error mid-read: whatever was received is discarded, and how far
+    // the sensor's read pointer moved is unknown, so the sample clock is re-anchored
+    // on the next read and the window counts as spanning a gap
+    while (wire->available()) {
+        wire->read();
+    }
+    rawStreamStarted = false;
+    diagnostics.samplesDropped += samplesLost;
+    markGap();
+    Serial.print(F("⚠️ FIFO read failed, samples lost: "));
+    Serial.println(samplesLost);
+}
+
+void SensorManager::pushRawSample(uint32_t red, uint32_t ir, uint32_t green, uint32_t timestampUs) {
+    lastRawRed = red;
+    lastRawIR = ir;
+    lastRawGreen = green;
+    rawStreamStarted = true;
+    
+    uint32_t outRed, outIR, outGreen = 0;
+    bool redReady = redDecimator.push(red, outRed);
+    bool irReady = irDecimator.push(ir, outIR);
+    if (multiLedActive) {
+        greenDecimator.push(green, outGreen);
+    }
+    if (!redReady || !irReady) {
+        return;
+    }
+    
+    // If the consumer fell behind, drop the oldest queued sample
+    if (decimatedCount == DECIMATED_QUEUE_SIZE) {
+        decimatedHead = (decimatedHead + 1) % DECIMATED_QUEUE_SIZE;
+        decimatedCount--;
+        diagnostics.samplesDropped += redDecimator.getFactor();
+        markGap();
+    }
+    int tail = (decimatedHead + decimatedCount) % DECIMATED_QUEUE_SIZE;
+    decimatedRed[tail] = outRed;
+    decimatedIR[tail] = outIR;
+    decimatedGreen[tail] = outGreen;
+    decimatedTime[tail] = timestampUs;
+    decimatedCount++;
+}
+
+void SensorManager::markGap() {
+    // Samples still queued predate the gap, so they don't count towards a clean window
+    samplesUntilClean = bufferLength + decimatedCount;
+}
+
+void SensorManager::resetDiagnostics() {
+    diagnostics.samplesAcquired = 0;
+    diagnostics.samplesDropped = 0;
+    diagnostics.fifoOverflows = 0;
+    diagnostics.samplesInterpolated = 0;
+    diagnostics.windowsInvalidated = 0;
+    diagnostics.maxIntervalUs = 0;
+    diagnostics.clockCorrections = 0;
+    for (int i = 0; i < JITTER_BUCKET_COUNT; i++) {
+        diagnostics.jitterHistogram[i] = 0;
+    }
+}
+
+void SensorManager::computeReadings() {
+    maxim_heart_rate_and_oxygen_saturation(irBuffer, bufferLength, redBuffer, &spo2, &validSPO2, &heartRate, &validHeartRate);
+    
+    if (multiLedActive) {
+        fuseGreenHeartRate();
+    }
+}
+
+void SensorManager::fuseGreenHeartRate() {
+    // Run the same peak detector on the green channel. SpO2 needs red/IR, so only
+    // the heart rate from this pass is used. Cost stays one extra O(window) pass.
+    int32_t unusedSpo2;
+    int8_t unusedSpo2Valid;
+    int32_t hrGreen;
+    int8_t hrGreenValid;
+    maxim_heart_rate_and_oxygen_saturation(greenBuffer, bufferLength, redBuffer, &unusedSpo2, &unusedSpo2Valid, &hrGreen, &hrGreenValid);
+    
+    bool greenOk = hrGreenValid && hrGreen >= MIN_VALID_HR && hrGreen <= MAX_VALID_HR;
+    bool irOk = validHeartRate && heartRate >= MIN_VALID_HR && heartRate <= MAX_VALID_HR;
+    greenHeartRate = greenOk ? hrGreen : 0;
+    
+    if (greenOk && irOk) {
+        if (abs(hrGreen - heartRate) <= HR_FUSION_AGREEMENT_BPM) {
+            heartRate = (heartRate + hrGreen) / 2;
+        } else {
+            // Disagreement is usually motion on the IR channel; trust green
+            heartRate = hrGreen;
+        }
+    } else if (greenOk) {
+        heartRate = hrGreen;
+        validHeartRate = 1;
+    }
+}
+
 bool SensorManager::checkI2CConnection() {
     // Record I2C error time for rate limiting resets
     unsigned long currentTime = millis();
@@ -135,9 +552,9 @@ bool SensorManager::checkI2CConnection() {
     }
     
     // Try to read from the sensor's ID register (0xFF)
-    Wire.beginTransmission(0x57); // MAX30105 I2C address
-    Wire.write(0xFF);             // ID register
-    byte error = Wire.endTransmission();
+    wire->beginTransmission(0x57); // MAX30105 I2C address
+    wire->write(0xFF);             // ID register
+    byte error = wire->endTransmission();
     
     // If we get an error, increment the counter
     if (error != 0) {
@@ -164,33 +581,28 @@ void SensorManager::resetSensor() {
     Serial.println(F("Attempting to reset sensor connection..."));
     
     // Reset the I2C connection
-    Wire.end();
+    wire->end();
     delay(100);
-    Wire.begin(sda_pin, scl_pin);
-    Wire.flush();
+    wire->begin(sda_pin, scl_pin);
+    wire->flush();
     delay(100);
     
     // Try to reinitialize the sensor
-    if (!particleSensor->begin(Wire, I2C_SPEED_FAST)) {
+    if (!particleSensor->begin(*wire, I2C_SPEED_FAST)) {
         Serial.println(F("Failed to reinitialize sensor. Will retry later."));
         sensorReady = false;
         return;
     }
     
-    // Reconfigure the sensor with the same settings as SparkFun example
-    byte ledBrightness = 60;    // SparkFun example value
-    byte sampleAverage = 4;     // SparkFun example value  
-    byte ledMode = 2;           // SparkFun example: RED + IR
-    byte sampleRate = 100;      // SparkFun example value
-    int pulseWidth = 411;       // SparkFun example value
-    int adcRange = 4096;        // SparkFun example value
-    
-    particleSensor->setup(ledBrightness, sampleAverage, ledMode, sampleRate, pulseWidth, adcRange);
+    // Reconfigure the sensor with the same settings as before the reset
+    configureSensor();
     
     // Clear the buffers
     for (int i = 0; i < bufferLength; i++) {
         redBuffer[i] = 0;
         irBuffer[i] = 0;
+        greenBuffer[i] = 0;
+        timeBuffer[i] = 0;
     }
     
     Serial.println(F("Sensor reset complete. Ready for measurements."));
@@ -210,21 +622,27 @@ void SensorManager::processReadings() {
         return;
     }
     
-    // Dumping the first 25 sets of samples in the memory and shift the last 75 sets of samples to the top
-    for (byte i = 25; i < 100; i++) {
-        redBuffer[i - 25] = redBuffer[i];
-        irBuffer[i - 25] = irBuffer[i];
+    // While idle, only the proximity flag is checked until a finger arrives
+    if (proximity.isIdle() && !pollProximity()) {
+        return;
     }
-
-    // Take 25 sets of samples before calculating the heart rate.
-    for (byte i = 75; i < 100; i++) {
-        while (!particleSensor->available()) { // do we have new data?
-            particleSensor->check(); // Check the sensor for new data
+    
+    // Take 25 sets of samples before calculating the heart rate. Whatever the FIFO
+    // holds right now is moved in; an incomplete hop is finished on a later call.
+    if (hopFill < SAMPLE_HOP) {
+        serviceFifo(SAMPLE_HOP - hopFill);
+        if (hopFill < SAMPLE_HOP) {
+            return;
         }
-
-        redBuffer[i] = particleSensor->getRed();
-        irBuffer[i] = particleSensor->getIR();
-        particleSensor->nextSample(); // We're finished with this sample so move to next sample
+    }
+    hopFill = 0;
+    
+    int hopStart = bufferLength - SAMPLE_HOP;
+    if (hopCallback) {
+        hopCallback(&redBuffer[hopStart], &irBuffer[hopStart], &timeBuffer[hopStart], SAMPLE_HOP);
+    }
+    
+    for (int i = hopStart; i < bufferLength; i++) {
 
         // Send samples and calculation result to terminal program through UART
         Serial.print(F("red="));
@@ -252,7 +670,7 @@ void SensorManager::processReadings() {
     
     // After gathering 25 new samples recalculate HR and SP02
     int32_t originalSpo2 = spo2;
-    maxim_heart_rate_and_oxygen_saturation(irBuffer, bufferLength, redBuffer, &spo2, &validSPO2, &heartRate, &validHeartRate);
+    computeReadings();
     
     // Debug the SpO2 value
     Serial.print(F("📊 Original SpO2: "));
@@ -276,8 +694,24 @@ void SensorManager::processReadings() {
         validHeartRate = 0;
         validSPO2 = 0;
         Serial.println(F("No finger detected, marking readings as invalid"));
+        
+        // Stop full-rate sampling until the proximity detector sees a finger
+        if (proximity.fingerMissing(*particleSensor, multiLedActive, millis())) {
+            Serial.println(F("💤 No finger - switching sensor to proximity idle mode"));
+        }
         return; // Skip further validation since there's no finger
     }
+    proximity.fingerSeen();
+    
+    // A window spanning a sampling gap has a broken time base, so its HR/SpO2 can't be trusted
+    if (samplesUntilClean > 0) {
+        validHeartRate = 0;
+        validSPO2 = 0;
+        diagnostics.windowsInvalidated++;
+        Serial.print(F("⚠️ Window spans a sampling gap, marking readings as invalid ("));
+        Serial.print(samplesUntilClean);
+        Serial.println(F(" samples until clean)"));
+    }
     
     // Additional validation for extreme HR values
     if (heartRate == -999) {
@@ -426,6 +860,28 @@ void SensorManager::processReadings() {
     }
 }
 
+bool SensorManager::pollProximity() {
+    if (!proximity.poll(*particleSensor, millis())) {
+        return false;
+    }
+    
+    Serial.println(F("👆 Proximity triggered - restoring full SpO2 mode"));
+    
+    // Back to full measurement settings (also disarms PROX_INT)
+    configureSensor();
+    
+    // The old window holds no-finger data; zeroed samples are ignored by
+    // isFingerDetected() and the window refills over the next few passes
+    for (int i = 0; i < bufferLength; i++) {
+        redBuffer[i] = 0;
+        irBuffer[i] = 0;
+        greenBuffer[i] = 0;
+        timeBuffer[i] = 0;
+    }
+    
+    return true;
+}
+
 bool SensorManager::isFingerDetected() const {
     // Check if sensor is ready
     if (!sensorReady) {
@@ -503,6 +959,10 @@ void SensorManager::setMeasurementCompleteCallback(void (*callback)(int32_t avgH
     measurementCompleteCallback = callback;
 }
 
+void SensorManager::setHopCallback(void (*callback)(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count)) {
+    hopCallback = callback;
+}
+
 void SensorManager::startMeasurement() {
     Serial.println(F("🔄 startMeasurement() called"));
     Serial.print(F("Current state - isMeasuring: "));
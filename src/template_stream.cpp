@@ -0,0 +1,128 @@
+#include "template_stream.h"
+
+TemplateStream::TemplateStream(WebServer& server) :
+    server(server),
+    used(0),
+    bytesSent(0) {
+}
+
+void TemplateStream::begin(int code, const char* contentType) {
+    used = 0;
+    bytesSent = 0;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN); // Chunked transfer encoding
+    server.send(code, contentType, "");
+}
+
+void TemplateStream::end() {
+    flush();
+    server.sendContent(""); // Zero-length chunk terminates the response
+}
+
+void TemplateStream::flush() {
+    if (used > 0) {
+        server.sendContent(buffer, used);
+        bytesSent += used;
+        used = 0;
+    }
+}
+
+void TemplateStream::write(const char* data, size_t length) {
+    while (length > 0) {
+        size_t room = TEMPLATE_CHUNK_SIZE - used;
+        size_t count = (length < room) ? length : room;
+        memcpy(buffer + used, data, count);
+        used += count;
+        data += count;
+        length -= count;
+        if (used == TEMPLATE_CHUNK_SIZE) {
+            flush();
+        }
+    }
+}
+
+void TemplateStream::print(const char* text) {
+    write(text, strlen(text));
+}
+
+void TemplateStream::print(int32_t value) {
+    char digits[12];
+    int length = snprintf(digits, sizeof(digits), "%ld", (long)value);
+    write(digits, length);
+}
+
+void TemplateStream::print(const IPAddress& ip) {
+    char text[16];
+    int length = snprintf(text, sizeof(text), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    write(text, length);
+}
+
+void TemplateStream::printEscaped(const char* text) {
+    // For user-supplied strings such as SSIDs and e-mail addresses
+    for (const char* p = text; *p; p++) {
+        switch (*p) {
+            case '<': print("&lt;"); break;
+            case '>': print("&gt;"); break;
+            case '&': print("&amp;"); break;
+            case '\'': print("&#39;"); break;
+            case '"': print("&quot;"); break;
+            default: write(p, 1); break;
+        }
+    }
+}
+
+void TemplateStream::render(const char* tpl, ValueCallback value, SectionCallback section, void* context) {
+    int skipDepth = 0; // Nesting depth inside a section that is switched off
+    const char* p = tpl;
+
+    while (pgm_read_byte(p)) {
+        // Copy literal text up to the next tag in one go
+        const char* start = p;
+        while (pgm_read_byte(p) && !(pgm_read_byte(p) == '{' && pgm_read_byte(p + 1) == '{')) {
+            p++;
+        }
+        if (skipDepth == 0 && p > start) {
+            write(start, p - start);
+        }
+        if (!pgm_read_byte(p)) {
+            break;
+        }
+
+        // Parse {{[#^/]NAME}}
+        p += 2;
+        char kind = pgm_read_byte(p);
+        if (kind == '#' || kind == '^' || kind == '/') {
+            p++;
+        } else {
+            kind = 0;
+        }
+        char name[TEMPLATE_MAX_NAME];
+        int length = 0;
+        while (pgm_read_byte(p) && !(pgm_read_byte(p) == '}' && pgm_read_byte(p + 1) == '}')) {
+            if (length < TEMPLATE_MAX_NAME - 1) {
+                name[length++] = pgm_read_byte(p);
+            }
+            p++;
+        }
+        name[length] = '\0';
+        if (pgm_read_byte(p)) {
+            p += 2;
+        }
+
+        if (kind == '#' || kind == '^') {
+            if (skipDepth > 0) {
+                skipDepth++;
+            } else {
+                bool enabled = section ? section(name, context) : false;
+                if (enabled != (kind == '#')) {
+                    skipDepth = 1;
+                }
+            }
+        } else if (kind == '/') {
+            if (skipDepth > 0) {
+                skipDepth--;
+            }
+        } else if (skipDepth == 0 && value) {
+            value(name, *this, context);
+        }
+    }
+}
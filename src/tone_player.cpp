@@ -0,0 +1,137 @@
+#include "tone_player.h"
+
+TonePlayer::TonePlayer(int ledcChannel) :
+    channel(ledcChannel),
+    queued(0),
+    playing(false),
+    step(0),
+    toneOn(false),
+    stepStart(0),
+    quietCallback(nullptr),
+    preempted(0),
+    dropped(0) {
+}
+
+bool TonePlayer::play(const Melody& melody, int tempoDivisor, TonePriority priority) {
+    if (melody.length == 0 || tempoDivisor <= 0) {
+        return false;
+    }
+    if (isMuted(priority)) {
+        dropped++;
+        return false;
+    }
+
+    // Same timing as the old playMelody(): the tone, then 30% of its length silent
+    Playback entry = {melody.steps, melody.length, (uint16_t)(1000 / tempoDivisor),
+                      (uint16_t)(1000 / tempoDivisor * 1.3), priority};
+
+    if (playing && priority > current.priority) {
+        silence();
+        preempted++;
+        current = entry;
+        step = 0;
+        stepStart = millis();
+        startStep();
+        return true;
+    }
+    if (queued >= TONE_QUEUE_DEPTH) {
+        dropped++;
+        return false;
+    }
+
+    // Insert behind everything of the same or higher priority
+    int pos = queued;
+    while (pos > 0 && queue[pos - 1].priority < priority) {
+        queue[pos] = queue[pos - 1];
+        pos--;
+    }
+    queue[pos] = entry;
+    queued++;
+
+    if (!playing) {
+        startNext();
+    }
+    return true;
+}
+
+void TonePlayer::stop() {
+    queued = 0;
+    if (playing) {
+        silence();
+        playing = false;
+    }
+}
+
+void TonePlayer::loop() {
+    if (!playing) {
+        return;
+    }
+
+    if (isMuted(current.priority)) {
+        silence();
+        playing = false;
+        dropped++;
+        startNext();
+        if (!playing) {
+            return;
+        }
+    }
+
+    unsigned long elapsed = millis() - stepStart;
+    if (toneOn && elapsed >= current.noteMs) {
+        silence();
+    }
+    unsigned long stepMs = (unsigned long)current.steps[step].beats * current.beatMs;
+    if (elapsed >= stepMs) {
+        // Advance from the scheduled start, so a late loop() doesn't stretch the melody
+        stepStart += stepMs;
+        if (++step >= current.length) {
+            playing = false;
+            startNext();
+        } else {
+            startStep();
+        }
+    }
+}
+
+void TonePlayer::setQuietCallback(bool (*callback)()) {
+    quietCallback = callback;
+}
+
+bool TonePlayer::isMuted(TonePriority priority) {
+    return priority < TONE_PRIORITY_ALERT && quietCallback != nullptr && quietCallback();
+}
+
+void TonePlayer::startNext() {
+    while (queued > 0) {
+        Playback next = queue[0];
+        queued--;
+        for (int i = 0; i < queued; i++) {
+            queue[i] = queue[i + 1];
+        }
+
+        if (isMuted(next.priority)) {
+            dropped++;
+            continue;
+        }
+        current = next;
+        playing = true;
+        step = 0;
+        stepStart = millis();
+        startStep();
+        return;
+    }
+}
+
+void TonePlayer::startStep() {
+    uint16_t frequency = MELODY_PITCHES[current.steps[step].pitch];
+    if (frequency != REST) {
+        ledcWriteTone(channel, frequency);
+        toneOn = true;
+    }
+}
+
+void TonePlayer::silence() {
+    ledcWrite(channel, 0);
+    toneOn = false;
+}
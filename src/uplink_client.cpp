@@ -0,0 +1,142 @@
+#include "uplink_client.h"
+
+// Sink for response bodies nobody asked for
+class DiscardStream : public Stream {
+public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t*, size_t length) override { return length; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+static DiscardStream discardBody;
+
+static const char* collectedHeaders[] = {"ETag"};
+
+UplinkClient::UplinkClient() :
+    secure(false),
+    lock(nullptr),
+    open(false),
+    lastUsed(0),
+    requests(0),
+    connections(0),
+    reused(0),
+    idleCloses(0) {
+}
+
+void UplinkClient::begin(const String& serverURL) {
+    baseURL = serverURL;
+    while (baseURL.endsWith("/")) {
+        baseURL.remove(baseURL.length() - 1);
+    }
+    secure = baseURL.startsWith("https://");
+
+    if (lock == nullptr) {
+        lock = xSemaphoreCreateMutex();
+    }
+
+    // No CA is pinned, matching HTTPClient::begin(url) which the callers used before
+    tlsClient.setInsecure();
+    tlsClient.setHandshakeTimeout(UPLINK_HANDSHAKE_TIMEOUT_S);
+
+    http.setReuse(true);
+    http.setConnectTimeout(UPLINK_CONNECT_TIMEOUT_MS);
+    http.collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
+}
+
+int UplinkClient::request(const char* method, const char* path, const String& payload,
+                          const UplinkHeader* headers, int headerCount,
+                          uint16_t timeoutMs, Stream* body, String* etag) {
+    if (lock == nullptr || WiFi.status() != WL_CONNECTED) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    String url = baseURL + path;
+    bool wasOpen = transport().connected();
+    int code = send(method, url, payload, headers, headerCount, timeoutMs, body, etag);
+
+    // The server may have dropped the kept-alive socket since the last request.
+    // Retry once on a fresh connection if the request provably never reached it
+    // (or it is a GET, which is safe to repeat).
+    if (wasOpen && (code == HTTPC_ERROR_SEND_HEADER_FAILED ||
+                    (code == HTTPC_ERROR_CONNECTION_LOST && strcmp(method, "GET") == 0))) {
+        Serial.println(F("🔁 Uplink connection went stale, reconnecting"));
+        closeLocked();
+        wasOpen = false;
+        code = send(method, url, payload, headers, headerCount, timeoutMs, body, etag);
+    }
+
+    requests++;
+    if (wasOpen) {
+        reused++;
+    } else {
+        connections++;
+    }
+    open = transport().connected();
+    lastUsed = millis();
+    xSemaphoreGive(lock);
+    return code;
+}
+
+int UplinkClient::send(const char* method, const String& url, const String& payload,
+                       const UplinkHeader* headers, int headerCount, uint16_t timeoutMs, Stream* body,
+                       String* etag) {
+    // begin() clears the previous request's headers but keeps the open socket
+    if (!http.begin(transport(), url)) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    http.setTimeout(timeoutMs);
+    for (int i = 0; i < headerCount; i++) {
+        http.addHeader(headers[i].name, headers[i].value);
+    }
+
+    int code = http.sendRequest(method, payload);
+    if (code > 0 && etag != nullptr) {
+        *etag = http.header("ETag");
+    }
+    // 204 and 304 never have a body; without a Content-Length writeToStream()
+    // would wait for the kept-alive socket to close
+    if (code > 0 && code != 204 && code != 304) {
+        // Always drain the body, otherwise the next request would read its tail.
+        // writeToStream() also undoes chunked transfer encoding.
+        http.writeToStream(body != nullptr ? body : &discardBody);
+    }
+
+    // Keeps the socket open unless the server answered "Connection: close"
+    http.end();
+    return code;
+}
+
+void UplinkClient::loop() {
+    if (lock == nullptr || xSemaphoreTake(lock, 0) != pdTRUE) {
+        return; // A request is in flight
+    }
+
+    if (open) {
+        if (WiFi.status() != WL_CONNECTED) {
+            closeLocked();
+        } else if (millis() - lastUsed > UPLINK_IDLE_TIMEOUT_MS) {
+            Serial.println(F("🔌 Closing idle uplink connection"));
+            closeLocked();
+            idleCloses++;
+        }
+    }
+    xSemaphoreGive(lock);
+}
+
+bool UplinkClient::close() {
+    if (lock == nullptr || xSemaphoreTake(lock, 0) != pdTRUE) {
+        return !open;
+    }
+    closeLocked();
+    xSemaphoreGive(lock);
+    return true;
+}
+
+void UplinkClient::closeLocked() {
+    // Stopping the transport frees the TLS session buffers
+    transport().stop();
+    open = false;
+}
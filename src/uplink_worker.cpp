@@ -0,0 +1,96 @@
+#include "uplink_worker.h"
+
+UplinkWorker::UplinkWorker() :
+    task(nullptr),
+    current(nullptr),
+    rejected(0) {
+    for (int i = 0; i < UPLINK_PRIORITY_COUNT; i++) {
+        queues[i] = nullptr;
+    }
+}
+
+bool UplinkWorker::begin() {
+    if (task != nullptr) {
+        return true;
+    }
+
+    for (int i = 0; i < UPLINK_PRIORITY_COUNT; i++) {
+        queues[i] = xQueueCreate(UPLINK_QUEUE_DEPTH, sizeof(BackgroundJob*));
+        if (queues[i] == nullptr) {
+            Serial.println(F("❌ Could not create uplink queues"));
+            return false;
+        }
+    }
+
+    if (xTaskCreatePinnedToCore(taskEntry, "uplink", UPLINK_WORKER_STACK, this,
+                                UPLINK_WORKER_PRIORITY, &task, UPLINK_WORKER_CORE) != pdPASS) {
+        Serial.println(F("❌ Could not start uplink worker"));
+        task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+uint32_t UplinkWorker::submit(BackgroundJob& job, UplinkPriority priority, BackgroundJob::Work work, void* context) {
+    if (task == nullptr) {
+        return 0;
+    }
+
+    uint32_t id = job.reserve(work, context);
+    if (id == 0) {
+        return 0;
+    }
+
+    BackgroundJob* queued = &job;
+    if (xQueueSend(queues[priority], &queued, 0) != pdTRUE) {
+        job.cancel();
+        rejected++;
+        Serial.print(F("⚠️ Uplink queue full, rejected "));
+        Serial.println(job.getName());
+        return 0;
+    }
+
+    xTaskNotifyGive(task);
+    return id;
+}
+
+BackgroundJob* UplinkWorker::next() {
+    BackgroundJob* job = nullptr;
+    for (int i = 0; i < UPLINK_PRIORITY_COUNT; i++) {
+        if (xQueueReceive(queues[i], &job, 0) == pdTRUE) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void UplinkWorker::taskEntry(void* param) {
+    UplinkWorker* self = static_cast<UplinkWorker*>(param);
+    for (;;) {
+        // Every submit() notifies, so nothing queued is missed while we run a job
+        BackgroundJob* job = self->next();
+        if (job == nullptr) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        self->current = job;
+        job->run();
+        self->current = nullptr;
+    }
+}
+
+uint32_t UplinkWorker::getQueued() const {
+    uint32_t queued = 0;
+    for (int i = 0; i < UPLINK_PRIORITY_COUNT; i++) {
+        if (queues[i] != nullptr) {
+            queued += uxQueueMessagesWaiting(queues[i]);
+        }
+    }
+    return queued;
+}
+
+const char* UplinkWorker::getCurrentJob() const {
+    BackgroundJob* job = current;
+    return job != nullptr ? job->getName() : nullptr;
+}
@@ -0,0 +1,338 @@
+#include "waveform_stream.h"
+#include "nonblocking_send.h"
+#include "mbedtls/sha1.h"
+#include "mbedtls/base64.h"
+
+// Fixed GUID from RFC 6455, appended to the client key for Sec-WebSocket-Accept
+static const char WEBSOCKET_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+#define WEBSOCKET_KEY_LENGTH 24          // base64 of the 16-byte nonce, RFC 6455 4.1
+#define WEBSOCKET_OPCODE_BINARY 0x2
+#define WEBSOCKET_OPCODE_CLOSE 0x8
+#define WEBSOCKET_FIN 0x80
+
+// Value of a request header (case-insensitive name, leading spaces skipped), or nullptr
+static const char* findHeader(const char* request, const char* name) {
+    size_t nameLength = strlen(name);
+    for (const char* line = strstr(request, "\r\n"); line != nullptr; line = strstr(line + 2, "\r\n")) {
+        const char* header = line + 2;
+        if (strncasecmp(header, name, nameLength) == 0 && header[nameLength] == ':') {
+            const char* value = header + nameLength + 1;
+            while (*value == ' ') {
+                value++;
+            }
+            return value;
+        }
+    }
+    return nullptr;
+}
+
+static void putUint32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+static void putUint24(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+}
+
+WaveformStream::WaveformStream() :
+    server(WAVEFORM_PORT),
+    sequence(0),
+    irDC(0),
+    dcInitialized(false),
+    framesSent(0),
+    framesDropped(0) {
+    for (int i = 0; i < WAVEFORM_MAX_CLIENTS; i++) {
+        clients[i].active = false;
+        clients[i].upgraded = false;
+        clients[i].used = 0;
+    }
+}
+
+void WaveformStream::begin() {
+    server.begin();
+    server.setNoDelay(true);
+    Serial.print("Waveform WebSocket server started on port ");
+    Serial.println(WAVEFORM_PORT);
+}
+
+void WaveformStream::loop() {
+    accept();
+
+    for (int i = 0; i < WAVEFORM_MAX_CLIENTS; i++) {
+        Viewer& client = clients[i];
+        if (!client.active) {
+            continue;
+        }
+        if (!client.socket.connected()) {
+            release(client);
+            continue;
+        }
+        if (!client.upgraded) {
+            handshake(client);
+            continue;
+        }
+        readControl(client);
+        if (client.active) {
+            flush(client);
+        }
+    }
+}
+
+void WaveformStream::accept() {
+    WiFiClient incoming = server.available();
+    if (!incoming) {
+        return;
+    }
+
+    for (int i = 0; i < WAVEFORM_MAX_CLIENTS; i++) {
+        Viewer& client = clients[i];
+        if (client.active) {
+            continue;
+        }
+        client.socket = incoming;
+        client.socket.setNoDelay(true);
+        client.active = true;
+        client.upgraded = false;
+        client.acceptedAt = millis();
+        client.decimation = 1;
+        client.phase = 0;
+        client.used = 0;
+        return;
+    }
+
+    // No free slot
+    static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\n\r\n";
+    sendNonBlocking(incoming, (const uint8_t*)busy, sizeof(busy) - 1);
+    incoming.stop();
+}
+
+void WaveformStream::handshake(Viewer& client) {
+    // The upgrade request is collected in the (still unused) frame buffer
+    while (client.socket.available() && client.used < WAVEFORM_HANDSHAKE_BUFFER - 1) {
+        client.buffer[client.used++] = client.socket.read();
+    }
+    client.buffer[client.used] = '\0';
+
+    if (strstr(client.buffer, "\r\n\r\n") == nullptr) {
+        if (client.used >= WAVEFORM_HANDSHAKE_BUFFER - 1 ||
+            millis() - client.acceptedAt > WAVEFORM_HANDSHAKE_TIMEOUT_MS) {
+            release(client);
+        }
+        return;
+    }
+
+    const char* key = findHeader(client.buffer, "Sec-WebSocket-Key");
+    const char* upgrade = findHeader(client.buffer, "Upgrade");
+    size_t keyLength = 0;
+    while (key != nullptr && key[keyLength] && key[keyLength] != '\r' && key[keyLength] != ' ') {
+        keyLength++;
+    }
+    if (strncmp(client.buffer, "GET /waveform", 13) != 0 ||
+        upgrade == nullptr || strncasecmp(upgrade, "websocket", 9) != 0 ||
+        keyLength != WEBSOCKET_KEY_LENGTH) {
+        static const char badRequest[] = "HTTP/1.1 400 Bad Request\r\n\r\n";
+        sendNonBlocking(client.socket, (const uint8_t*)badRequest, sizeof(badRequest) - 1);
+        release(client);
+        return;
+    }
+
+    // Optional ?decimate=N, applied per client
+    const char* lineEnd = strstr(client.buffer, "\r\n");
+    const char* decimate = strstr(client.buffer, "decimate=");
+    if (decimate != nullptr && decimate < lineEnd) {
+        int factor = atoi(decimate + 9);
+        client.decimation = (factor < 1) ? 1 : (factor > WAVEFORM_MAX_DECIMATION ? WAVEFORM_MAX_DECIMATION : factor);
+    }
+
+    // Sec-WebSocket-Accept = base64(sha1(key + GUID))
+    char keyed[WEBSOCKET_KEY_LENGTH + sizeof(WEBSOCKET_GUID)];
+    memcpy(keyed, key, WEBSOCKET_KEY_LENGTH);
+    memcpy(keyed + WEBSOCKET_KEY_LENGTH, WEBSOCKET_GUID, sizeof(WEBSOCKET_GUID)); // includes '\0'
+
+    unsigned char digest[20];
+    unsigned char accept[32];
+    size_t acceptLength = 0;
+    mbedtls_sha1_ret((const unsigned char*)keyed, strlen(keyed), digest);
+    mbedtls_base64_encode(accept, sizeof(accept), &acceptLength, digest, sizeof(digest));
+    accept[acceptLength] = '\0';
+
+    // The response goes out through the client buffer like the frames that follow it
+    client.used = snprintf(client.buffer, WAVEFORM_CLIENT_BUFFER,
+                           "HTTP/1.1 101 Switching Protocols\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Accept: %s\r\n"
+                           "\r\n", accept);
+    client.upgraded = true;
+    flush(client);
+    if (!client.active) {
+        return;
+    }
+    Serial.print("📈 Waveform client connected, decimation ");
+    Serial.println(client.decimation);
+}
+
+void WaveformStream::readControl(Viewer& client) {
+    // Clients only send control frames here; honour close and discard the rest
+    uint8_t incoming[64];
+    int length = client.socket.available();
+    if (length <= 0) {
+        return;
+    }
+    if (length > (int)sizeof(incoming)) {
+        length = sizeof(incoming);
+    }
+    length = client.socket.read(incoming, length);
+
+    for (int pos = 0; pos + 2 <= length;) {
+        uint8_t opcode = incoming[pos] & 0x0F;
+        uint8_t payload = incoming[pos + 1] & 0x7F;
+        if (opcode == WEBSOCKET_OPCODE_CLOSE) {
+            const uint8_t closeFrame[2] = {WEBSOCKET_FIN | WEBSOCKET_OPCODE_CLOSE, 0};
+            sendNonBlocking(client.socket, closeFrame, sizeof(closeFrame)); // Best effort, we close anyway
+            Serial.println("📈 Waveform client closed");
+            release(client);
+            return;
+        }
+        if (payload >= 126) {
+            break; // Long frames aren't expected from viewers
+        }
+        pos += 2 + ((incoming[pos + 1] & 0x80) ? 4 : 0) + payload;
+    }
+}
+
+void WaveformStream::publish(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count) {
+    if (count > WAVEFORM_MAX_BATCH) {
+        count = WAVEFORM_MAX_BATCH;
+    }
+
+    // DC-removed IR, tracked continuously so it doesn't restart per frame
+    int16_t irAC[WAVEFORM_MAX_BATCH];
+    for (int i = 0; i < count; i++) {
+        if (!dcInitialized) {
+            irDC = ir[i];
+            dcInitialized = true;
+        }
+        irDC += ((int32_t)ir[i] - irDC) >> WAVEFORM_DC_SHIFT;
+        int32_t ac = (int32_t)ir[i] - irDC;
+        irAC[i] = (ac > 32767) ? 32767 : (ac < -32768 ? -32768 : ac);
+    }
+
+    uint32_t period = 0;
+    if (count > 1) {
+        period = (timestamps[count - 1] - timestamps[0]) / (count - 1);
+    }
+
+    uint8_t payload[WAVEFORM_HEADER_BYTES + WAVEFORM_MAX_BATCH * WAVEFORM_SAMPLE_BYTES];
+    for (int c = 0; c < WAVEFORM_MAX_CLIENTS; c++) {
+        Viewer& client = clients[c];
+        if (!client.active || !client.upgraded) {
+            continue;
+        }
+
+        uint8_t* sample = payload + WAVEFORM_HEADER_BYTES;
+        int sent = 0;
+        int first = -1;
+        for (int i = 0; i < count; i++) {
+            bool keep = (client.phase == 0);
+            client.phase = (client.phase + 1) % client.decimation;
+            if (!keep) {
+                continue;
+            }
+            if (first < 0) {
+                first = i;
+            }
+            putUint24(sample, red[i]);
+            putUint24(sample + 3, ir[i]);
+            sample[6] = irAC[i] & 0xFF;
+            sample[7] = (irAC[i] >> 8) & 0xFF;
+            sample += WAVEFORM_SAMPLE_BYTES;
+            sent++;
+        }
+        if (sent == 0) {
+            continue;
+        }
+
+        payload[0] = WAVEFORM_FRAME_VERSION;
+        payload[1] = sent;
+        payload[2] = client.decimation;
+        payload[3] = 0;
+        putUint32(payload + 4, sequence + first);
+        putUint32(payload + 8, timestamps[first]);
+        putUint32(payload + 12, period * client.decimation);
+
+        if (queueFrame(client, payload, WAVEFORM_HEADER_BYTES + sent * WAVEFORM_SAMPLE_BYTES)) {
+            framesSent++;
+        } else {
+            framesDropped++;
+        }
+    }
+
+    sequence += count;
+}
+
+int WaveformStream::getClientCount() const {
+    int count = 0;
+    for (int i = 0; i < WAVEFORM_MAX_CLIENTS; i++) {
+        if (clients[i].active && clients[i].upgraded) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool WaveformStream::queueFrame(Viewer& client, const uint8_t* payload, size_t length) {
+    uint8_t header[4];
+    size_t headerLength = 2;
+    header[0] = WEBSOCKET_FIN | WEBSOCKET_OPCODE_BINARY;
+    if (length < 126) {
+        header[1] = length;
+    } else {
+        header[1] = 126;
+        header[2] = (length >> 8) & 0xFF;
+        header[3] = length & 0xFF;
+        headerLength = 4;
+    }
+
+    // Backpressure: a frame that doesn't fit is dropped whole, acquisition never waits
+    if (client.used + headerLength + length > WAVEFORM_CLIENT_BUFFER) {
+        return false;
+    }
+    memcpy(client.buffer + client.used, header, headerLength);
+    memcpy(client.buffer + client.used + headerLength, payload, length);
+    client.used += headerLength + length;
+    return true;
+}
+
+void WaveformStream::flush(Viewer& client) {
+    if (client.used == 0) {
+        return;
+    }
+
+    int sent = sendNonBlocking(client.socket, (const uint8_t*)client.buffer, client.used);
+    if (sent < 0) {
+        release(client);
+        return;
+    }
+    size_t written = sent;
+
+    // Keep whatever the socket didn't accept for the next pass
+    if (written < client.used) {
+        memmove(client.buffer, client.buffer + written, client.used - written);
+    }
+    client.used -= written;
+}
+
+void WaveformStream::release(Viewer& client) {
+    client.socket.stop();
+    client.socket = WiFiClient();
+    client.active = false;
+    client.upgraded = false;
+    client.used = 0;
+}
@@ -1,11 +1,15 @@
 #include "wifi_manager.h"
 #include "sensor_manager.h"
+#include "sensor_scheduler.h"
 #include "display_manager.h" // Include DisplayManager header
+#include "web_assets.h"         // Generated from web/ by tools/embed_web_assets.py
+#include "json_field_extractor.h"
 #include <EEPROM.h>
 #include <esp_wifi.h>
 
 // Reference to the SensorManager instance in main.cpp
 extern SensorManager sensorManager;
+extern SensorScheduler sensorScheduler;
 
 // EEPROM constants
 #define EEPROM_SIZE 1024
@@ -15,7 +19,88 @@ extern SensorManager sensorManager;
 #define EMAIL_ADDR 192
 #define UID_ADDR 256
 
+// JSON API: documents and the serialized response live on the stack
+#define API_JSON_CAPACITY 1280
+#define API_RESPONSE_BUFFER 1536
+
+#define AI_SUMMARY_MAX_LENGTH 500     // Longer summaries are cut and end in "..."
+
+// Sorted by path (byte order); a misplaced entry fails the static_assert in dispatch()
+constexpr WiFiManager::Route WiFiManager::routes[] = {
+    {"/",                          HTTP_ANY,  &WiFiManager::handleRoot}, // Setup / captive portal landing page
+    {"/ai_analysis",               HTTP_ANY,  &WiFiManager::handleAIAnalysis},
+    {"/ai_analysis_result",        HTTP_GET,  &WiFiManager::handleAIAnalysisResult}, // ?job=<id> from /ai_analysis
+    {"/api/v1/config",             HTTP_GET,  &WiFiManager::handleApiConfig},
+    {"/api/v1/measurement",        HTTP_ANY,  &WiFiManager::handleApiMeasurement}, // GET progress, POST action=start|stop
+    {"/api/v1/result",             HTTP_GET,  &WiFiManager::handleApiResult},
+    {"/api/v1/status",             HTTP_GET,  &WiFiManager::handleApiStatus},
+    {"/check_measurement_status",  HTTP_ANY,  &WiFiManager::handleCheckMeasurementStatus},
+    {"/connect",                   HTTP_POST, &WiFiManager::handleConnect},
+    {"/connect_status",            HTTP_GET,  &WiFiManager::handleConnectStatus}, // ?job=<id> from /connect
+    {"/continue_measuring",        HTTP_ANY,  &WiFiManager::handleContinueMeasuring},
+    {"/diagnostics",               HTTP_GET,  &WiFiManager::handleDiagnostics},
+    {"/events",                    HTTP_GET,  &WiFiManager::handleEvents},
+    {"/favicon.ico",               HTTP_GET,  &WiFiManager::handleFavicon},
+    {"/force_ap",                  HTTP_ANY,  &WiFiManager::handleForceAP},
+    {"/guest",                     HTTP_ANY,  &WiFiManager::handleGuest},
+    {"/login",                     HTTP_ANY,  &WiFiManager::handleLogin},
+    {"/login_status",              HTTP_GET,  &WiFiManager::handleLoginStatus}, // ?job=<id> from /login_submit
+    {"/login_submit",              HTTP_POST, &WiFiManager::handleLoginSubmit},
+    {"/measurement",               HTTP_ANY,  &WiFiManager::handleMeasurement},
+    {"/measurement_info",          HTTP_ANY,  &WiFiManager::handleMeasurementInfo},
+    {"/measurement_stream",        HTTP_ANY,  &WiFiManager::handleMeasurementStream},
+    {"/mode",                      HTTP_ANY,  &WiFiManager::handleModeSelect},
+    {"/probes",                    HTTP_GET,  &WiFiManager::handleProbes},
+    {"/reconfigure_wifi",          HTTP_ANY,  &WiFiManager::handleReconfigWiFi},
+    {"/return_to_measurement",     HTTP_ANY,  &WiFiManager::handleReturnToMeasurement},
+    {"/start_measurement",         HTTP_ANY,  &WiFiManager::handleStartMeasurement}, // Browser confirms the page loaded
+    {"/status",                    HTTP_ANY,  &WiFiManager::handleStatus},
+    {"/wifi",                      HTTP_ANY,  &WiFiManager::handleWiFi},
+};
+
+#define ROUTE_COUNT (sizeof(WiFiManager::routes) / sizeof(WiFiManager::routes[0]))
+
+// Binary search over a table sorted by path; pathOf returns the key of an entry
+template <typename T, typename PathOf>
+static int findByPath(const T* table, int count, const char* path, PathOf pathOf) {
+    int low = 0;
+    int high = count - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        int order = strcmp(path, pathOf(table[mid]));
+        if (order == 0) {
+            return mid;
+        }
+        if (order < 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return -1;
+}
+
+// Single WebServer handler in front of the route table, so the server's own
+// handler list has one entry and lookup cost doesn't depend on the route count
+class WiFiManager::RouteDispatcher : public RequestHandler {
+private:
+    WiFiManager& owner;
+
+public:
+    RouteDispatcher(WiFiManager& owner) : owner(owner) {}
+    
+    bool canHandle(HTTPMethod method, String uri) override {
+        return owner.dispatch(method, uri.c_str(), false);
+    }
+    
+    bool handle(WebServer& server, HTTPMethod method, String uri) override {
+        (void)server;
+        return owner.dispatch(method, uri.c_str(), true);
+    }
+};
+
 WiFiManager::WiFiManager(const char* ap_ssid, const char* ap_password, const char* serverURL) :
+    dispatcher(nullptr),
     ap_ssid(ap_ssid),
     ap_password(ap_password),
     serverURL(serverURL),
@@ -27,6 +112,21 @@ WiFiManager::WiFiManager(const char* ap_ssid, const char* ap_password, const cha
     lastWifiCheck(0),
     wifiCheckInterval(5000),
     lastWifiErrorCode(WL_IDLE_STATUS),
+    connectJob("wifi_connect"),
+    aiJob("ai_summary"),
+    loginJob("login"),
+    pendingWifiErrorCode(WL_IDLE_STATUS),
+    aiOnline(false),
+    loginOnline(false),
+    uploader(uplink, measurementQueue),
+    drainJob("queue_drain"),
+    directJob("direct_upload"),
+    directOnline(false),
+    drainRequested(false),
+    uploadForced(false),
+    freshResult(false),
+    drainOnline(false),
+    lastDrainAttempt(0),
     setupUICallback(nullptr),
     initializeSensorCallback(nullptr),
     updateConnectionStatusCallback(nullptr),
@@ -34,21 +134,10 @@ WiFiManager::WiFiManager(const char* ap_ssid, const char* ap_password, const cha
     startNewMeasurementCallback(nullptr),
     handleAIAnalysisCallback(nullptr)
 {
-    // Optimized CSS without Google fonts
-    commonCSS = "body{font-family:Arial,sans-serif;margin:0;padding:15px;text-align:center;background:#f0f0f0}"
-                ".container{max-width:400px;margin:0 auto;background:#fff;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,.1)}"
-                "h1{color:#333;font-size:20px;margin-top:0}"
-                ".status{font-weight:700;margin-bottom:15px}.connected{color:#4CAF50}.disconnected{color:#f44336}"
-                "button,input[type=submit]{background:#4CAF50;color:#fff;padding:8px 12px;border:none;border-radius:4px;cursor:pointer;margin:8px 0;width:100%}"
-                "input[type=email],input[type=password],input[type=text]{width:100%;padding:8px;margin:8px 0;border:1px solid #ddd;border-radius:4px;box-sizing:border-box}"
-                ".guest-btn{background:#2196F3}.back-btn{background:#f44336}";
-
     apIP = IPAddress(192, 168, 4, 1);
-    server = new WebServer(80);
+    server = new TakeoverWebServer(80);
     
     // Server timeout configuration (not standard in WebServer library)
-    
-    dnsServer = new DNSServer();
 }
 
 void WiFiManager::begin() {
@@ -59,6 +148,13 @@ void WiFiManager::begin() {
     // Read saved WiFi credentials
     readWiFiCredentials();
     
+    // One kept-alive connection to the backend for every API call
+    uplink.begin(serverURL);
+    uplinkWorker.begin();
+    
+    // Measurements taken while offline survive reboots here until uploaded
+    measurementQueue.begin();
+    
     Serial.println("Starting WiFi Manager");
     Serial.print("SDK Version: ");
     Serial.println(ESP.getSdkVersion());
@@ -95,54 +191,22 @@ void WiFiManager::begin() {
     server->enableCORS(true);
     server->enableCrossOrigin(true);
     
-    // Setup web server routes
-    // Main interface and WiFi setup
-    server->on("/", [this](){ this->handleRoot(); });
-    server->on("/wifi", [this](){ this->handleWiFi(); });
-    server->on("/connect", HTTP_POST, [this](){ this->handleConnect(); });
-    
-    // Main functionality routes
-    server->on("/mode", [this](){ this->handleModeSelect(); });
-    server->on("/login", [this](){ this->handleLogin(); });
-    server->on("/login_submit", HTTP_POST, [this](){ this->handleLoginSubmit(); });
-    server->on("/guest", [this](){ this->handleGuest(); });
-    
-    // Measurement and analysis routes
-    server->on("/measurement", [this](){
-        // Free memory before processing measurement request
-        ESP.getFreeHeap();
-        this->handleMeasurement();
-    });
-    server->on("/measurement_info", [this](){ this->handleMeasurementInfo(); });
-    server->on("/measurement_stream", [this](){ this->handleMeasurementStream(); });
-    server->on("/continue_measuring", [this](){ this->handleContinueMeasuring(); });
-    server->on("/start_measurement", [this](){ this->handleStartMeasurement(); }); // New endpoint for browser to confirm page load
-    server->on("/check_measurement_status", [this](){ this->handleCheckMeasurementStatus(); }); // New endpoint to check if measurement is complete
-    server->on("/ai_analysis", [this](){ this->handleAIAnalysis(); });
-    server->on("/return_to_measurement", [this](){ this->handleReturnToMeasurement(); });
-    
-    // Các route tiện ích
-    server->on("/reconfigure_wifi", [this](){ this->handleReconfigWiFi(); });
-    server->on("/status", [this](){ this->handleStatus(); });
-    server->on("/force_ap", [this](){ this->handleForceAP(); });
-    
-    // Hỗ trợ captive portal cho các thiết bị di động
-    server->on("/generate_204", [this](){ this->handleRoot(); }); // Android
-    server->on("/mobile/status.php", [this](){ this->handleRoot(); }); // Android
-    server->on("/hotspot-detect.html", [this](){ this->handleRoot(); }); // iOS
-    server->on("/library/test/success.html", [this](){ this->handleRoot(); }); // iOS
-    server->on("/favicon.ico", HTTP_GET, [this](){ server->send(200, "image/x-icon", ""); });
-    
-    // Handler for routes not found
-    server->onNotFound([this](){
-        // Đảm bảo vẫn giải phóng bộ nhớ
-        cleanupConnections();
-        this->handleNotFound();
-    });
+    // Conditional GETs of the embedded assets
+    static const char* collectedHeaders[] = {"If-None-Match"};
+    server->collectHeaders(collectedHeaders, 1);
+    
+    // All routes go through the static route table (WiFiManager::routes)
+    dispatcher = new RouteDispatcher(*this);
+    server->addHandler(dispatcher);
+    
+    // Everything else: connectivity probes and stray URLs from captive clients
+    captivePortal.begin(apIP);
+    server->onNotFound([this](){ this->handleNotFound(); });
     
     // Start server
     server->begin();
     Serial.println("HTTP server started");
+    waveform.begin();
     
     // Print connection info
     Serial.print("Free heap after setup: ");
@@ -182,9 +246,8 @@ void WiFiManager::setupAPMode() {
     Serial.println(WiFi.softAPIP());
     
     // Stop any existing DNS server and restart it
-    dnsServer->stop();
-    // Setup captive portal with more reliable parameters
-    bool dnsStarted = dnsServer->start(53, "*", apIP);
+    dns.stop();
+    bool dnsStarted = dns.start(apIP);
     
     if (!dnsStarted) {
         Serial.println("Failed to start DNS server");
@@ -201,8 +264,20 @@ void WiFiManager::setupAPMode() {
 }
 
 bool WiFiManager::connectToWiFi(String ssid, String password) {
+    int errorCode = lastWifiErrorCode;
+    bool connected = attemptWiFiConnection(ssid, password, errorCode);
+    lastWifiErrorCode = errorCode;
+    finishWiFiConnection(connected);
+    return connected;
+}
+
+// Blocking part of a connection attempt. Only drives the radio and logs, so it
+// can also run on the connect job's task; the WiFi status of a failed attempt is
+// returned in errorCode and callbacks happen in finishWiFiConnection().
+bool WiFiManager::attemptWiFiConnection(const String& ssid, const String& password, int& errorCode) {
     if (ssid.length() == 0) {
         Serial.println("Error: Empty SSID provided");
+        errorCode = WL_NO_SSID_AVAIL;
         return false;
     }
     
@@ -258,52 +333,45 @@ bool WiFiManager::connectToWiFi(String ssid, String password) {
         Serial.println(WiFi.localIP());
         Serial.print("AP IP address still available: ");
         Serial.println(WiFi.softAPIP());
-        
-        if (updateConnectionStatusCallback) {
-            updateConnectionStatusCallback(true, false, isLoggedIn);
-        }
-        
-        isConnected = true;
         return true;
-    } else {
-        int wifiErrorCode = WiFi.status();
-        Serial.println("");
-        Serial.print("WiFi connection failed with status: ");
-        Serial.println(wifiErrorCode);
-        
-        // Display error based on status code
-        switch (wifiErrorCode) {
-            case WL_NO_SSID_AVAIL:
-                Serial.println("SSID not available - Check network name");
-                break;
-            case WL_CONNECT_FAILED:
-                Serial.println("Invalid password or authentication failed");
-                break;
-            case WL_CONNECTION_LOST:
-                Serial.println("Connection lost");
-                break;
-            default:
-                Serial.println("Unknown error");
-                break;
-        }
-        
-        // If connection failed, ensure AP mode is still active
-        if (!apModeActive) {
-            setupAPMode();
-        }
-        
-        // Pass the specific error code to the connection status callback
-        if (updateConnectionStatusCallback) {
-            // Store the error code for later use in status page
-            lastWifiErrorCode = wifiErrorCode;
-            updateConnectionStatusCallback(false, false, isLoggedIn);
-        }
-        
-        if (updateConnectionStatusCallback) {
-            updateConnectionStatusCallback(false, false, isLoggedIn);
-        }
-        
-        return false;
+    }
+    
+    int wifiErrorCode = WiFi.status();
+    Serial.println("");
+    Serial.print("WiFi connection failed with status: ");
+    Serial.println(wifiErrorCode);
+    
+    // Display error based on status code
+    switch (wifiErrorCode) {
+        case WL_NO_SSID_AVAIL:
+            Serial.println("SSID not available - Check network name");
+            break;
+        case WL_CONNECT_FAILED:
+            Serial.println("Invalid password or authentication failed");
+            break;
+        case WL_CONNECTION_LOST:
+            Serial.println("Connection lost");
+            break;
+        default:
+            Serial.println("Unknown error");
+            break;
+    }
+    
+    // Reported back for the status pages
+    errorCode = wifiErrorCode;
+    return false;
+}
+
+void WiFiManager::finishWiFiConnection(bool connected) {
+    isConnected = connected;
+    
+    // If connection failed, ensure AP mode is still active
+    if (!connected && !apModeActive) {
+        setupAPMode();
+    }
+    
+    if (updateConnectionStatusCallback) {
+        updateConnectionStatusCallback(connected, false, isLoggedIn);
     }
 }
 
@@ -425,6 +493,11 @@ void WiFiManager::checkWiFiConnection() {
     
     lastWifiCheck = millis();
     
+    // The connect job owns the radio until it finishes
+    if (connectJob.isRunning()) {
+        return;
+    }
+    
     // Track connection quality for debugging
     static int connectionErrorCounter = 0;
     static unsigned long lastSocketCleanup = 0;
@@ -497,6 +570,14 @@ void WiFiManager::checkWiFiConnection() {
     } else if (isConnected) {
         // Connection is good, reset error counter
         connectionErrorCounter = 0;
+    } else if (userSSID.length() > 0 && WiFi.status() == WL_CONNECTED) {
+        // A reconnect started by ensureWiFiStability() completed in the background
+        Serial.println("WiFi connection restored");
+        isConnected = true;
+        
+        if (updateConnectionStatusCallback) {
+            updateConnectionStatusCallback(true, isGuestMode, isLoggedIn);
+        }
     }
     
     // If we have persistent connection issues, try more aggressive cleanup
@@ -536,187 +617,139 @@ void WiFiManager::handleRoot() {
         return;
     }
     
-    // Otherwise show WiFi setup
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<meta charset='UTF-8'>"
-                  "<title>HealthSense WiFi Setup</title>"
-                  "<style>" + commonCSS + "</style>"
-                  "</head>"
-                  "<body>"
-                  "<div class='container'>"
-                  "<h1>HealthSense Setup</h1>";
+    // Otherwise show WiFi setup; shares the status page's fields (SSID is escaped)
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_ROOT_TPL_HTML, statusValue, pageSection, this);
+    page.end();
+}
+
+void WiFiManager::handleWiFi() {
+    sendWebAsset(WEB_WIFI_HTML);
+}
+
+void WiFiManager::handleConnect() {
+    String ssid = server->arg("ssid");
+    String password = server->arg("password");
     
-    // Show WiFi status
-    if (isConnected) {
-        html += "<p class='status connected'>WiFi Connected to: " + userSSID + "</p>";
-        html += "<p class='status'>Station IP: " + WiFi.localIP().toString() + "</p>";
-    } else {
-        html += "<p class='status disconnected'>WiFi Not Connected</p>";
+    if (ssid.length() == 0) {
+        // Chuyển hướng đến trang thiết lập WiFi
+        server->sendHeader("Location", "/wifi");
+        server->send(302, "text/plain", "");
+        return;
     }
     
-    html += "<p class='status'>Hotspot IP: " + WiFi.softAPIP().toString() + "</p>";
-    html += "<p style='font-size: 12px; color: #666;'>Access this device from both WiFi network and hotspot</p>";
-    
-    html += "<p>Configure your WiFi connection:</p>"
-            "<form action='/wifi' method='get'><button type='submit'>Setup WiFi</button></form>";
-    
-    if (isConnected) {
-        html += "<form action='/mode' method='get'><button type='submit'>Continue to Mode Selection</button></form>";
+    // A connection attempt is already under way; keep showing its progress
+    if (connectJob.isRunning()) {
+        sendConnectingPage(connectJob.getId());
+        return;
     }
     
-    html += "<form action='/status' method='get'><button type='submit' class='guest-btn'>Connection Status</button></form>";
+    // First save connection information
+    userSSID = ssid;
+    userPassword = password;
+    isGuestMode = false;
+    saveWiFiCredentials(ssid, password, false);
+    
+    // The attempt takes up to ~45 s; run it on the job task and let the page poll /connect_status
+    pendingSSID = ssid;
+    pendingPassword = password;
+    pendingWifiErrorCode = WL_IDLE_STATUS;
+    uint32_t jobId = connectJob.start(runConnectJob, this);
+    if (jobId == 0) {
+        server->send(503, "text/plain", "Unable to start WiFi connection, please try again");
+        return;
+    }
     
-    html += "</div></body></html>";
-    server->send(200, "text/html", html);
+    sendConnectingPage(jobId);
 }
 
-void WiFiManager::handleWiFi() {
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<meta charset='UTF-8'>"
-                  "<title>HealthSense WiFi Setup</title>"
-                  "<style>" + commonCSS + "</style>"
-                  "</head>"
-                  "<body>"
-                  "<div class='container'>"
-                  "<h1>WiFi Connection</h1>"
-                  "<form action='/connect' method='post'>"
-                  "<label for='ssid'>WiFi Network Name:</label><br>"
-                  "<input type='text' id='ssid' name='ssid' placeholder='Enter WiFi name' required><br>"
-                  "<label for='password'>WiFi Password:</label><br>"
-                  "<input type='password' id='password' name='password' placeholder='Enter password'><br>"
-                  "<input type='submit' value='Connect'>"
-                  "</form>"
-                  "<form action='/' method='get'><button type='submit' class='back-btn'>Back</button></form>"
-                  "</div>"
-                  "</body></html>";
-    server->send(200, "text/html", html);
+bool WiFiManager::runConnectJob(void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    Serial.println("Attempting WiFi connection from web interface...");
+    
+    bool connected = self->attemptWiFiConnection(self->pendingSSID, self->pendingPassword,
+                                                 self->pendingWifiErrorCode);
+    
+    // If first attempt fails, reset WiFi and try again
+    if (!connected) {
+        Serial.println("First connection attempt failed, trying again after reset...");
+        WiFi.disconnect(true);
+        delay(500); // Reduced delay time
+        connected = self->attemptWiFiConnection(self->pendingSSID, self->pendingPassword,
+                                                self->pendingWifiErrorCode);
+    }
+    return connected;
 }
 
-void WiFiManager::handleConnect() {
-    String ssid = server->arg("ssid");
-    String password = server->arg("password");
+void WiFiManager::sendConnectingPage(uint32_t jobId) {
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_CONNECTING_TPL_HTML, connectValue, connectSection, this);
+    page.end();
+}
+
+void WiFiManager::handleConnectStatus() {
+    uint32_t jobId = requestedJobId();
+    JobState state = connectJob.getState(jobId);
     
-    // Separate connection process and HTTP response to avoid connection abort
-    if (ssid.length() > 0) {
-        // First save connection information
-        userSSID = ssid;
-        userPassword = password;
-        isGuestMode = false;
-        saveWiFiCredentials(ssid, password, false);
-        
-        // Send HTML page with connection status BEFORE attempting WiFi connection
-        String loadingHtml = "<!DOCTYPE html><html>"
-                    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                    "<meta charset='UTF-8'>"
-                    "<title>Connecting to WiFi...</title>"
-                    "<style>body{font-family:Arial;text-align:center;padding:20px;background:#f0f0f0;}"
-                    ".container{max-width:400px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1);}"
-                    ".spinner{width:40px;height:40px;margin:20px auto;border-radius:50%;border:5px solid #f3f3f3;border-top:5px solid #3498db;animation:spin 1s linear infinite;}"
-                    "@keyframes spin{0%{transform:rotate(0deg)}100%{transform:rotate(360deg)}}</style>"
-                    "<meta http-equiv='refresh' content='2;url=/connect_status'>"
-                    "</head>"
-                    "<body><div class='container'>"
-                    "<h1>Connecting to WiFi</h1>"
-                    "<p>Connecting to network: <strong>" + ssid + "</strong></p>"
-                    "<div class='spinner'></div>"
-                    "<p>Please wait a moment...</p>"
-                    "</div></body></html>";
-        
-        // Send loading page and close HTTP connection before starting WiFi connection
-        server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-        server->send(200, "text/html", loadingHtml);
-        
-        // Register new handler to display results after redirect
-        server->on("/connect_status", [this, ssid, password]() {
-            // Try WiFi connection
-            Serial.println("Attempting WiFi connection from web interface...");
-            Serial.print("SSID: '");
-            Serial.print(ssid);
-            Serial.print("', Password length: ");
-            Serial.println(password.length());
-            
-            // Attempt WiFi connection
-            isConnected = connectToWiFi(ssid, password);
-            
-            // If first attempt fails, reset WiFi and try again
-            if (!isConnected) {
-                Serial.println("First connection attempt failed, trying again after reset...");
-                WiFi.disconnect(true);
-                delay(500); // Reduced delay time
-                isConnected = connectToWiFi(ssid, password);
-            }
-            
-            // Prepare HTML result
-            String html = "<!DOCTYPE html><html>"
-                        "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                        "<meta charset='UTF-8'>"
-                        "<title>Connection Result</title>"
-                        "<style>body{font-family:Arial;text-align:center;padding:20px;background:#f0f0f0;}"
-                        ".container{max-width:400px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1);}"
-                        ".success{color:#4CAF50;font-weight:bold;font-size:16px;}"
-                        ".error{color:#f44336;font-weight:bold;font-size:16px;}"
-                        "button{background:#4CAF50;color:white;padding:10px 15px;border:none;border-radius:4px;cursor:pointer;margin:10px 0;width:100%;}</style>"
-                        "</head><body><div class='container'>"
-                        "<h1>Connection Result</h1>";
-            
-            if (isConnected) {
-                html += "<p class='success'>✅ WiFi connection successful!</p>"
-                        "<p>Connected to: <strong>" + ssid + "</strong></p>"
-                        "<p>IP: " + WiFi.localIP().toString() + "</p>";
-                        
-                if (WiFi.RSSI() > -70) {
-                    html += "<p>Signal: Strong (-" + String(abs(WiFi.RSSI())) + " dBm)</p>";
-                } else if (WiFi.RSSI() > -85) {
-                    html += "<p>Signal: Medium (-" + String(abs(WiFi.RSSI())) + " dBm)</p>";
-                } else {
-                    html += "<p>Signal: Weak (-" + String(abs(WiFi.RSSI())) + " dBm)</p>";
-                }
-                
-                html += "<form action='/mode'><button type='submit'>Continue</button></form>";
-            } else {
-                html += "<p class='error'>❌ WiFi connection failed!</p>";
-                
-                // Show specific error based on status code
-                switch (WiFi.status()) {
-                    case WL_NO_SSID_AVAIL:
-                        html += "<p>WiFi network not found</p>";
-                        break;
-                    case WL_CONNECT_FAILED:
-                        html += "<p>Wrong password or authentication failed</p>";
-                        break;
-                    default:
-                        html += "<p>Error code: " + String(WiFi.status()) + "</p>";
-                        break;
-                }
-                
-                html += "<form action='/wifi'><button type='submit'>Try Again</button></form>";
-                
-                // Ensure AP mode is still active to allow reconfiguration
-                if (!apModeActive) {
-                    setupAPMode();
-                }
-            }
-            
-            html += "</div></body></html>";
-            
-            // Send HTML result
-            server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-            server->send(200, "text/html", html);
-            
-            // Update connection status through callback
-            if (updateConnectionStatusCallback) {
-                updateConnectionStatusCallback(isConnected, false, false);
-            }
-        });
-    } else {
-        // Chuyển hướng đến trang thiết lập WiFi
+    if (state == JOB_UNKNOWN) {
         server->sendHeader("Location", "/wifi");
         server->send(302, "text/plain", "");
+        return;
+    }
+    if (state == JOB_RUNNING) {
+        sendConnectingPage(jobId);
+        return;
+    }
+    
+    // The job has finished, so its result fields are no longer written to
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_CONNECT_RESULT_TPL_HTML, connectValue, connectSection, this);
+    page.end();
+}
+
+bool WiFiManager::connectSection(const char* name, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    
+    if (strcmp(name, "SUCCESS") == 0) return self->connectJob.succeeded();
+    return false;
+}
+
+void WiFiManager::connectValue(const char* name, TemplateStream& out, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    
+    if (strcmp(name, "SSID") == 0) {
+        // User-supplied network name
+        out.printEscaped(self->pendingSSID.c_str());
+    } else if (strcmp(name, "JOB") == 0) {
+        out.print((int32_t)self->connectJob.getId());
+    } else if (strcmp(name, "ELAPSED") == 0) {
+        out.print((int32_t)(self->connectJob.getElapsedMs() / 1000));
+    } else if (strcmp(name, "IP") == 0) {
+        out.print(WiFi.localIP());
+    } else if (strcmp(name, "RSSI") == 0) {
+        out.print((int32_t)abs(WiFi.RSSI()));
+    } else if (strcmp(name, "SIGNAL") == 0) {
+        int32_t rssi = WiFi.RSSI();
+        out.print(rssi > -70 ? "Strong" : (rssi > -85 ? "Medium" : "Weak"));
+    } else if (strcmp(name, "ERROR") == 0) {
+        // Specific error based on the status code the connect job reported
+        switch (self->pendingWifiErrorCode) {
+            case WL_NO_SSID_AVAIL: out.print("WiFi network not found"); break;
+            case WL_CONNECT_FAILED: out.print("Wrong password or authentication failed"); break;
+            default: out.print("Error code: "); out.print((int32_t)self->pendingWifiErrorCode); break;
+        }
     }
 }
 
+uint32_t WiFiManager::requestedJobId() {
+    return strtoul(server->arg("job").c_str(), nullptr, 10);
+}
+
 void WiFiManager::handleModeSelect() {
     // If not connected to WiFi, redirect to WiFi setup
     if (!isConnected) {
@@ -729,32 +762,7 @@ void WiFiManager::handleModeSelect() {
     isMeasuring = false;
     resetMeasurementStreamState();
     
-    String html = "<!DOCTYPE html><html>"
-                "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                "<title>HealthSense Mode Selection</title>"
-                "<style>"
-                "body { font-family: Arial, sans-serif; margin: 0; padding: 20px; text-align: center; background-color: #f0f0f0; }"
-                ".container { max-width: 400px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }"
-                "h1 { color: #333; }"
-                "button, input[type='submit'] { background: #4CAF50; color: white; padding: 10px 15px; border: none; border-radius: 5px; cursor: pointer; margin: 10px 0; width: 100%; }"
-                "button:hover, input[type='submit']:hover { background: #45a049; }"
-                ".guest-btn { background: #2196F3; }"
-                ".guest-btn:hover { background: #0b7dda; }"
-                ".reconfigure-btn { background: #f44336; margin-top: 30px; }"
-                ".reconfigure-btn:hover { background: #d32f2f; }"
-                "</style>"
-                "</head>"
-                "<body>"
-                "<div class='container'>"
-                "<h1>HealthSense Mode Selection</h1>"
-                "<p>Choose your operating mode:</p>"
-                "<form action='/login' method='get'><button type='submit'>User Mode</button></form>"
-                "<form action='/guest' method='get'><button type='submit' class='guest-btn'>Guest Mode</button></form>"
-                "<form action='/reconfigure_wifi' method='get'><button type='submit' class='reconfigure-btn'>Reconfigure WiFi</button></form>"
-                "</div>"
-                "</body></html>";
-    
-    server->send(200, "text/html", html);
+    sendWebAsset(WEB_MODE_HTML);
 }
 
 void WiFiManager::handleLogin() {
@@ -765,102 +773,95 @@ void WiFiManager::handleLogin() {
         return;
     }
     
-    String html = "<!DOCTYPE html><html>"
-                "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                "<title>HealthSense Login</title>"
-                "<style>"
-                "body { font-family: Arial, sans-serif; margin: 0; padding: 20px; text-align: center; background-color: #f0f0f0; }"
-                ".container { max-width: 400px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }"
-                "h1 { color: #333; }"
-                "button, input[type='submit'] { background: #4CAF50; color: white; padding: 10px 15px; border: none; border-radius: 5px; cursor: pointer; margin: 10px 0; width: 100%; }"
-                "button:hover, input[type='submit']:hover { background: #45a049; }"
-                "input[type='text'], input[type='password'], input[type='email'] { width: 100%; padding: 10px; margin: 10px 0; border: 1px solid #ddd; border-radius: 5px; box-sizing: border-box; }"
-                ".back-btn { background: #f44336; }"
-                ".back-btn:hover { background: #d32f2f; }"
-                "</style>"
-                "</head>"
-                "<body>"
-                "<div class='container'>"
-                "<h1>User Login</h1>"
-                "<form action='/login_submit' method='post'>"
-                "<label for='email'>Email:</label><br>"
-                "<input type='email' id='email' name='email' required><br>"
-                "<label for='password'>Password:</label><br>"
-                "<input type='password' id='password' name='password' required><br>"
-                "<input type='submit' value='Login'>"
-                "</form>"
-                "<form action='/mode' method='get'><button type='submit' class='back-btn'>Back</button></form>"
-                "</div>"
-                "</body></html>";
-    
-    server->send(200, "text/html", html);
+    sendWebAsset(WEB_LOGIN_HTML);
 }
 
 void WiFiManager::handleLoginSubmit() {
-    String email = server->arg("email");
-    String password = server->arg("password");
-    
-    String html = "<!DOCTYPE html><html>"
-                "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                "<title>HealthSense Login</title>"
-                "<style>"
-                "body { font-family: Arial, sans-serif; margin: 0; padding: 20px; text-align: center; background-color: #f0f0f0; }"
-                ".container { max-width: 400px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }"
-                "h1 { color: #333; }"
-                ".success { color: #4CAF50; }"
-                ".error { color: #f44336; }"
-                "button { background: #4CAF50; color: white; padding: 10px 15px; border: none; border-radius: 5px; cursor: pointer; margin: 10px 0; width: 100%; }"
-                "button:hover { background: #45a049; }"
-                ".back-btn { background: #2196F3; margin-top: 15px; }"
-                ".back-btn:hover { background: #0b7dda; }"
-                "</style>"
-                "</head>"
-                "<body>"
-                "<div class='container'>"
-                "<h1>Login Status</h1>";
-    
     Serial.println("Attempting to authenticate user");
     Serial.print("Email: ");
-    Serial.println(email);
+    Serial.println(server->arg("email"));
+    
+    // The login request runs on the uplink worker; the page polls /login_status
+    uint32_t jobId = loginJob.getId();
+    if (!loginJob.isRunning()) {
+        loginEmail = server->arg("email");
+        loginPassword = server->arg("password");
+        loginUID = "";
+        loginOnline = isConnected;
+        jobId = uplinkWorker.submit(loginJob, UPLINK_PRIORITY_RESULTS, runLoginJob, this);
+    }
+    if (jobId == 0) {
+        server->send(503, "text/plain", "Unable to start login, please try again");
+        return;
+    }
     
-    // Authenticate user with API
-    bool loginSuccess = authenticateUser(email, password);
+    sendLoginWaitingPage(jobId);
+}
+
+bool WiFiManager::runLoginJob(void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    if (!self->loginOnline) {
+        return false;
+    }
+    return self->authenticateUser(self->loginEmail, self->loginPassword, self->loginUID);
+}
+
+void WiFiManager::sendLoginWaitingPage(uint32_t jobId) {
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_LOGIN_WAITING_TPL_HTML, jobPageValue, jobPageSection, &jobId);
+    page.end();
+}
+
+void WiFiManager::handleLoginStatus() {
+    uint32_t jobId = requestedJobId();
+    JobState state = loginJob.getState(jobId);
     
-    if (loginSuccess) {
-        html += "<p class='success'>Login successful!</p>"
-                "<p>Welcome back, " + email + "!</p>"
-                "<meta http-equiv='refresh' content='2;url=/measurement'>"
-                "<p>You will be redirected to measurement in 2 seconds...</p>";
-        
-        Serial.println("Login successful, user authenticated");
-        
-        // Update connection status and set user as logged in
-        if (updateConnectionStatusCallback) {
-            updateConnectionStatusCallback(isConnected, false, true);
-        }
-        
-        // Initialize sensor if callback exists
-        if (initializeSensorCallback) {
-            initializeSensorCallback();
-        }
-        
-        // Do NOT set isMeasuring=true here - measurement should only start
-        // after user clicks "Start Measuring" and page confirms load
-    } else {
-        html += "<p class='error'>Login failed!</p>"
-                "<p>Invalid email or password. Please try again.</p>"
-                "<form action='/login' method='get'>"
-                "<button type='submit' class='back-btn'>Back to Login</button>"
-                "</form>"
-                "<form action='/mode' method='get'>"
-                "<button type='submit'>Back to Mode Selection</button>"
-                "</form>";
-                
-        Serial.println("Login failed, invalid credentials");
+    if (state == JOB_UNKNOWN) {
+        server->sendHeader("Location", "/login");
+        server->send(302, "text/plain", "");
+        return;
+    }
+    if (state == JOB_RUNNING) {
+        sendLoginWaitingPage(jobId);
+        return;
     }
     
-    html += "</div></body></html>";
-    server->send(200, "text/html", html);
+    // The job has finished, so loginEmail is no longer written to
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_LOGIN_STATUS_TPL_HTML, loginValue, loginSection, this);
+    page.end();
+}
+
+bool WiFiManager::loginSection(const char* name, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    
+    if (strcmp(name, "SUCCESS") == 0) return self->loginJob.succeeded();
+    return false;
+}
+
+void WiFiManager::loginValue(const char* name, TemplateStream& out, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    
+    if (strcmp(name, "EMAIL") == 0) {
+        // User-supplied address
+        out.printEscaped(self->loginEmail.c_str());
+    }
+}
+
+// Pages that only show a job id; context points at the uint32_t id, 0 for none
+bool WiFiManager::jobPageSection(const char* name, void* context) {
+    if (strcmp(name, "JOB") == 0) return *static_cast<uint32_t*>(context) != 0;
+    return false;
+}
+
+void WiFiManager::jobPageValue(const char* name, TemplateStream& out, void* context) {
+    if (strcmp(name, "JOB") == 0) {
+        out.print((int32_t)*static_cast<uint32_t*>(context));
+    }
 }
 
 void WiFiManager::handleGuest() {
@@ -907,25 +908,11 @@ void WiFiManager::handleMeasurement() {
     
     Serial.println("📱 Displaying measurement page - ready for user to start measuring");
     
-    // Simplified CSS to reduce page size
-    String css = "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                 ".container{max-width:400px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                 "h1{color:#333;font-size:20px;margin-top:0}"
-                 ".reading{font-size:20px;margin:15px 0}"
-                 ".hr{color:#f44336}.spo2{color:#2196F3}"
-                 ".status{font-style:italic;color:#757575;margin-bottom:15px;font-size:14px}"
-                 ".complete{color:#4CAF50;font-weight:bold;padding:8px;border:1px solid #4CAF50;border-radius:4px;background:#e8f5e9}"
-                 ".measuring{color:#2196F3;font-weight:bold;padding:8px;border:1px solid #2196F3;border-radius:4px;background:#e3f2fd}"
-                 ".user{color:#4CAF50;font-weight:bold;font-size:14px}.guest{color:#FF9800;font-weight:bold;font-size:14px}"
-                 ".card{border:1px solid #ddd;border-radius:8px;padding:12px;margin:15px 0;background:#f9f9f9}"
-                 "a{color:#2196F3;text-decoration:none;font-weight:bold}a:hover{text-decoration:underline}"
-                 "button{background:#4CAF50;color:white;padding:10px 15px;border:none;border-radius:4px;cursor:pointer;margin:8px 0;width:100%;font-size:16px}";
-    
     String html = "<!DOCTYPE html><html>"
                   "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
                   "<meta charset='UTF-8'>"
                   "<title>Measurement</title>"
-                  "<style>" + css + "</style>"
+                  "<link rel='stylesheet' href='" WEB_STYLE_CSS_URL "'>"
                   "</head>"
                   "<body>"
                   "<div class='container'>"
@@ -950,7 +937,7 @@ void WiFiManager::handleMeasurement() {
     
     // Button to return to mode selection
     html += "<form action='/mode' method='get'>"
-            "<button type='submit' style='background:#f44336'>Back to Mode Select</button>"
+            "<button type='submit' class='back-btn'>Back to Mode Select</button>"
             "</form>";
             
     html += "</div></body></html>";
@@ -1011,150 +998,82 @@ void WiFiManager::handleReconfigWiFi() {
 }
 
 void WiFiManager::handleStatus() {
-    // Use a more lightweight approach with minimal HTML
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<meta charset='UTF-8'>"
-                  "<title>Connection Status</title>"
-                  "<style>"
-                  "body{font-family:Arial,sans-serif;margin:0;padding:10px;background:#f0f0f0;}"
-                  ".container{max-width:400px;margin:0 auto;background:#fff;padding:15px;border-radius:5px;box-shadow:0 1px 5px rgba(0,0,0,.1);}"
-                  "h1{font-size:20px;margin-top:0;}"
-                  ".banner{padding:8px;border-radius:4px;margin:10px 0;}"
-                  ".error{background:#ffebee;color:#d32f2f;border:1px solid #ffcdd2;}"
-                  ".success{background:#e8f5e9;color:#388e3c;border:1px solid #c8e6c9;}"
-                  ".info{font-family:monospace;background:#f9f9f9;padding:10px;border-radius:4px;margin:10px 0;font-size:12px;white-space:pre-wrap;}"
-                  "button{background:#2196F3;color:#fff;padding:8px 12px;border:none;border-radius:4px;cursor:pointer;margin:5px 3px;}"
-                  ".btn-red{background:#f44336;}.btn-orange{background:#FF9800;}.btn-purple{background:#9c27b0;}"
-                  "ul{text-align:left;margin:10px 0;padding-left:20px;font-size:14px;}"
-                  "</style>"
-                  "</head><body><div class='container'>"
-                  "<h1>Connection Status</h1>";
-                  
-    // Add connection status banner (more compact)
-    if (isConnected) {
-        html += "<div class='banner success'><b>✓ Connected</b> to " + userSSID + "</div>";
-    } else {
-        html += "<div class='banner error'><b>✗ Disconnected</b> - ";
-        
-        // Show specific error based on WiFi status (simplified)
-        switch (lastWifiErrorCode) {
-            case WL_NO_SSID_AVAIL: html += "Network not found"; break;
-            case WL_CONNECT_FAILED: html += "Authentication failed"; break;
-            case WL_CONNECTION_LOST: html += "Connection lost"; break;
-            default: html += "Error " + String(lastWifiErrorCode); break;
-        }
-        html += "</div>";
-    }
-    
-    // Basic connection info only (avoid full getConnectionInfo() which is large)
-    html += "<div class='info'>";
-    html += "Mode: " + String(WiFi.getMode() == WIFI_AP ? "AP" : (WiFi.getMode() == WIFI_STA ? "Station" : 
-                            (WiFi.getMode() == WIFI_AP_STA ? "AP+STA" : "Off"))) + "\n";
-    
-    if (isConnected) {
-        html += "IP: " + WiFi.localIP().toString() + "\n";
-        // RSSI should be negative, so use abs() but add negative sign explicitly
-        html += "Signal: -" + String(abs(WiFi.RSSI())) + " dBm\n";
-    }
-    
-    html += "Hotspot IP: " + WiFi.softAPIP().toString() + "\n";
-    html += "Memory: " + String(ESP.getFreeHeap()/1024) + " KB free\n";
-    html += "</div>";
-    
-    html += "<ul>";
-    if (isConnected) {
-        html += "<li>Connect via: " + WiFi.localIP().toString() + "</li>";
-    }
-    html += "<li>Hotspot: " + String(ap_ssid) + " → " + WiFi.softAPIP().toString() + "</li></ul>";
+    // Streamed from a flash template through a fixed buffer, no page-sized String
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_STATUS_TPL_HTML, statusValue, pageSection, this);
+    page.end();
+}
+
+bool WiFiManager::pageSection(const char* name, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
     
-    html += "<form action='/' method='get'><button type='submit'>Home</button></form>";
-    html += "<button onclick='location.reload()' class='btn-orange'>Refresh</button>";
+    if (strcmp(name, "CONNECTED") == 0) return self->isConnected;
+    if (strcmp(name, "LOGGED_IN") == 0) return self->isLoggedIn;
+    if (strcmp(name, "GUEST") == 0) return self->isGuestMode;
+    return false;
+}
+
+void WiFiManager::statusValue(const char* name, TemplateStream& out, void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
     
-    if (!isConnected) {
-        html += "<form action='/wifi' method='get' style='display:inline'><button type='submit' class='btn-purple'>WiFi Setup</button></form>";
+    if (strcmp(name, "SSID") == 0) {
+        out.printEscaped(self->userSSID.c_str());
+    } else if (strcmp(name, "WIFI_ERROR") == 0) {
+        // Show specific error based on WiFi status (simplified)
+        switch (self->lastWifiErrorCode) {
+            case WL_NO_SSID_AVAIL: out.print("Network not found"); break;
+            case WL_CONNECT_FAILED: out.print("Authentication failed"); break;
+            case WL_CONNECTION_LOST: out.print("Connection lost"); break;
+            default: out.print("Error "); out.print((int32_t)self->lastWifiErrorCode); break;
+        }
+    } else if (strcmp(name, "WIFI_MODE") == 0) {
+        wifi_mode_t mode = WiFi.getMode();
+        out.print(mode == WIFI_AP ? "AP" : (mode == WIFI_STA ? "Station" : (mode == WIFI_AP_STA ? "AP+STA" : "Off")));
+    } else if (strcmp(name, "STATION_IP") == 0) {
+        out.print(WiFi.localIP());
+    } else if (strcmp(name, "RSSI") == 0) {
+        // RSSI should be negative; the template adds the sign
+        out.print((int32_t)abs(WiFi.RSSI()));
+    } else if (strcmp(name, "AP_IP") == 0) {
+        out.print(WiFi.softAPIP());
+    } else if (strcmp(name, "AP_SSID") == 0) {
+        out.printEscaped(self->ap_ssid);
+    } else if (strcmp(name, "HEAP_KB") == 0) {
+        out.print((int32_t)(ESP.getFreeHeap() / 1024));
     }
-    
-    html += "</div></body></html>";
-    
-    server->send(200, "text/html", html);
 }
 
 void WiFiManager::handleForceAP() {
     forceAPMode();
     
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<title>HealthSense Force AP Mode</title>"
-                  "<style>"
-                  "body { font-family: Arial, sans-serif; margin: 0; padding: 20px; text-align: center; background-color: #f0f0f0; }"
-                  ".container { max-width: 400px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }"
-                  "h1 { color: #333; }"
-                  ".success { color: #4CAF50; }"
-                  "</style>"
-                  "</head>"
-                  "<body>"
-                  "<div class='container'>"
-                  "<h1>AP Mode Forced</h1>"
-                  "<p class='success'>Device is now in Access Point mode only.</p>"
-                  "<p>WiFi connection has been disconnected.</p>"
-                  "<meta http-equiv='refresh' content='3;url=/'>"
-                  "<p>You will be redirected to home in 3 seconds...</p>"
-                  "</div>"
-                  "</body></html>";
-    
-    server->send(200, "text/html", html);
+    sendWebAsset(WEB_FORCE_AP_HTML);
 }
 
 void WiFiManager::handleNotFound() {
-    // Enhanced captive portal handling
-    Serial.print("Handling not found request for URI: ");
-    Serial.println(server->uri());
-
-    // Special handling for Apple devices captive portal detection
-    if (server->hostHeader() == "captive.apple.com") {
-        Serial.println("Apple captive portal detection - redirecting to success page");
-        server->send(200, "text/html", "<!DOCTYPE html><html><head><title>Success</title></head><body>Success</body></html>");
+    // OS connectivity checks: send the phone to the setup page until WiFi is
+    // configured, afterwards let it believe it is online so it stays on the AP
+    const CaptiveProbe* probe = captivePortal.match(*server);
+    if (probe != nullptr) {
+        captivePortal.answerProbe(*server, *probe, !isConnected);
         return;
     }
     
-    // For Android captive portal detection
-    if (server->hostHeader() == "connectivitycheck.gstatic.com" || 
-        server->hostHeader() == "connectivitycheck.android.com" ||
-        server->hostHeader() == "clients3.google.com") {
-        Serial.println("Android/Google captive portal detection - generating redirect");
-        server->send(200, "text/html", "<!DOCTYPE html><html><head><title>Success</title></head><body>Success</body></html>");
-        return;
-    }
-
     // For all other requests, redirect to our web interface
-    String contentType = "text/html";
-    
-    // Respond with a simple HTML page for browsers
-    String message = "<!DOCTYPE html><html><head><meta charset='UTF-8'>";
-    message += "<meta http-equiv='refresh' content='0;url=http://" + apIP.toString() + "/'>";
-    message += "<title>Redirecting...</title></head>";
-    message += "<body>Redirecting to <a href='http://" + apIP.toString() + "/'>HealthSense Setup</a>...</body></html>";
-    
-    // Set headers to ensure the redirect works and isn't cached
-    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server->sendHeader("Pragma", "no-cache");
-    server->sendHeader("Expires", "-1");
-    server->sendHeader("Location", "http://" + apIP.toString() + "/", true);
-    
-    // Send 302 status with the HTML page as fallback
-    server->send(302, contentType, message);
+    Serial.print("Redirecting unknown URI to portal: ");
+    Serial.println(server->uri());
+    captivePortal.redirect(*server);
 }
 
 void WiFiManager::loop() {
-    // Process DNS requests
-    dnsServer->processNextRequest();
+    // Process DNS requests (no-op when the responder has its own task)
+    dns.loop();
     
     // Ensure WiFi is maintained
     static unsigned long lastWiFiCheckInLoop = 0;
     if (millis() - lastWiFiCheckInLoop > 1000) { // Check every second in loop
         lastWiFiCheckInLoop = millis();
-        if (WiFi.getMode() != WIFI_AP_STA) {
+        if (WiFi.getMode() != WIFI_AP_STA && !connectJob.isRunning()) {
             Serial.println("Fixing WiFi mode in loop - setting to AP+STA");
             WiFi.mode(WIFI_AP_STA);
         }
@@ -1163,9 +1082,19 @@ void WiFiManager::loop() {
     // Handle client requests
     server->handleClient();
     
+    // Apply results of finished background jobs on this task
+    serviceJobs();
+    
+    // Push queued events to /events subscribers and frames to waveform viewers
+    events.loop();
+    waveform.loop();
+    
     // Check WiFi connection status
     checkWiFiConnection();
     
+    // Drop the kept-alive backend connection once idle
+    uplink.loop();
+    
     // Perform periodic memory maintenance
     static unsigned long lastMemCheck = 0;
     if (millis() - lastMemCheck > 30000) { // Every 30 seconds
@@ -1181,9 +1110,8 @@ void WiFiManager::loop() {
             Serial.println(F("Low memory detected! Performing cleanup..."));
             ESP.getFreeHeap(); // This sometimes helps compact heap
             
-            // Close any lingering connections
-            WiFi.disconnect(false); // Don't disable WiFi, just close sockets
-            delay(50); // Short delay to allow cleanup
+            // The uplink's TLS session is the largest buffer we can give back
+            cleanupConnections();
         }
     }
 }
@@ -1246,17 +1174,10 @@ void WiFiManager::saveUserCredentials(String email, String uid) {
     EEPROM.end();
 }
 
-bool WiFiManager::authenticateUser(String email, String password) {
-    if (!isConnected) return false;
-    
-    HTTPClient http;
-    String url = serverURL;
-    if (!url.endsWith("/")) {
-        url += "/";
-    }
-    url += "api/login";
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
+bool WiFiManager::authenticateUser(const String& email, const String& password, String& uid) {
+    UplinkHeader headers[] = {
+        {"Content-Type", "application/json"}
+    };
     
     // Create JSON payload
     DynamicJsonDocument doc(200);
@@ -1265,66 +1186,40 @@ bool WiFiManager::authenticateUser(String email, String password) {
     String payload;
     serializeJson(doc, payload);
     
+    // Only the fields we use are kept while the response streams in
+    char responseUID[64];
+    char errorDetail[64];
+    JsonFieldExtractor response;
+    int uidField = response.addField("uid", responseUID, sizeof(responseUID));
+    int detailField = response.addField("detail", errorDetail, sizeof(errorDetail));
+    
     // Send POST request
-    int httpCode = http.POST(payload);
+    int httpCode = uplink.request("POST", "/api/login", payload, headers, 1, UPLINK_DEFAULT_TIMEOUT_MS, &response);
     Serial.print("Login API response code: ");
     Serial.println(httpCode);
     
     if (httpCode == HTTP_CODE_OK) {
-        // Parse response
-        String response = http.getString();
-        Serial.print("Login API response: ");
-        Serial.println(response);
-        
-        DynamicJsonDocument responseDoc(400);
-        DeserializationError error = deserializeJson(responseDoc, response);
-        
-        if (!error) {
-            // Successful login should have a uid field
-            const char* uid = responseDoc["uid"];
-            if (uid && strlen(uid) > 0) {
-                // Save user credentials
-                saveUserCredentials(email, String(uid));
-                isLoggedIn = true;
-                http.end();
-                return true;
-            } else {
-                Serial.println("Login failed: No valid UID in response");
-            }
-        } else {
-            Serial.print("JSON parse error: ");
-            Serial.println(error.c_str());
+        // Successful login should have a uid field; loop() saves it
+        if (response.isFound(uidField) && responseUID[0] != '\0' && !response.isTruncated(uidField)) {
+            uid = responseUID;
+            return true;
         }
-    } else {
-        // Handle different error cases
-        String response = http.getString();
-        Serial.print("Login failed with response: ");
-        Serial.println(response);
-        
-        // Try to parse error message
-        DynamicJsonDocument errorDoc(400);
-        DeserializationError error = deserializeJson(errorDoc, response);
+        Serial.println("Login failed: No valid UID in response");
+    } else if (response.isFound(detailField)) {
+        // Check for detail field which contains error information
+        Serial.print("Error detail: ");
+        Serial.println(errorDetail);
         
-        if (!error) {
-            // Check for detail field which contains error information
-            const char* errorDetail = errorDoc["detail"];
-            if (errorDetail) {
-                Serial.print("Error detail: ");
-                Serial.println(errorDetail);
-                
-                // Handle specific error cases
-                if (strcmp(errorDetail, "INVALID_LOGIN_CREDENTIALS") == 0) {
-                    Serial.println("Invalid email or password");
-                } else if (strcmp(errorDetail, "Authentication service unavailable") == 0) {
-                    Serial.println("Firebase service is unavailable");
-                } else if (strcmp(errorDetail, "Missing Firebase API key") == 0) {
-                    Serial.println("Server configuration error: Missing Firebase API key");
-                }
-            }
+        // Handle specific error cases
+        if (strcmp(errorDetail, "INVALID_LOGIN_CREDENTIALS") == 0) {
+            Serial.println("Invalid email or password");
+        } else if (strcmp(errorDetail, "Authentication service unavailable") == 0) {
+            Serial.println("Firebase service is unavailable");
+        } else if (strcmp(errorDetail, "Missing Firebase API key") == 0) {
+            Serial.println("Server configuration error: Missing Firebase API key");
         }
     }
     
-    http.end();
     return false;
 }
 
@@ -1334,11 +1229,9 @@ bool WiFiManager::sendMeasurementData(String uid, int32_t heartRate, int32_t spo
     // In guest mode, we don't send data to server
     if (isGuestMode) return true;
     
-    HTTPClient http;
-    String url = serverURL + "/api/measurements";
-    
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
+    UplinkHeader headers[] = {
+        {"Content-Type", "application/json"}
+    };
     
     // Create JSON payload
     DynamicJsonDocument doc(200);
@@ -1349,7 +1242,7 @@ bool WiFiManager::sendMeasurementData(String uid, int32_t heartRate, int32_t spo
     serializeJson(doc, payload);
     
     // Send POST request
-    int httpCode = http.POST(payload);
+    int httpCode = uplink.request("POST", "/api/measurements", payload, headers, 1);
     Serial.print("Measurement API response code: ");
     Serial.println(httpCode);
     
@@ -1357,20 +1250,14 @@ bool WiFiManager::sendMeasurementData(String uid, int32_t heartRate, int32_t spo
         Serial.println("Measurement data sent successfully");
     } else {
         Serial.print("Failed to send measurement data: ");
-        Serial.println(http.errorToString(httpCode));
+        Serial.println(HTTPClient::errorToString(httpCode));
     }
     
-    http.end();
     return (httpCode == HTTP_CODE_OK);
 }
 
 
 bool WiFiManager::sendDeviceData(int32_t heartRate, int32_t spo2, String userId) {
-    if (!isConnected) {
-        Serial.println(F("❌ Not connected to WiFi, cannot send data"));
-        return false;
-    }
-    
     Serial.println(F("🌐 Preparing to send device data..."));
     
     // Free memory before HTTP request
@@ -1378,41 +1265,22 @@ bool WiFiManager::sendDeviceData(int32_t heartRate, int32_t spo2, String userId)
     Serial.print(F("Memory before request: "));
     Serial.println(ESP.getFreeHeap());
     
-    HTTPClient http;
-    String url = serverURL;
-    if (!url.endsWith("/")) {
-        url += "/";
-    }
-    url += "api/records";
-    
-    // Simplify URL logging
-    Serial.print(F("URL: "));
-    Serial.println(url);
-    
-    // Set shorter timeout to prevent hanging
-    http.setTimeout(5000); // 5 second timeout
-    
-    // Simple error handling for HTTP begin
-    if (!http.begin(url)) {
-        Serial.println(F("HTTP init failed"));
-        return false;
-    }
-    
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("X-Device-Id", DEVICE_ID);
-    http.addHeader("X-Device-Secret", DEVICE_SECRET);
+    UplinkHeader headers[] = {
+        {"Content-Type", "application/json"},
+        {"X-Device-Id", DEVICE_ID},
+        {"X-Device-Secret", DEVICE_SECRET},
+        {"X-User-Id", userId.c_str()}
+    };
     
     // Add user ID header if provided
-    if (userId.length() > 0) {
-        http.addHeader("X-User-Id", userId);
-    }
+    int headerCount = userId.length() > 0 ? 4 : 3;
     
     // Simplify JSON creation - use less memory
     String payload = "{\"heart_rate\":" + String(heartRate) + ",\"spo2\":" + String(abs(spo2)) + "}";
     
     // Send POST request with timeout
-    Serial.println(F("Sending POST request..."));
-    int httpCode = http.POST(payload);
+    Serial.println(F("Sending POST /api/records..."));
+    int httpCode = uplink.request("POST", "/api/records", payload, headers, headerCount, 5000);
     
     bool success = false;
     if (httpCode == HTTP_CODE_OK) {
@@ -1423,11 +1291,6 @@ bool WiFiManager::sendDeviceData(int32_t heartRate, int32_t spo2, String userId)
         Serial.println(httpCode);
     }
     
-    // Make sure to end the HTTP connection
-    http.end();
-    WiFi.disconnect(false); // Keep WiFi connected but close current sockets
-    delay(50); // Short delay to allow socket cleanup
-    
     Serial.print(F("Memory after request: "));
     Serial.println(ESP.getFreeHeap());
     return success;
@@ -1451,12 +1314,27 @@ void WiFiManager::sendSensorData(int32_t heartRate, int32_t spo2) {
     
     // Only send data to API server if user is logged in (not guest mode)
     if (isLoggedIn && !isGuestMode && userUID.length() > 0) {
-        Serial.println(F("📤 Sending measurement data to server (User mode)"));
-        bool success = sendDeviceData(heartRate, spo2, userUID);
-        if (success) {
-            Serial.println(F("✅ Data sent successfully to API"));
+        // Queued on flash first so it survives being offline; the drain job uploads it
+        uint32_t sequence = measurementQueue.append(heartRate, spo2, userUID);
+        if (sequence != 0) {
+            Serial.print(F("📤 Measurement #"));
+            Serial.print(sequence);
+            Serial.println(isConnected ? F(" queued for upload") : F(" queued until WiFi is back"));
+            uploader.noteQueued();
+            drainRequested = true;
+            freshResult = true;
+        } else if (!directJob.isRunning()) {
+            // Queue unavailable (flash not mounted): fall back to a direct upload
+            directRecord.heartRate = heartRate;
+            directRecord.spo2 = spo2;
+            strncpy(directRecord.userId, userUID.c_str(), MEASUREMENT_QUEUE_USER_ID_SIZE - 1);
+            directRecord.userId[MEASUREMENT_QUEUE_USER_ID_SIZE - 1] = '\0';
+            directOnline = isConnected;
+            if (uplinkWorker.submit(directJob, UPLINK_PRIORITY_RESULTS, runDirectJob, this) == 0) {
+                Serial.println(F("❌ Failed to send data to API"));
+            }
         } else {
-            Serial.println(F("❌ Failed to send data to API"));
+            Serial.println(F("❌ Previous upload still pending, measurement not sent"));
         }
         
         // Call callback if it exists
@@ -1505,13 +1383,7 @@ void WiFiManager::sendSensorData(int32_t heartRate, int32_t spo2) {
     // and automatically redirect to the results page
 }
 
-bool WiFiManager::getAIHealthSummary(String& summary) {
-    if (!isConnected) {
-        Serial.println(F("Not connected to WiFi"));
-        summary = "No WiFi connection";
-        return false;
-    }
-    
+bool WiFiManager::getAIHealthSummary(String& summary, AISummaryFetch& fetch) {
     Serial.println(F("Requesting AI summary..."));
     
     // Clean up memory first
@@ -1519,57 +1391,45 @@ bool WiFiManager::getAIHealthSummary(String& summary) {
     Serial.print(F("Memory before: "));
     Serial.println(ESP.getFreeHeap());
     
-    HTTPClient http;
-    
-    // Build URL more simply
-    String url = serverURL;
-    if (!url.endsWith("/")) url += "/";
-    url += "api/ai/sumerize";
-    
-    // Set shorter timeout
-    http.setTimeout(7000); // 7 seconds timeout
-    
-    // Initialize HTTP client with simple error checking
-    if (!http.begin(url)) {
-        Serial.println(F("HTTP init failed"));
-        summary = "HTTP connection error";
-        return false;
+    // Add essential headers only; If-None-Match revalidates a cached summary
+    bool conditional = fetch.ifNoneMatch[0] != '\0';
+    UplinkHeader headers[3];
+    int headerCount = 0;
+    headers[headerCount++] = {"X-Device-Id", DEVICE_ID};
+    if (fetch.userId.length() > 0) {
+        headers[headerCount++] = {"X-User-Id", fetch.userId.c_str()};
     }
-    
-    // Add essential headers only
-    http.addHeader("X-Device-Id", DEVICE_ID);
-    if (!isGuestMode && isLoggedIn && userUID.length() > 0) {
-        http.addHeader("X-User-Id", userUID);
+    if (conditional) {
+        headers[headerCount++] = {"If-None-Match", fetch.ifNoneMatch};
     }
     
+    // The summary is unescaped straight off the connection into a fixed buffer,
+    // so memory use doesn't depend on the response size
+    char summaryText[AI_SUMMARY_MAX_LENGTH + 1];
+    JsonFieldExtractor response;
+    int summaryField = response.addField("summary", summaryText, sizeof(summaryText));
+    
     // Send GET request
     Serial.println(F("Sending GET request"));
-    int httpCode = http.GET();
+    String etag;
+    int httpCode = uplink.request("GET", "/api/ai/sumerize", "", headers, headerCount, 7000, &response, &etag);
     
     bool success = false;
     
-    if (httpCode == HTTP_CODE_OK) {
-        // Use manual string parsing instead of JSON library to save memory
-        String response = http.getString();
-        Serial.print(F("Response OK, length: "));
-        Serial.println(response.length());
-        
-        // Simple string extraction - less memory intensive than JSON parsing
-        int summaryStart = response.indexOf("\"summary\":\"");
-        if (summaryStart > 0) {
-            summaryStart += 11; // Length of "summary":"
-            int summaryEnd = response.indexOf("\"", summaryStart);
-            if (summaryEnd > summaryStart) {
-                summary = response.substring(summaryStart, summaryEnd);
-                success = true;
-                
-                // Limit summary length to save memory
-                if (summary.length() > 500) {
-                    summary = summary.substring(0, 500) + "...";
-                }
-            } else {
-                summary = "Unable to read AI data";
+    if (httpCode == HTTP_CODE_NOT_MODIFIED && conditional) {
+        // summary still holds the cached text
+        Serial.println(F("AI summary unchanged"));
+        fetch.notModified = true;
+        success = true;
+    } else if (httpCode == HTTP_CODE_OK) {
+        strncpy(fetch.etag, etag.c_str(), AI_SUMMARY_ETAG_SIZE - 1);
+        fetch.etag[AI_SUMMARY_ETAG_SIZE - 1] = '\0';
+        if (response.isFound(summaryField)) {
+            summary = summaryText;
+            if (response.isTruncated(summaryField)) {
+                summary += "...";
             }
+            success = true;
         } else {
             summary = "No analysis results found";
         }
@@ -1579,27 +1439,16 @@ bool WiFiManager::getAIHealthSummary(String& summary) {
         Serial.println(httpCode);
     }
     
-    // Make sure to close connection and clean up sockets
-    http.end();
-    WiFi.disconnect(false); // Keep WiFi connected but close socket
-    delay(50); // Give some time for socket cleanup
-    
     Serial.print(F("Memory after: "));
     Serial.println(ESP.getFreeHeap());
     
     return success;
 }
 
-bool WiFiManager::requestAIHealthSummary(String& summary) {
+bool WiFiManager::requestAIHealthSummary(String& summary, AISummaryFetch& fetch) {
     Serial.println(F("🔄 requestAIHealthSummary() called"));
     
-    if (!isConnected) {
-        summary = "Error: No WiFi connection";
-        Serial.println(F("❌ Not connected to WiFi"));
-        return false;
-    }
-    
-    bool success = getAIHealthSummary(summary);
+    bool success = getAIHealthSummary(summary, fetch);
     
     if (success) {
         Serial.println(F("✅ AI health summary obtained successfully"));
@@ -1691,35 +1540,7 @@ void WiFiManager::forceAPMode() {
 void WiFiManager::handleAIAnalysis() {
     // If in guest mode, show registration prompt
     if (isGuestMode) {
-        String css = "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                     ".container{max-width:450px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                     "h1{color:#333;font-size:20px;margin-top:0}"
-                     ".message{padding:15px;background:#fffde7;border:1px solid #fff59d;border-radius:4px;margin:15px 0}"
-                     "button{background:#4CAF50;color:white;padding:10px 15px;border:none;border-radius:4px;cursor:pointer;margin:8px 3px;font-weight:bold;min-width:140px}"
-                     ".btn-blue{background:#2196F3}.btn-red{background:#f44336}"
-                     "a{color:#2196F3;text-decoration:none;font-weight:bold}a:hover{text-decoration:underline}";
-        
-        String html = "<!DOCTYPE html><html>"
-                      "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                      "<meta charset='UTF-8'>"
-                      "<title>AI Analysis</title>"
-                      "<style>" + css + "</style>"
-                      "</head><body><div class='container'>"
-                      "<h1>AI Analysis</h1>"
-                      "<div class='message'>"
-                      "<h3>Feature Available with Registration</h3>"
-                      "<p>AI health analysis is only available for registered users. This feature provides personalized health insights based on your measurements.</p>"
-                      "<p>To use this feature, please register an account at: <br><a href='https://iot.newnol.io.vn' target='_blank'>HealthSense Portal</a></p>"
-                      "</div>"
-                      "<div style='margin-top:20px'>"
-                      "<form action='/measurement_info' method='get' style='display:inline-block'>"
-                      "<button type='submit' class='btn-blue'>Back to Results</button></form>"
-                      "<form action='/mode' method='get' style='display:inline-block'>"
-                      "<button type='submit' class='btn-red'>Mode Select</button></form>"
-                      "</div>"
-                      "</div></body></html>";
-        
-        server->send(200, "text/html", html);
+        sendWebAsset(WEB_AI_GUEST_HTML);
         return;
     }
     
@@ -1730,77 +1551,203 @@ void WiFiManager::handleAIAnalysis() {
         return;
     }
     
-    // CSS for the loading page
-    String css = "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                 ".container{max-width:400px;margin:0 auto;background:white;padding:20px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                 "h1{color:#333;font-size:22px;margin-top:0}"
-                 ".loader{width:60px;height:60px;border-radius:50%;border:5px solid #f3f3f3;border-top:5px solid #3498db;animation:spin 1.2s linear infinite;margin:20px auto}"
-                 "@keyframes spin{0%{transform:rotate(0deg)}100%{transform:rotate(360deg)}}";
-    
-    // Show loading page first
-    String loadingPage = "<!DOCTYPE html><html>"
-                         "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                         "<meta charset='UTF-8'>"
-                         "<meta http-equiv='refresh' content='1;url=/ai_analysis_result'>"
-                         "<title>Loading Analysis</title>"
-                         "<style>" + css + "</style>"
-                         "</head><body><div class='container'>"
-                         "<h1>Preparing AI Analysis</h1>"
-                         "<div class='loader'></div>"
-                         "<p>Analyzing your health data...</p>"
-                         "<p>Please wait while we process your measurements.</p>"
-                         "</div></body></html>";
-    
-    // Send loading page immediately
+    // The summary only changes once new measurements reached the server: a cached
+    // one for the same upload state is shown at once, and refreshed in the
+    // background when it has passed its TTL
+    if (aiCache.lookup(getAIUserKey(), measurementQueue.getAckedSequence())) {
+        if (aiCache.isStale() && !aiJob.isRunning()) {
+            startAIJob(true);
+        }
+        if (handleAIAnalysisCallback) {
+            handleAIAnalysisCallback(aiCache.getSummary());
+        }
+        sendAIResultPage(aiCache.getSummary());
+        return;
+    }
+    
+    // A running fetch for another key (an older upload state, the previous user)
+    // or a background refresh would show the wrong summary: let it finish, and
+    // have the page come back here to start a fresh one
+    if (aiJob.isRunning() && (aiFetch.revalidation || !isAIFetchCurrent())) {
+        sendAIWaitingPage(0);
+        return;
+    }
+    
+    // The cloud request takes several seconds; run it on the job task and let the page poll
+    uint32_t jobId = aiJob.isRunning() ? aiJob.getId() : startAIJob(false);
+    if (jobId == 0) {
+        server->send(503, "text/plain", "Unable to start AI analysis, please try again");
+        return;
+    }
+    
+    sendAIWaitingPage(jobId);
+}
+
+uint32_t WiFiManager::startAIJob(bool revalidation) {
+    // aiSummary and aiFetch are free: the job is not running
+    aiCache.prepareFetch(aiFetch, getAIUserKey(), measurementQueue.getAckedSequence(), revalidation);
+    aiSummary = revalidation ? aiCache.getSummary() : String();
+    aiOnline = isConnected;
+    return uplinkWorker.submit(aiJob, UPLINK_PRIORITY_AI, runAIJob, this);
+}
+
+// True if aiFetch was prepared for the current cache key
+bool WiFiManager::isAIFetchCurrent() const {
+    return aiFetch.userId == getAIUserKey() && aiFetch.sequence == measurementQueue.getAckedSequence();
+}
+
+// The user the AI summary is fetched for; empty (device-wide) unless signed in.
+// prepareFetch() copies it into aiFetch, which also carries the X-User-Id header.
+String WiFiManager::getAIUserKey() const {
+    return (!isGuestMode && isLoggedIn) ? userUID : String();
+}
+
+bool WiFiManager::runAIJob(void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    if (!self->aiOnline) {
+        self->aiSummary = "Error: No WiFi connection";
+        Serial.println(F("❌ Not connected to WiFi"));
+        return false;
+    }
+    bool success = self->requestAIHealthSummary(self->aiSummary, self->aiFetch);
+    
+    if (!success) {
+        self->aiSummary = "Unable to retrieve analysis. Please check your connection and try again.";
+    }
+    return success;
+}
+
+bool WiFiManager::runDirectJob(void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    const QueuedMeasurement& record = self->directRecord;
+    if (!self->directOnline) {
+        Serial.println(F("❌ Not connected to WiFi, cannot send data"));
+        return false;
+    }
+    bool success = self->sendDeviceData(record.heartRate, record.spo2, String(record.userId));
+    
+    Serial.println(success ? F("✅ Data sent successfully to API") : F("❌ Failed to send data to API"));
+    return success;
+}
+
+bool WiFiManager::runDrainJob(void* context) {
+    WiFiManager* self = static_cast<WiFiManager*>(context);
+    
+    // One batch per job; records are only acknowledged once the server accepted them
+    return self->uploader.uploadBatch() >= 0;
+}
+
+void WiFiManager::sendAIWaitingPage(uint32_t jobId) {
+    // Without a job of its own the page goes back to /ai_analysis
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_AI_WAITING_TPL_HTML, jobPageValue, jobPageSection, &jobId);
+    page.end();
+}
+
+void WiFiManager::handleAIAnalysisResult() {
+    uint32_t jobId = requestedJobId();
+    JobState state = aiJob.getState(jobId);
+    
+    if (state == JOB_UNKNOWN) {
+        server->sendHeader("Location", "/ai_analysis");
+        server->send(302, "text/plain", "");
+        return;
+    }
+    if (state == JOB_RUNNING) {
+        sendAIWaitingPage(jobId);
+        return;
+    }
+    
+    sendAIResultPage(aiSummary);
+}
+
+void WiFiManager::sendAIResultPage(const String& summary) {
     server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server->send(200, "text/html", loadingPage);
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_AI_RESULT_TPL_HTML, aiResultValue, nullptr, (void*)&summary);
+    page.end();
+}
+
+void WiFiManager::aiResultValue(const char* name, TemplateStream& out, void* context) {
+    if (strcmp(name, "SUMMARY") == 0) {
+        // Server-supplied text, shown as plain text
+        out.printEscaped(static_cast<const String*>(context)->c_str());
+    }
+}
+
+void WiFiManager::serviceJobs() {
+    if (connectJob.takeCompletion()) {
+        if (!connectJob.succeeded()) {
+            lastWifiErrorCode = pendingWifiErrorCode;
+        }
+        finishWiFiConnection(connectJob.succeeded());
+    }
     
-    // Register handler for the result page that will be loaded after redirect
-    server->on("/ai_analysis_result", [this]() {
-        String aiSummary;
-        bool success = requestAIHealthSummary(aiSummary);
-        
-        if (!success) {
-            aiSummary = "Unable to retrieve analysis. Please check your connection and try again.";
+    if (aiJob.takeCompletion()) {
+        if (aiJob.succeeded()) {
+            aiCache.update(aiFetch, aiSummary);
         }
-        
-        // CSS for the results page
-        String css = "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                     ".container{max-width:500px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                     "h1{color:#333;font-size:22px;margin-top:0}"
-                     ".summary{text-align:left;padding:15px;background:#f9f9f9;border-radius:4px;margin:15px 0;font-size:15px;line-height:1.6}"
-                     "button{background:#4CAF50;color:white;padding:10px 15px;border:none;border-radius:4px;cursor:pointer;margin:5px;font-weight:bold;min-width:120px}"
-                     ".btn-blue{background:#2196F3}.btn-red{background:#f44336}"
-                     ".note{font-size:12px;color:#666;margin-top:20px;font-style:italic;border-top:1px solid #eee;padding-top:10px}";
-        
-        // HTML response with consistent styling
-        String html = "<!DOCTYPE html><html>"
-                    "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                    "<meta charset='UTF-8'>"
-                    "<title>AI Health Analysis</title>"
-                    "<style>" + css + "</style>"
-                    "</head><body><div class='container'>"
-                    "<h1>AI Health Analysis</h1>"
-                    "<div class='summary'>" + aiSummary + "</div>"
-                    "<div style='margin-top:20px'>"
-                    "<form action='/measurement_info' method='get' style='display:inline-block'>"
-                    "<button type='submit' class='btn-blue'>Back to Results</button></form>"
-                    "<form action='/continue_measuring' method='get' style='display:inline-block'>"
-                    "<button type='submit'>New Measurement</button></form>"
-                    "<form action='/mode' method='get' style='display:inline-block'>"
-                    "<button type='submit' class='btn-red'>Mode Select</button></form>"
-                    "</div>"
-                    "<p class='note'>This analysis is for informational purposes only and does not replace professional medical advice.</p>"
-                    "</div></body></html>";
-        
-        server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-        server->send(200, "text/html", html);
-        
-        // Display the AI health summary on the device using the callback
-        if (handleAIAnalysisCallback) {
+        // Display the AI health summary on the device using the callback; a
+        // background refresh of a summary already shown, or a fetch for a key
+        // that has moved on meanwhile, stays silent
+        if (!aiFetch.revalidation && isAIFetchCurrent() && handleAIAnalysisCallback) {
             handleAIAnalysisCallback(aiSummary);
         }
-    });
+    }
+    
+    if (loginJob.takeCompletion()) {
+        loginPassword = "";
+        if (loginJob.succeeded()) {
+            Serial.println("Login successful, user authenticated");
+            saveUserCredentials(loginEmail, loginUID);
+            
+            // Update connection status and set user as logged in
+            if (updateConnectionStatusCallback) {
+                updateConnectionStatusCallback(isConnected, false, true);
+            }
+            
+            // Initialize sensor if callback exists
+            if (initializeSensorCallback) {
+                initializeSensorCallback();
+            }
+        } else {
+            Serial.println("Login failed, invalid credentials");
+        }
+    }
+    
+    directJob.takeCompletion();
+    
+    // Upload queued measurements once a batch is due (UPLOAD_BATCH_MAX records
+    // or UPLOAD_BATCH_WINDOW_MS after the first), when the link comes back, and
+    // batch after batch while they go through; after a failure wait
+    // MEASUREMENT_QUEUE_RETRY_MS before trying again. A fresh result outranks
+    // the AI summary on the uplink worker, an old backlog does not.
+    if (drainJob.takeCompletion()) {
+        drainRequested = drainJob.succeeded();
+    }
+    if (isConnected && !drainOnline) {
+        drainRequested = true;
+    }
+    drainOnline = isConnected;
+    
+    if (isConnected && !drainJob.isRunning() && !connectJob.isRunning() &&
+        (drainRequested || millis() - lastDrainAttempt > MEASUREMENT_QUEUE_RETRY_MS)) {
+        uint32_t pending = measurementQueue.pending();
+        if (pending == 0) {
+            drainRequested = false;
+            uploadForced = false;
+        } else if (uploadForced || uploader.isDue(pending)) {
+            drainRequested = false;
+            uploadForced = false;
+            lastDrainAttempt = millis();
+            UplinkPriority priority = freshResult ? UPLINK_PRIORITY_RESULTS : UPLINK_PRIORITY_TELEMETRY;
+            freshResult = false;
+            uplinkWorker.submit(drainJob, priority, runDrainJob, this);
+        }
+    }
 }
 
 void WiFiManager::handleReturnToMeasurement() {
@@ -1824,15 +1771,355 @@ void WiFiManager::handleReturnToMeasurement() {
     server->send(302, "text/plain", "");
 }
 
-void WiFiManager::cleanupConnections() {
-    // Close any pending HTTP connections and sockets
-    WiFi.disconnect(false); // Keep WiFi connected but close current sockets
+bool WiFiManager::dispatch(HTTPMethod method, const char* path, bool execute) {
+    static_assert(routesSorted(routes, ROUTE_COUNT), "WiFiManager::routes must be sorted by path");
+    
+    int index = findByPath(routes, ROUTE_COUNT, path, [](const Route& route) { return route.path; });
+    if (index >= 0) {
+        const Route& route = routes[index];
+        if (route.method != HTTP_ANY && route.method != method) {
+            return false;
+        }
+        if (execute) {
+            (this->*route.handler)();
+        }
+        return true;
+    }
     
-    // Let the system process the disconnect
-    delay(100);
+    // Static assets compiled into flash (generated table, also sorted by path)
+    index = findByPath(WEB_STATIC_ROUTES, WEB_STATIC_ROUTE_COUNT, path,
+                       [](const WebAsset* asset) { return asset->path; });
+    if (index >= 0 && method == HTTP_GET) {
+        if (execute) {
+            sendWebAsset(*WEB_STATIC_ROUTES[index]);
+        }
+        return true;
+    }
+    return false;
+}
+
+void WiFiManager::handleFavicon() {
+    server->send(200, "image/x-icon", "");
+}
+
+void WiFiManager::sendWebAsset(const WebAsset& asset) {
+    if (asset.immutable) {
+        // The URL carries a content hash, so a new build changes the URL
+        server->sendHeader("Cache-Control", "public, max-age=31536000, immutable");
+    } else {
+        // Browsers keep the page but revalidate it on every view
+        server->sendHeader("Cache-Control", "no-cache");
+    }
+    server->sendHeader("ETag", asset.etag);
     
-    // Force garbage collection
-    ESP.getFreeHeap();
+    // Unchanged since the browser's copy: headers only
+    if (server->header("If-None-Match").indexOf(asset.etag) >= 0) {
+        server->send(304);
+        return;
+    }
+    
+    // Served straight from flash, already compressed: no heap copies, ~40% of the bytes
+    server->sendHeader("Content-Encoding", "gzip");
+    server->send_P(200, asset.contentType, (const char*)asset.data, asset.length);
+}
+
+// snprintf returns the length it wanted to write; keep the running offset inside
+// the buffer so a truncated document never indexes past it
+static int clampJsonLength(int len, size_t size) {
+    return (len < (int)size) ? len : (int)size - 1;
+}
+
+void WiFiManager::handleProbes() {
+    // Per-probe state as JSON, built in a fixed buffer
+    char json[640];
+    int len = snprintf(json, sizeof(json), "{\"probes\":[");
+    
+    for (int i = 0; i < sensorScheduler.getProbeCount() && len < (int)sizeof(json); i++) {
+        SensorManager* probe = sensorScheduler.getProbe(i);
+        len += snprintf(json + len, sizeof(json) - len,
+                        "%s{\"id\":%d,\"ready\":%s,\"idle\":%s,\"measuring\":%s,\"complete\":%s,"
+                        "\"hr\":%ld,\"hr_valid\":%s,\"spo2\":%ld,\"spo2_valid\":%s,"
+                        "\"avg_hr\":%ld,\"avg_spo2\":%ld,\"valid_readings\":%d,"
+                        "\"samples\":%lu,\"hops\":%lu}",
+                        i > 0 ? "," : "", i,
+                        probe->isReady() ? "true" : "false",
+                        probe->isProximityIdle() ? "true" : "false",
+                        probe->isMeasurementInProgress() ? "true" : "false",
+                        probe->isMeasurementReady() ? "true" : "false",
+                        (long)probe->getHeartRate(), probe->isHeartRateValid() ? "true" : "false",
+                        (long)abs(probe->getSPO2()), probe->isSPO2Valid() ? "true" : "false",
+                        (long)probe->getAveragedHR(), (long)abs(probe->getAveragedSpO2()),
+                        probe->getValidReadingCount(),
+                        (unsigned long)sensorScheduler.getSamplesAcquired(i),
+                        (unsigned long)sensorScheduler.getHopsProcessed(i));
+        len = clampJsonLength(len, sizeof(json));
+    }
+    
+    if (len < (int)sizeof(json)) {
+        snprintf(json + len, sizeof(json) - len, "]}");
+    }
+    
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server->send(200, "application/json", json);
+}
+
+void WiFiManager::handleDiagnostics() {
+    // Acquisition timing and loss counters per probe; ?reset=1 clears them after reporting
+    char json[768];
+    int len = snprintf(json, sizeof(json), "{\"sample_period_us\":%lu,\"probes\":[", (unsigned long)SAMPLE_PERIOD_US);
+    bool reset = server->hasArg("reset") && server->arg("reset") == "1";
+    
+    for (int i = 0; i < sensorScheduler.getProbeCount() && len < (int)sizeof(json); i++) {
+        SensorManager* probe = sensorScheduler.getProbe(i);
+        const SensorDiagnostics& diag = probe->getDiagnostics();
+        len += snprintf(json + len, sizeof(json) - len,
+                        "%s{\"id\":%d,\"samples\":%lu,\"dropped\":%lu,\"fifo_overflows\":%lu,"
+                        "\"interpolated\":%lu,\"windows_invalidated\":%lu,\"max_interval_us\":%lu,"
+                        "\"clock_corrections\":%lu,\"window_clean\":%s,\"jitter_histogram\":[",
+                        i > 0 ? "," : "", i,
+                        (unsigned long)diag.samplesAcquired, (unsigned long)diag.samplesDropped,
+                        (unsigned long)diag.fifoOverflows, (unsigned long)diag.samplesInterpolated,
+                        (unsigned long)diag.windowsInvalidated, (unsigned long)diag.maxIntervalUs,
+                        (unsigned long)diag.clockCorrections, probe->isWindowClean() ? "true" : "false");
+        len = clampJsonLength(len, sizeof(json));
+        for (int b = 0; b < JITTER_BUCKET_COUNT && len < (int)sizeof(json); b++) {
+            len += snprintf(json + len, sizeof(json) - len, "%s%lu",
+                            b > 0 ? "," : "", (unsigned long)diag.jitterHistogram[b]);
+            len = clampJsonLength(len, sizeof(json));
+        }
+        if (len < (int)sizeof(json)) {
+            len += snprintf(json + len, sizeof(json) - len, "]}");
+            len = clampJsonLength(len, sizeof(json));
+        }
+        if (reset) {
+            probe->resetDiagnostics();
+        }
+    }
+    
+    if (len < (int)sizeof(json)) {
+        snprintf(json + len, sizeof(json) - len, "]}");
+    }
+    
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server->send(200, "application/json", json);
+}
+
+// Dotted quad into a caller-provided buffer, so the JSON document can reference it without a copy
+static const char* formatIP(char* out, size_t size, const IPAddress& ip) {
+    snprintf(out, size, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return out;
+}
+
+static void addMeasurementProgress(JsonDocument& doc) {
+    extern SensorManager sensorManager;
+    doc["measuring"] = sensorManager.isMeasurementInProgress();
+    doc["complete"] = sensorManager.isMeasurementReady();
+    doc["finger"] = sensorManager.isFingerDetected();
+    doc["valid_readings"] = sensorManager.getValidReadingCount();
+    doc["required_readings"] = REQUIRED_VALID_READINGS;
+    doc["hr"] = sensorManager.getHeartRate();
+    doc["hr_valid"] = sensorManager.isHeartRateValid();
+    doc["spo2"] = (int32_t)abs(sensorManager.getSPO2());
+    doc["spo2_valid"] = sensorManager.isSPO2Valid();
+}
+
+void WiFiManager::sendApiJson(int code, const JsonDocument& doc) {
+    // Serialized into a fixed buffer and sent straight from it, no String is built
+    char json[API_RESPONSE_BUFFER];
+    size_t length = serializeJson(doc, json, sizeof(json));
+    if (doc.overflowed() || length >= sizeof(json) - 1) {
+        Serial.println(F("⚠️ API response truncated, raise API_JSON_CAPACITY/API_RESPONSE_BUFFER"));
+    }
+    
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server->send_P(code, "application/json", json, length);
+}
+
+void WiFiManager::sendApiError(int code, const char* error) {
+    StaticJsonDocument<64> doc;
+    doc["error"] = error;
+    sendApiJson(code, doc);
+}
+
+void WiFiManager::handleApiStatus() {
+    extern SensorManager sensorManager;
+    StaticJsonDocument<API_JSON_CAPACITY> doc;
+    char stationIP[16];
+    char accessPointIP[16];
+    
+    doc["api"] = 1;
+    doc["device_id"] = DEVICE_ID;
+    doc["uptime_ms"] = millis();
+    doc["free_heap"] = ESP.getFreeHeap();
+    
+    JsonObject wifi = doc.createNestedObject("wifi");
+    wifi["connected"] = isConnected;
+    wifi["ssid"] = (const char*)userSSID.c_str();
+    wifi["ip"] = (const char*)formatIP(stationIP, sizeof(stationIP), WiFi.localIP());
+    wifi["rssi"] = isConnected ? WiFi.RSSI() : 0;
+    wifi["ap_active"] = apModeActive;
+    wifi["ap_ip"] = (const char*)formatIP(accessPointIP, sizeof(accessPointIP), apIP);
+    
+    JsonObject session = doc.createNestedObject("session");
+    session["guest"] = isGuestMode;
+    session["logged_in"] = isLoggedIn;
+    
+    JsonObject sensor = doc.createNestedObject("sensor");
+    sensor["ready"] = sensorManager.isReady();
+    sensor["finger"] = sensorManager.isFingerDetected();
+    sensor["measuring"] = sensorManager.isMeasurementInProgress();
+    sensor["complete"] = sensorManager.isMeasurementReady();
+    
+    // The fields above are the first probe; every probe, including it, is listed here
+    JsonArray probes = sensor.createNestedArray("probes");
+    for (int i = 0; i < sensorScheduler.getProbeCount(); i++) {
+        SensorManager* probe = sensorScheduler.getProbe(i);
+        JsonObject entry = probes.createNestedObject();
+        entry["ready"] = probe->isReady();
+        entry["finger"] = probe->isFingerDetected();
+        entry["measuring"] = probe->isMeasurementInProgress();
+        entry["complete"] = probe->isMeasurementReady();
+    }
+    
+    JsonObject dnsStats = doc.createNestedObject("dns");
+    dnsStats["queries"] = dns.getQueries();
+    dnsStats["answered"] = dns.getAnswered();
+    dnsStats["nxdomain"] = dns.getNxDomain();
+    dnsStats["dropped"] = dns.getDropped();
+    
+    JsonObject uplinkStats = doc.createNestedObject("uplink");
+    uplinkStats["open"] = uplink.isOpen();
+    uplinkStats["requests"] = uplink.getRequests();
+    uplinkStats["connections"] = uplink.getConnections();
+    uplinkStats["reused"] = uplink.getReused();
+    uplinkStats["queued"] = uplinkWorker.getQueued();
+    uplinkStats["rejected"] = uplinkWorker.getRejected();
+    
+    JsonObject queue = doc.createNestedObject("queue");
+    queue["pending"] = measurementQueue.pending();
+    queue["last_sequence"] = measurementQueue.getLastSequence();
+    queue["dropped"] = measurementQueue.getDropped();
+    queue["uploaded"] = uploader.getUploaded();
+    queue["requests"] = uploader.getRequests();
+    queue["bytes"] = uploader.getBytes();
+    
+    JsonObject aiCacheStats = doc.createNestedObject("ai_cache");
+    aiCacheStats["hits"] = aiCache.getHits();
+    aiCacheStats["misses"] = aiCache.getMisses();
+    aiCacheStats["revalidations"] = aiCache.getRevalidations();
+    aiCacheStats["not_modified"] = aiCache.getNotModified();
+    
+    JsonObject jobs = doc.createNestedObject("jobs");
+    jobs["wifi_connect"] = connectJob.isRunning();
+    jobs["ai_summary"] = aiJob.isRunning();
+    jobs["login"] = loginJob.isRunning();
+    jobs["queue_drain"] = drainJob.isRunning();
+    
+    sendApiJson(200, doc);
+}
+
+void WiFiManager::handleApiMeasurement() {
+    extern SensorManager sensorManager;
+    int code = 200;
+    
+    if (server->method() == HTTP_POST) {
+        // Same rule as the HTML flow: a session (guest or logged in) must be chosen first
+        if (!isGuestMode && !isLoggedIn) {
+            sendApiError(403, "no_session");
+            return;
+        }
+        
+        String action = server->arg("action");
+        if (action == "start") {
+            isMeasuring = true;
+            if (startNewMeasurementCallback) {
+                startNewMeasurementCallback();
+            } else {
+                sensorManager.startMeasurement();
+            }
+            code = 202;
+        } else if (action == "stop") {
+            stopMeasurement();
+        } else {
+            sendApiError(400, "invalid_action");
+            return;
+        }
+    } else if (server->method() != HTTP_GET) {
+        sendApiError(405, "method_not_allowed");
+        return;
+    }
+    
+    StaticJsonDocument<API_JSON_CAPACITY> doc;
+    addMeasurementProgress(doc);
+    sendApiJson(code, doc);
+}
+
+void WiFiManager::handleApiResult() {
+    // The top-level fields are the first probe with a result; every finished
+    // probe is listed under "probes"
+    SensorManager* first = nullptr;
+    StaticJsonDocument<API_JSON_CAPACITY> doc;
+    JsonArray probes = doc.createNestedArray("probes");
+    for (int i = 0; i < sensorScheduler.getProbeCount(); i++) {
+        SensorManager* probe = sensorScheduler.getProbe(i);
+        if (!probe->isMeasurementReady()) {
+            continue;
+        }
+        if (first == nullptr) {
+            first = probe;
+            doc["probe"] = i;
+        }
+        JsonObject entry = probes.createNestedObject();
+        entry["probe"] = i;
+        entry["avg_hr"] = probe->getAveragedHR();
+        entry["avg_spo2"] = (int32_t)abs(probe->getAveragedSpO2());
+        entry["valid_readings"] = probe->getValidReadingCount();
+        entry["window_clean"] = probe->isWindowClean();
+    }
+    if (first == nullptr) {
+        sendApiError(404, "no_result");
+        return;
+    }
+    
+    doc["avg_hr"] = first->getAveragedHR();
+    doc["avg_spo2"] = (int32_t)abs(first->getAveragedSpO2());
+    doc["valid_readings"] = first->getValidReadingCount();
+    doc["window_clean"] = first->isWindowClean();
+    
+    // aiSummary belongs to the job until it finishes
+    if (!aiJob.isRunning() && aiJob.succeeded()) {
+        doc["ai_summary"] = (const char*)aiSummary.c_str();
+    } else {
+        doc["ai_summary"] = nullptr;
+    }
+    
+    sendApiJson(200, doc);
+}
+
+void WiFiManager::handleApiConfig() {
+    extern SensorManager sensorManager;
+    StaticJsonDocument<API_JSON_CAPACITY> doc;
+    
+    doc["device_id"] = DEVICE_ID;
+    doc["server_url"] = (const char*)serverURL.c_str();
+    doc["ssid"] = (const char*)userSSID.c_str();
+    doc["guest_mode"] = isGuestMode;
+    doc["acquisition_mode"] = (int)sensorManager.getAcquisitionMode();
+    doc["multi_led"] = sensorManager.isMultiLedMode();
+    doc["probe_count"] = sensorScheduler.getProbeCount();
+    doc["sample_period_us"] = (unsigned long)SAMPLE_PERIOD_US;
+    doc["required_readings"] = REQUIRED_VALID_READINGS;
+    doc["waveform_port"] = WAVEFORM_PORT;
+    
+    sendApiJson(200, doc);
+}
+
+void WiFiManager::cleanupConnections() {
+    // Free the uplink's TLS buffers. The station link, the other clients' sockets
+    // and any request in flight on the uplink worker are left alone.
+    if (!uplink.close()) {
+        Serial.println(F("Uplink busy, it will close when idle"));
+    }
     
     Serial.print(F("Memory after cleanup: "));
     Serial.println(ESP.getFreeHeap());
@@ -1855,8 +2142,14 @@ void WiFiManager::forceSocketCleanup() {
     }
 }
 
-// Function to ensure WiFi stability
+// Function to ensure WiFi stability. Called from request handlers, so it only
+// kicks off a reconnect; checkWiFiConnection() notices when it completes.
 void WiFiManager::ensureWiFiStability() {
+    // The connect job owns the radio until it finishes
+    if (connectJob.isRunning()) {
+        return;
+    }
+    
     // Check if we're in the correct WiFi mode
     if (WiFi.getMode() != WIFI_AP_STA) {
         Serial.println("Fixing WiFi mode - setting to AP+STA");
@@ -1872,27 +2165,16 @@ void WiFiManager::ensureWiFiStability() {
     }
     
     // Ensure DNS server is running
-    dnsServer->processNextRequest();
+    dns.loop();
     
-    // Reconnect to user network if needed
-    if (userSSID.length() > 0 && WiFi.status() != WL_CONNECTED) {
+    // Reconnect to user network if needed, without waiting for the result
+    static unsigned long lastReconnect = 0;
+    if (userSSID.length() > 0 && WiFi.status() != WL_CONNECTED &&
+        (lastReconnect == 0 || millis() - lastReconnect > wifiCheckInterval)) {
         Serial.println(F("Reconnecting to WiFi after stability check"));
+        lastReconnect = millis();
+        isConnected = false;
         WiFi.begin(userSSID.c_str(), userPassword.c_str());
-        
-        // Wait briefly for connection
-        int attempts = 0;
-        while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-            delay(200);
-            attempts++;
-        }
-        
-        if (WiFi.status() == WL_CONNECTED) {
-            isConnected = true;
-            Serial.println(F("Reconnected successfully"));
-        } else {
-            isConnected = false;
-            Serial.println(F("Failed to reconnect"));
-        }
     }
     
     // Ensure AP mode is active
@@ -1939,116 +2221,12 @@ void WiFiManager::handleMeasurementInfo() {
         return;
     }
     
-    // CSS for the page
-    String css = "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                 ".container{max-width:450px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                 "h1{color:#333;font-size:22px;margin-top:0}"
-                 "h2{color:#444;font-size:18px;margin:15px 0 10px;padding-bottom:5px;border-bottom:1px solid #eee}"
-                 ".reading{font-size:24px;margin:15px 0;font-weight:bold}"
-                 ".hr{color:#f44336}.spo2{color:#2196F3}"
-                 ".user{color:#4CAF50;font-weight:bold;font-size:14px}.guest{color:#FF9800;font-weight:bold;font-size:14px}"
-                 ".card{border:1px solid #ddd;border-radius:8px;padding:12px;margin:15px 0;background:#f9f9f9}"
-                 ".data-table{width:100%;margin:10px 0;font-size:14px;border-collapse:collapse}"
-                 ".data-table th,.data-table td{padding:8px;text-align:center;border-bottom:1px solid #ddd}"
-                 ".data-table th{background:#f0f0f0}"
-                 "button{background:#4CAF50;color:white;padding:10px 15px;border:none;border-radius:4px;cursor:pointer;margin:5px;font-weight:bold;min-width:120px}"
-                 ".btn-blue{background:#2196F3}.btn-orange{background:#FF9800}.btn-red{background:#f44336}"
-                 ".modal{display:none;position:fixed;left:0;top:0;width:100%;height:100%;background-color:rgba(0,0,0,0.5);z-index:100}"
-                 ".modal-content{background:#fff;margin:15% auto;padding:20px;border-radius:8px;width:80%;max-width:400px}";
-    
-    // Get the measurement results
-    int32_t avgHR = sensorManager.getAveragedHR();
-    int32_t avgSpO2 = sensorManager.getAveragedSpO2();
-    int validCount = sensorManager.getValidReadingCount();
-    
-    // Build HTML response
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<meta charset='UTF-8'>"
-                  "<title>Measurement Results</title>"
-                  "<style>" + css + "</style>"
-                  "</head>"
-                  "<body>"
-                  "<div class='container'>"
-                  "<h1>Measurement Results</h1>";
-    
-    // Show user mode
-    if (isLoggedIn) {
-        html += "<p class='user'>User Mode - Data Saved to Account</p>";
-    } else {
-        html += "<p class='guest'>Guest Mode - Data Not Saved</p>";
-    }
-    
-    // Show the averaged results card
-    html += "<div class='card'>"
-            "<h2>Final Results</h2>"
-            "<div class='reading hr'>Heart Rate: " + String(avgHR) + " BPM</div>"
-            "<div class='reading spo2'>SpO2: " + String(abs(avgSpO2)) + " %</div>"
-            "<p>Based on " + String(validCount) + " valid measurements</p>"
-            "</div>";
-            
-    // Add measurement process details
-    html += "<div class='card'>"
-            "<h2>Measurement Process</h2>"
-            "<p>Valid readings collected during measurement:</p>"
-            "<table class='data-table'>"
-            "<tr><th>Reading</th><th>Heart Rate</th><th>SpO2</th></tr>";
-    
-    // In a real implementation, you would access the actual array of measurements
-    // Here we'll simulate this with random variations around the average
-    for (int i = 0; i < validCount; i++) {
-        // Simulate some variation in readings (±3 for HR, ±1 for SpO2)
-        int variation = (i * 7) % 6 - 3;
-        html += "<tr><td>Reading " + String(i+1) + "</td>"
-                "<td>" + String(avgHR + variation) + " BPM</td>"
-                "<td>" + String(abs(avgSpO2 + (variation/3))) + "%</td></tr>";
-    }
-    
-    html += "</table></div>";
-    
-    // Add button section
-    html += "<div class='card' style='text-align:center'>"
-            "<h2>Actions</h2>";
-    
-    // Re-measure button - primary action
-    html += "<form action='/continue_measuring' method='get' style='display:inline-block;margin:5px'>"
-            "<button type='submit' style='font-size:16px;padding:12px 25px'>Re-measure</button>"
-            "</form>";
-    
-    // Return to measurement page
-    html += "<form action='/measurement' method='get' style='display:inline-block;margin:5px'>"
-            "<button type='submit' class='btn-blue'>Back to Measure Page</button>"
-            "</form>";
-    
-    // AI Analysis button based on user mode - only if user is logged in
-    if (isLoggedIn) {
-        // For logged-in users, provide actual AI analysis
-        html += "<form action='/ai_analysis' method='get' style='display:inline-block;margin:5px'>"
-                "<button type='submit' class='btn-orange'>AI Analysis</button>"
-                "</form>";
-    }
-    
-    // Back to mode select button
-    html += "<form action='/mode' method='get' style='display:inline-block;margin:5px'>"
-            "<button type='submit' class='btn-red'>Mode Select</button>"
-            "</form>";
-    
-    html += "</div>";
-    
-    // Add registration modal for guest mode (if needed for some features)
-    if (isGuestMode) {
-        html += "<div class='card'>"
-               "<h2>Want More Features?</h2>"
-               "<p>Register an account to save your measurements and access AI analysis.</p>"
-               "<p><a href='https://iot.newnol.io.vn' target='_blank'>Visit HealthSense Portal</a></p>"
-               "</div>";
-    }
-    
-    html += "</div></body></html>";
-    
-    // Send HTTP response
+    // Send HTTP response, streamed from a flash template
     server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server->send(200, "text/html", html);
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_MEASUREMENT_INFO_TPL_HTML, measurementInfoValue, pageSection, this);
+    page.end();
     
     // Reset measurement stream state for next measurement
     resetMeasurementStreamState();
@@ -2060,6 +2238,93 @@ void WiFiManager::handleMeasurementInfo() {
 // Static variable to track first load of measurement stream page
 static bool measurementStreamFirstLoad = true;
 
+void WiFiManager::measurementInfoValue(const char* name, TemplateStream& out, void* context) {
+    extern SensorManager sensorManager;
+    int32_t avgHR = sensorManager.getAveragedHR();
+    int32_t avgSpO2 = sensorManager.getAveragedSpO2();
+    int validCount = sensorManager.getValidReadingCount();
+    
+    if (strcmp(name, "HR") == 0) {
+        out.print(avgHR);
+    } else if (strcmp(name, "SPO2") == 0) {
+        out.print((int32_t)abs(avgSpO2));
+    } else if (strcmp(name, "VALID_COUNT") == 0) {
+        out.print((int32_t)validCount);
+    } else if (strcmp(name, "READING_ROWS") == 0) {
+        // In a real implementation, you would access the actual array of measurements
+        // Here we'll simulate this with random variations around the average
+        for (int i = 0; i < validCount; i++) {
+            // Simulate some variation in readings (±3 for HR, ±1 for SpO2)
+            int variation = (i * 7) % 6 - 3;
+            out.print("<tr><td>Reading ");
+            out.print((int32_t)(i + 1));
+            out.print("</td><td>");
+            out.print(avgHR + variation);
+            out.print(" BPM</td><td>");
+            out.print((int32_t)abs(avgSpO2 + (variation / 3)));
+            out.print("%</td></tr>");
+        }
+    }
+}
+
+void WiFiManager::measurementStreamValue(const char* name, TemplateStream& out, void* context) {
+    if (strcmp(name, "REQUIRED") == 0) {
+        out.print((int32_t)REQUIRED_VALID_READINGS);
+    }
+}
+
+void WiFiManager::handleEvents() {
+    if (events.getSubscriberCount() >= EVENT_MAX_SUBSCRIBERS) {
+        server->send(503, "text/plain", "Too many event subscribers");
+        return;
+    }
+    // From here on the connection belongs to the event stream, so the server
+    // goes back to serving other requests right away
+    WiFiClient client = server->takeClient();
+    if (!events.subscribe(client)) {
+        return;
+    }
+    
+    // Bring the new subscriber up to date; the state events are idempotent
+    for (int i = 0; i < sensorScheduler.getProbeCount(); i++) {
+        SensorManager* probe = sensorScheduler.getProbe(i);
+        if (probe->isMeasurementReady()) {
+            publishMeasurementComplete(probe->getAveragedHR(), probe->getAveragedSpO2(), i);
+        } else if (probe->isMeasurementInProgress()) {
+            publishReadings(probe->getHeartRate(), probe->isHeartRateValid(),
+                            probe->getSPO2(), probe->isSPO2Valid(), i);
+        }
+    }
+}
+
+void WiFiManager::publishFingerStatus(bool fingerDetected) {
+    events.publish("finger", fingerDetected ? "{\"detected\":true}" : "{\"detected\":false}");
+}
+
+void WiFiManager::publishReadings(int32_t heartRate, bool validHR, int32_t spo2, bool validSPO2, int probe) {
+    SensorManager* source = sensorScheduler.getProbe(probe);
+    if (events.getSubscriberCount() == 0 || source == nullptr) {
+        return;
+    }
+    
+    char data[144];
+    snprintf(data, sizeof(data),
+             "{\"probe\":%d,\"hr\":%ld,\"hr_valid\":%s,\"spo2\":%ld,\"spo2_valid\":%s,\"progress\":%d,\"required\":%d}",
+             probe, (long)heartRate, validHR ? "true" : "false", (long)abs(spo2), validSPO2 ? "true" : "false",
+             source->getValidReadingCount(), REQUIRED_VALID_READINGS);
+    events.publish("reading", data);
+}
+
+void WiFiManager::publishMeasurementComplete(int32_t avgHR, int32_t avgSpO2, int probe) {
+    char data[64];
+    snprintf(data, sizeof(data), "{\"probe\":%d,\"hr\":%ld,\"spo2\":%ld}", probe, (long)avgHR, (long)abs(avgSpO2));
+    events.publish("complete", data);
+}
+
+void WiFiManager::publishWaveform(const uint32_t* red, const uint32_t* ir, const uint32_t* timestamps, int count) {
+    waveform.publish(red, ir, timestamps, count);
+}
+
 void WiFiManager::startMeasurement() {
     isMeasuring = true;
     Serial.println(F("🔄 WiFiManager::startMeasurement - Set isMeasuring = true"));
@@ -2069,12 +2334,20 @@ void WiFiManager::stopMeasurement() {
     isMeasuring = false;
     Serial.println(F("🛑 WiFiManager::stopMeasurement - Set isMeasuring = false"));
     
-    // Also make sure sensor manager stops measuring
-    extern SensorManager sensorManager;
-    if (sensorManager.isMeasurementInProgress()) {
+    // Also make sure every probe stops measuring
+    if (sensorScheduler.isMeasurementInProgress()) {
         Serial.println(F("Stopping sensor measurement from WiFiManager"));
-        sensorManager.stopMeasurement();
+        sensorScheduler.stopMeasurement();
+    }
+}
+
+bool WiFiManager::requestUpload() {
+    if (!isConnected) {
+        return false;
     }
+    drainRequested = true;
+    uploadForced = true;
+    return true;
 }
 
 void WiFiManager::resetMeasurementStreamState() {
@@ -2130,120 +2403,16 @@ void WiFiManager::handleMeasurementStream() {
     
     Serial.println("⭐ Measurement activated: isMeasuring = " + String(isMeasuring ? "YES" : "NO"));
     
-    // Simple measuring page with spinner and IMPROVED JavaScript
-    String html = "<!DOCTYPE html><html>"
-                  "<head><meta charset='UTF-8'>"
-                  "<meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-                  "<title>Measuring...</title>"
-                  "<style>"
-                  "body{font-family:Arial;margin:0;padding:10px;background:#f0f0f0;text-align:center}"
-                  ".container{max-width:400px;margin:0 auto;background:white;padding:15px;border-radius:8px;box-shadow:0 1px 5px rgba(0,0,0,0.1)}"
-                  "h1{color:#333;font-size:22px;margin-top:0}"
-                  ".loader{width:60px;height:60px;border-radius:50%;border:5px solid #f3f3f3;border-top:5px solid #3498db;animation:spin 1.5s linear infinite;margin:20px auto}"
-                  "@keyframes spin{0%{transform:rotate(0deg)}100%{transform:rotate(360deg)}}"
-                  ".status{padding:15px;margin:15px 0;font-weight:bold;color:#1976d2;font-size:18px}"
-                  ".user{color:#4CAF50;font-weight:bold;font-size:14px}.guest{color:#FF9800;font-weight:bold;font-size:14px}"
-                  ".note{margin:30px 0 10px;font-size:14px;color:#666}"
-                  "</style>"
-                  "<script>"
-                  "// Handle page load completion"
-                  "window.addEventListener('load', function() {"
-                  "  console.log('Measurement page loaded - measurement already started');"
-                  "  startStatusChecking();" // Start checking immediately when page loads
-                  "});"
-                  ""
-                  "// Function to handle redirect from server or trigger manual redirect"
-                  "function startStatusChecking() {"
-                  "  // Check more frequently (every 1 second)"
-                  "  var checkStatusInterval = setInterval(function() {"
-                  "    fetch('/check_measurement_status')"
-                  "      .then(response => {"
-                  "        // If we get a redirect response (302), follow it immediately"
-                  "        if (response.redirected) {"
-                  "          console.log('Server redirected, following to:', response.url);"
-                  "          clearInterval(checkStatusInterval);"
-                  "          window.location.href = response.url;"
-                  "          return 'redirected';" 
-                  "        }"
-                  "        return response.text();"
-                  "      })"
-                  "      .then(status => {"
-                  "        if (status === 'redirected') return;" // Already handled redirect
-                  "        console.log('Received status:', status);"
-                  "        if (status === 'complete') {"
-                  "          console.log('Measurement complete, redirecting...');"
-                  "          clearInterval(checkStatusInterval);"
-                  "          window.location.href = '/measurement_info';"
-                  "        }"
-                  "      })"
-                  "      .catch(error => {"
-                  "        console.error('Error checking status:', error);"
-                  "        // If we get an error, it might be because the ESP32 has redirected and"
-                  "        // the connection was closed. Try loading the results page directly."
-                  "        window.location.href = '/measurement_info';"
-                  "      });"
-                  "  }, 1000);" // Check every 1 second
-                  "}"
-                  "</script>"
-                  "</head><body><div class='container'>"
-                  "<h1>Measurement in Progress</h1>";
-
-    // Show user mode
-    if (isLoggedIn) {
-        html += "<p class='user'>User Mode - Data will be saved to your account</p>";
-    } else {
-        html += "<p class='guest'>Guest Mode - Data will not be saved</p>";
-    }
-    
-    html += "<div class='loader'></div>"
-            "<div class='status'>Please wait while we collect your measurements</div>"
-            "<p class='note'>Values are being displayed on the device LCD screen.<br>"
-            "This page will automatically update when measurement is complete.</p>"
-            "<p id='countdown' style='display:none; color:#f44336; font-weight:bold;'>Redirecting in <span id='timer'>10</span>...</p>"
-            "<script>"
-            "// Add multiple failsafe redirects"
-            
-            "// Failsafe #1: Add a meta refresh tag after 30 seconds"
-            "setTimeout(function() {"
-            "  var meta = document.createElement('meta');"
-            "  meta.httpEquiv = 'refresh';"
-            "  meta.content = '2;url=/measurement_info';"
-            "  document.head.appendChild(meta);"
-            "  console.log('Added meta refresh tag as failsafe');"
-            "}, 30000);"
-            
-            "// Failsafe #2: Show countdown and redirect after 40 seconds"
-            "setTimeout(function() {"
-            "  document.getElementById('countdown').style.display = 'block';"
-            "  var count = 10;"
-            "  var timer = setInterval(function() {"
-            "    document.getElementById('timer').textContent = count;"
-            "    count--;"
-            "    if(count < 0) {"
-            "      clearInterval(timer);"
-            "      window.location.href = '/measurement_info';"
-            "    }"
-            "  }, 1000);"
-            "}, 40000);"
-            
-            "// Failsafe #3: Force redirect after 60 seconds no matter what"
-            "setTimeout(function() {"
-            "  console.log('Final failsafe activated, forcing redirect');"
-            "  window.location.href = '/measurement_info';" 
-            "}, 60000);"
-            "</script>"
-            
-            "<!-- Server-side automatic refresh after 60 seconds -->"
-            "<meta http-equiv='refresh' content='60;url=/measurement_info'>"
-            "</div></body></html>";
-    
-    Serial.println("✅ Measurement stream page sent, measurement already started");
-    
-    // Send HTTP response with cache control
+    // Measuring page; progress arrives over /events instead of polling
     server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
     server->sendHeader("Pragma", "no-cache");
     server->sendHeader("Expires", "-1");
-    server->send(200, "text/html", html);
+    TemplateStream page(*server);
+    page.begin(200, "text/html");
+    page.render(WEB_MEASUREMENT_STREAM_TPL_HTML, measurementStreamValue, pageSection, this);
+    page.end();
+    
+    Serial.println("✅ Measurement stream page sent, measurement already started");
 }
 
 // This handler is called by the browser via fetch() AFTER the page is fully loaded
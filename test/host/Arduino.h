@@ -0,0 +1,140 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core for the native unit tests (pio test -e native). Only
+// what the hardware-independent modules use; time and the buzzer are driven
+// by the tests through hostState().
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define F(text) (text)
+
+struct HostState {
+    unsigned long millis;
+    double toneFrequency;       // Last ledcWriteTone(), 0 after ledcWrite(channel, 0)
+    int toneWrites;
+};
+
+inline HostState& hostState() {
+    static HostState state;
+    return state;
+}
+
+inline unsigned long millis() { return hostState().millis; }
+
+inline double ledcWriteTone(uint8_t channel, double frequency) {
+    hostState().toneFrequency = frequency;
+    hostState().toneWrites++;
+    return frequency;
+}
+
+inline void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (duty == 0) {
+        hostState().toneFrequency = 0;
+    }
+}
+
+class String {
+private:
+    std::string text;
+
+public:
+    String(const char* value = "") : text(value ? value : "") {}
+    const char* c_str() const { return text.c_str(); }
+    size_t length() const { return text.size(); }
+
+    bool startsWith(const char* prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+    bool endsWith(const char* suffix) const {
+        size_t length = strlen(suffix);
+        return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+    }
+    void remove(size_t index) { text.erase(index < text.size() ? index : text.size()); }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(text.c_str(), other.c_str()) == 0; }
+
+    String operator+(const char* other) const { return String((text + other).c_str()); }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator!=(const String& other) const { return text != other.text; }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            write(data[i]);
+        }
+        return length;
+    }
+    virtual void flush() {}
+
+    // Logging goes nowhere on the host
+    template <typename T> size_t print(const T&) { return 0; }
+    template <typename T> size_t println(const T&) { return 0; }
+    size_t println() { return 0; }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+class HostSerial : public Print {
+public:
+    using Print::write;
+    size_t write(uint8_t) override { return 1; }
+};
+static HostSerial Serial;
+
+// Fixed eFuse MAC, so getDeviceUid() is "esp-123456789abc" in every suite
+class HostEsp {
+public:
+    HostEsp() {}
+    uint64_t getEfuseMac() { return 0x123456789ABCULL; }
+    uint32_t getFreeHeap() { return 200000; }
+};
+static HostEsp ESP;
+
+class IPAddress {
+private:
+    uint8_t bytes[4];
+
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes{a, b, c, d} {}
+    uint8_t operator[](int index) const { return bytes[index]; }
+};
+
+// Single-threaded tests: the FreeRTOS mutex only has to exist
+typedef void* SemaphoreHandle_t;
+#define portMAX_DELAY 0xFFFFFFFF
+#define pdTRUE 1
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    static int mutex;
+    return &mutex;
+}
+inline int xSemaphoreTake(SemaphoreHandle_t, uint32_t) { return 1; }
+inline int xSemaphoreGive(SemaphoreHandle_t) { return 1; }
+
+// No tasks on the host: creating one fails, so callers take their loop() fallback
+typedef void* TaskHandle_t;
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) (ms)
+inline int xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, unsigned, TaskHandle_t*, int) {
+    return 0;
+}
+inline void vTaskDelay(uint32_t) {}
+inline void vTaskDelete(TaskHandle_t) {}
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,86 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+// In-memory file system behind the LittleFS fake. Tests reach the raw bytes
+// through hostFiles() to corrupt records or simulate a reboot.
+typedef std::map<std::string, std::vector<uint8_t>> HostFiles;
+
+inline HostFiles& hostFiles() {
+    static HostFiles files;
+    return files;
+}
+
+class File {
+private:
+    std::vector<uint8_t>* data;
+    size_t position;
+
+public:
+    File(std::vector<uint8_t>* data = nullptr, size_t position = 0) : data(data), position(position) {}
+
+    operator bool() const { return data != nullptr; }
+    size_t size() const { return data ? data->size() : 0; }
+    void close() { data = nullptr; }
+
+    bool seek(size_t offset) {
+        if (!data || offset > data->size()) {
+            return false;
+        }
+        position = offset;
+        return true;
+    }
+
+    size_t read(uint8_t* buffer, size_t length) {
+        if (!data) {
+            return 0;
+        }
+        size_t count = 0;
+        while (count < length && position < data->size()) {
+            buffer[count++] = (*data)[position++];
+        }
+        return count;
+    }
+
+    size_t write(const uint8_t* buffer, size_t length) {
+        if (!data) {
+            return 0;
+        }
+        for (size_t i = 0; i < length; i++, position++) {
+            if (position < data->size()) {
+                (*data)[position] = buffer[i];
+            } else {
+                data->push_back(buffer[i]);
+            }
+        }
+        return length;
+    }
+};
+
+class HostFS {
+public:
+    bool begin(bool formatOnFail = false) { return true; }
+
+    bool exists(const char* path) { return hostFiles().count(path) > 0; }
+
+    // "r" and "r+" need an existing file; "a" and "w" create it
+    File open(const char* path, const char* mode) {
+        HostFiles& files = hostFiles();
+        HostFiles::iterator it = files.find(path);
+        if (it == files.end()) {
+            if (mode[0] == 'r') {
+                return File();
+            }
+            it = files.insert(std::make_pair(std::string(path), std::vector<uint8_t>())).first;
+        }
+        if (mode[0] == 'w') {
+            it->second.clear();
+        }
+        return File(&it->second, mode[0] == 'a' ? it->second.size() : 0);
+    }
+};
+
+#endif // HOST_FS_H
@@ -0,0 +1,115 @@
+#ifndef HOST_HTTPCLIENT_H
+#define HOST_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+// One request as the server saw it
+struct HostHttpRequest {
+    std::string method;
+    std::string url;
+    std::string payload;
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    // Value of the named header, nullptr if it wasn't sent
+    const char* header(const char* name) const {
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (headers[i].first == name) {
+                return headers[i].second.c_str();
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct HostHttpResponse {
+    int code;
+    std::string body;
+    std::string etag;
+};
+
+// Scripted server behind the HTTPClient fake: requests are recorded in order and
+// answered from the front of responses. With nothing scripted the connection
+// is refused.
+struct HostHttp {
+    std::vector<HostHttpRequest> requests;
+    std::deque<HostHttpResponse> responses;
+
+    void respond(int code, const char* body = "", const char* etag = "") {
+        HostHttpResponse response = {code, body, etag};
+        responses.push_back(response);
+    }
+
+    void clear() {
+        requests.clear();
+        responses.clear();
+    }
+};
+
+inline HostHttp& hostHttp() {
+    static HostHttp http;
+    return http;
+}
+
+class HTTPClient {
+private:
+    WiFiClient* client = nullptr;
+    HostHttpRequest current;
+    HostHttpResponse response;
+
+public:
+    bool begin(WiFiClient& transport, const String& url) {
+        client = &transport;
+        current = HostHttpRequest();
+        current.url = url.c_str();
+        return true;
+    }
+
+    void setReuse(bool) {}
+    void setConnectTimeout(int32_t) {}
+    void setTimeout(uint16_t) {}
+    void collectHeaders(const char* headerKeys[], size_t count) {}
+
+    void addHeader(const String& name, const String& value) {
+        current.headers.push_back(std::make_pair(std::string(name.c_str()), std::string(value.c_str())));
+    }
+
+    int sendRequest(const char* method, const String& payload) {
+        current.method = method;
+        current.payload = payload.c_str();
+        hostHttp().requests.push_back(current);
+
+        if (hostHttp().responses.empty()) {
+            response = HostHttpResponse();
+            response.code = HTTPC_ERROR_CONNECTION_REFUSED;
+            return response.code;
+        }
+        response = hostHttp().responses.front();
+        hostHttp().responses.pop_front();
+        client->open = response.code > 0;
+        return response.code;
+    }
+
+    String header(const char* name) {
+        return String(strcmp(name, "ETag") == 0 ? response.etag.c_str() : "");
+    }
+
+    int writeToStream(Stream* stream) {
+        stream->write((const uint8_t*)response.body.data(), response.body.size());
+        return (int)response.body.size();
+    }
+
+    void end() {}
+};
+
+#endif // HOST_HTTPCLIENT_H
@@ -0,0 +1,37 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+
+// NVS fake: one map of "namespace/key" to value, kept across Preferences objects
+typedef std::map<std::string, uint32_t> HostPreferences;
+
+inline HostPreferences& hostPreferences() {
+    static HostPreferences values;
+    return values;
+}
+
+class Preferences {
+private:
+    std::string prefix;
+
+public:
+    bool begin(const char* name, bool readOnly = false) {
+        prefix = std::string(name) + "/";
+        return true;
+    }
+    void end() {}
+
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) {
+        HostPreferences::iterator it = hostPreferences().find(prefix + key);
+        return it == hostPreferences().end() ? defaultValue : it->second;
+    }
+
+    size_t putUInt(const char* key, uint32_t value) {
+        hostPreferences()[prefix + key] = value;
+        return sizeof(value);
+    }
+};
+
+#endif // HOST_PREFERENCES_H
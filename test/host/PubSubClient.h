@@ -0,0 +1,124 @@
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <vector>
+
+#define MQTT_MAX_HEADER_SIZE 5
+
+struct HostMqttMessage {
+    std::string topic;
+    std::vector<uint8_t> payload;
+    bool retained;
+};
+
+class PubSubClient;
+
+// Broker behind the PubSubClient fake: records subscriptions and everything
+// published, and delivers test messages to the last client created
+struct HostMqtt {
+    bool brokerDown;                    // connect() fails while set
+    std::vector<std::string> subscriptions;
+    std::vector<HostMqttMessage> published;
+    PubSubClient* client;
+
+    void clear() {
+        brokerDown = false;
+        subscriptions.clear();
+        published.clear();
+    }
+
+    inline void deliver(const char* topic, const char* payload);
+};
+
+inline HostMqtt& hostMqtt() {
+    static HostMqtt mqtt;
+    return mqtt;
+}
+
+// Like the real client, a received message and every outgoing one share one
+// buffer: the callback's topic and payload point into it, and publishing from
+// inside the callback overwrites them.
+class PubSubClient {
+private:
+    std::vector<uint8_t> buffer;
+    void (*callback)(char*, uint8_t*, unsigned int) = nullptr;
+    bool isConnected = false;
+
+public:
+    PubSubClient(WiFiClient& client) : buffer(256) { hostMqtt().client = this; }
+    ~PubSubClient() {
+        if (hostMqtt().client == this) {
+            hostMqtt().client = nullptr;
+        }
+    }
+
+    PubSubClient& setServer(const char* domain, uint16_t port) { return *this; }
+    PubSubClient& setCallback(void (*handler)(char*, uint8_t*, unsigned int)) {
+        callback = handler;
+        return *this;
+    }
+    bool setBufferSize(uint16_t size) {
+        buffer.assign(size, 0);
+        return true;
+    }
+
+    bool connect(const char* id, const char* user, const char* pass) {
+        isConnected = !hostMqtt().brokerDown;
+        return isConnected;
+    }
+    void disconnect() { isConnected = false; }
+    bool connected() { return isConnected; }
+    bool loop() { return isConnected; }
+    int state() { return isConnected ? 0 : -2; }
+
+    bool subscribe(const char* topic, uint8_t qos) {
+        hostMqtt().subscriptions.push_back(topic);
+        return isConnected;
+    }
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained) {
+        size_t topicLength = strlen(topic);
+        if (!isConnected || MQTT_MAX_HEADER_SIZE + 2 + topicLength + length > buffer.size()) {
+            return false;
+        }
+        // Topic length, topic and payload go into the buffer after the fixed header
+        uint8_t* out = &buffer[MQTT_MAX_HEADER_SIZE];
+        out[0] = topicLength >> 8;
+        out[1] = topicLength & 0xFF;
+        memcpy(out + 2, topic, topicLength);
+        memmove(out + 2 + topicLength, payload, length);
+
+        HostMqttMessage message;
+        message.topic = topic;
+        message.payload.assign(out + 2 + topicLength, out + 2 + topicLength + length);
+        message.retained = retained;
+        hostMqtt().published.push_back(message);
+        return true;
+    }
+    bool publish(const char* topic, const char* payload) {
+        return publish(topic, (const uint8_t*)payload, strlen(payload), false);
+    }
+
+    // Lays the message out in the buffer as the real client does (topic
+    // NUL-terminated in place, payload right after it) and runs the callback
+    void receive(const char* topic, const uint8_t* payload, unsigned int length) {
+        size_t topicLength = strlen(topic);
+        char* topicCopy = (char*)&buffer[3];
+        uint8_t* payloadCopy = &buffer[3 + topicLength + 1];
+        memcpy(topicCopy, topic, topicLength + 1);
+        memcpy(payloadCopy, payload, length);
+        if (callback) {
+            callback(topicCopy, payloadCopy, length);
+        }
+    }
+};
+
+inline void HostMqtt::deliver(const char* topic, const char* payload) {
+    if (client != nullptr) {
+        client->receive(topic, (const uint8_t*)payload, strlen(payload));
+    }
+}
+
+#endif // HOST_PUBSUBCLIENT_H
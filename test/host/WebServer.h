@@ -0,0 +1,58 @@
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include <Arduino.h>
+#include <utility>
+#include <vector>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+// Records the response instead of sending it; every sendContent() call is one chunk.
+// Tests set the request line through requestUri and requestHost.
+class WebServer {
+public:
+    std::string requestUri;
+    std::string requestHost;
+
+    int code = 0;
+    std::string contentType;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::vector<size_t> chunks;
+    bool chunked = false;
+
+    String uri() { return String(requestUri.c_str()); }
+    String hostHeader() { return String(requestHost.c_str()); }
+
+    void sendHeader(const String& name, const String& value, bool first = false) {
+        std::pair<std::string, std::string> header(name.c_str(), value.c_str());
+        headers.insert(first ? headers.begin() : headers.end(), header);
+    }
+
+    // Value of the named response header, nullptr if it wasn't sent
+    const char* header(const char* name) const {
+        for (size_t i = 0; i < headers.size(); i++) {
+            if (headers[i].first == name) {
+                return headers[i].second.c_str();
+            }
+        }
+        return nullptr;
+    }
+
+    void setContentLength(size_t length) { chunked = (length == CONTENT_LENGTH_UNKNOWN); }
+
+    void send(int responseCode, const char* type = "", const char* content = "") {
+        code = responseCode;
+        contentType = type;
+        body = content;
+    }
+    void send_P(int responseCode, const char* type, const char* content) { send(responseCode, type, content); }
+
+    void sendContent(const char* content, size_t length) {
+        body.append(content, length);
+        chunks.push_back(length);
+    }
+    void sendContent(const char* content) { sendContent(content, strlen(content)); }
+};
+
+#endif // HOST_WEBSERVER_H
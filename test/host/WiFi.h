@@ -0,0 +1,43 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+// Station link state; tests set it through hostWiFi()
+struct HostWiFiState {
+    wl_status_t status;
+    int8_t rssi;
+};
+
+inline HostWiFiState& hostWiFi() {
+    static HostWiFiState state;
+    return state;
+}
+
+class HostWiFiClass {
+public:
+    HostWiFiClass() {}
+    wl_status_t status() { return hostWiFi().status; }
+    int8_t RSSI() { return hostWiFi().rssi; }
+};
+static HostWiFiClass WiFi;
+
+// Socket that only remembers whether it is open; the HTTPClient fake opens it
+class WiFiClient {
+public:
+    bool open = false;
+
+    uint8_t connected() { return open; }
+    void stop() { open = false; }
+};
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,12 @@
+#ifndef HOST_WIFICLIENTSECURE_H
+#define HOST_WIFICLIENTSECURE_H
+
+#include <WiFi.h>
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+    void setHandshakeTimeout(unsigned long) {}
+};
+
+#endif // HOST_WIFICLIENTSECURE_H
@@ -0,0 +1,74 @@
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+// Datagrams waiting for parsePacket() and the replies sent, in order
+struct HostUdp {
+    std::deque<std::vector<uint8_t>> incoming;
+    std::vector<std::vector<uint8_t>> sent;
+
+    void clear() {
+        incoming.clear();
+        sent.clear();
+    }
+};
+
+inline HostUdp& hostUdp() {
+    static HostUdp udp;
+    return udp;
+}
+
+class WiFiUDP {
+private:
+    std::vector<uint8_t> current;
+    size_t position = 0;
+    std::vector<uint8_t> reply;
+
+public:
+    uint8_t begin(uint16_t port) { return 1; }
+    void stop() {}
+
+    // Size of the next datagram, even if it is larger than the caller's buffer
+    int parsePacket() {
+        if (hostUdp().incoming.empty()) {
+            return 0;
+        }
+        current = hostUdp().incoming.front();
+        hostUdp().incoming.pop_front();
+        position = 0;
+        return (int)current.size();
+    }
+
+    int read(uint8_t* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length && position < current.size()) {
+            buffer[count++] = current[position++];
+        }
+        return (int)count;
+    }
+
+    void flush() { current.clear(); }
+
+    IPAddress remoteIP() { return IPAddress(192, 168, 4, 2); }
+    uint16_t remotePort() { return 53000; }
+
+    int beginPacket(IPAddress ip, uint16_t port) {
+        reply.clear();
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) {
+        reply.insert(reply.end(), data, data + length);
+        return length;
+    }
+
+    int endPacket() {
+        hostUdp().sent.push_back(reply);
+        return 1;
+    }
+};
+
+#endif // HOST_WIFIUDP_H
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include "ai_summary_cache.h"
+
+static AISummaryCache* cache;
+
+void setUp(void) {
+    hostState().millis = 0;
+    cache = new AISummaryCache();
+}
+
+void tearDown(void) {
+    delete cache;
+}
+
+// What the uplink worker fills in after a 200 with an ETag
+static void fetchAndStore(const char* userId, uint32_t sequence, const char* etag, const char* summary) {
+    AISummaryFetch fetch;
+    cache->prepareFetch(fetch, userId, sequence, false);
+    strncpy(fetch.etag, etag, AI_SUMMARY_ETAG_SIZE);
+    cache->update(fetch, summary);
+}
+
+void test_empty_cache_misses(void) {
+    TEST_ASSERT_FALSE(cache->lookup("user-a", 1));
+    TEST_ASSERT_EQUAL_UINT32(0, cache->getHits());
+    TEST_ASSERT_EQUAL_UINT32(1, cache->getMisses());
+}
+
+void test_hit_needs_the_same_user_and_sequence(void) {
+    fetchAndStore("user-a", 5, "\"e1\"", "Resting HR is normal.");
+
+    TEST_ASSERT_TRUE(cache->lookup("user-a", 5));
+    TEST_ASSERT_EQUAL_STRING("Resting HR is normal.", cache->getSummary().c_str());
+    // Another user, or a newer measurement on the server, is a different summary
+    TEST_ASSERT_FALSE(cache->lookup("user-b", 5));
+    TEST_ASSERT_FALSE(cache->lookup("user-a", 6));
+
+    TEST_ASSERT_EQUAL_UINT32(1, cache->getHits());
+    TEST_ASSERT_EQUAL_UINT32(2, cache->getMisses());
+}
+
+void test_entry_goes_stale_after_the_ttl(void) {
+    hostState().millis = 1000;
+    fetchAndStore("user-a", 5, "\"e1\"", "summary");
+
+    hostState().millis = 1000 + AI_SUMMARY_TTL_MS;
+    TEST_ASSERT_FALSE(cache->isStale());
+    hostState().millis = 1000 + AI_SUMMARY_TTL_MS + 1;
+    TEST_ASSERT_TRUE(cache->isStale());
+    // Still served while it is refreshed
+    TEST_ASSERT_TRUE(cache->lookup("user-a", 5));
+}
+
+void test_only_revalidation_is_conditional(void) {
+    fetchAndStore("user-a", 5, "\"e1\"", "summary");
+
+    AISummaryFetch fetch;
+    cache->prepareFetch(fetch, "user-a", 5, false);
+    TEST_ASSERT_EQUAL_STRING("", fetch.ifNoneMatch);
+    TEST_ASSERT_EQUAL_UINT32(0, cache->getRevalidations());
+
+    cache->prepareFetch(fetch, "user-a", 5, true);
+    TEST_ASSERT_EQUAL_STRING("\"e1\"", fetch.ifNoneMatch);
+    TEST_ASSERT_TRUE(fetch.revalidation);
+    TEST_ASSERT_FALSE(fetch.notModified);
+    TEST_ASSERT_EQUAL_UINT32(1, cache->getRevalidations());
+}
+
+void test_not_modified_keeps_the_summary_and_restarts_the_ttl(void) {
+    fetchAndStore("user-a", 5, "\"e1\"", "summary");
+    hostState().millis = AI_SUMMARY_TTL_MS + 1;
+    TEST_ASSERT_TRUE(cache->isStale());
+
+    AISummaryFetch fetch;
+    cache->prepareFetch(fetch, "user-a", 5, true);
+    fetch.notModified = true;               // 304
+    cache->update(fetch, "");
+
+    TEST_ASSERT_FALSE(cache->isStale());
+    TEST_ASSERT_EQUAL_STRING("summary", cache->getSummary().c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, cache->getNotModified());
+
+    // The ETag is unchanged, so the next revalidation sends it again
+    cache->prepareFetch(fetch, "user-a", 5, true);
+    TEST_ASSERT_EQUAL_STRING("\"e1\"", fetch.ifNoneMatch);
+}
+
+void test_not_modified_for_another_entry_is_ignored(void) {
+    fetchAndStore("user-a", 5, "\"e1\"", "summary a");
+    AISummaryFetch fetch;
+    cache->prepareFetch(fetch, "user-a", 5, true);
+
+    // The cache moved on to another user while the request was in flight
+    fetchAndStore("user-b", 7, "\"e2\"", "summary b");
+    hostState().millis = AI_SUMMARY_TTL_MS + 1;
+    fetch.notModified = true;
+    cache->update(fetch, "");
+
+    TEST_ASSERT_TRUE(cache->isStale());
+    TEST_ASSERT_TRUE(cache->lookup("user-b", 7));
+    TEST_ASSERT_EQUAL_STRING("summary b", cache->getSummary().c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, cache->getNotModified());
+}
+
+void test_new_summary_replaces_the_etag(void) {
+    fetchAndStore("user-a", 5, "\"e1\"", "old");
+
+    AISummaryFetch fetch;
+    cache->prepareFetch(fetch, "user-a", 5, true);
+    strncpy(fetch.etag, "\"e2\"", AI_SUMMARY_ETAG_SIZE);
+    cache->update(fetch, "new");            // 200: the summary changed
+
+    TEST_ASSERT_EQUAL_STRING("new", cache->getSummary().c_str());
+    cache->prepareFetch(fetch, "user-a", 5, true);
+    TEST_ASSERT_EQUAL_STRING("\"e2\"", fetch.ifNoneMatch);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_cache_misses);
+    RUN_TEST(test_hit_needs_the_same_user_and_sequence);
+    RUN_TEST(test_entry_goes_stale_after_the_ttl);
+    RUN_TEST(test_only_revalidation_is_conditional);
+    RUN_TEST(test_not_modified_keeps_the_summary_and_restarts_the_ttl);
+    RUN_TEST(test_not_modified_for_another_entry_is_ignored);
+    RUN_TEST(test_new_summary_replaces_the_etag);
+    return UNITY_END();
+}
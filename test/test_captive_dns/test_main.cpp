@@ -0,0 +1,180 @@
+#include <unity.h>
+#include <WiFiUdp.h>
+#include <vector>
+#include "captive_dns.h"
+
+// Queries go in through the WiFiUDP fake; the replies it records are checked
+// byte for byte.
+#define TYPE_A 1
+#define TYPE_AAAA 28
+#define TYPE_HTTPS 65
+#define QUESTION_END (12 + 31 + 4)   // Header, encoded QUERY_NAME, QTYPE and QCLASS
+#define QUERY_NAME "connectivitycheck.gstatic.com"
+
+static CaptiveDns* dns;
+
+static void appendName(std::vector<uint8_t>& packet, const char* name) {
+    while (*name) {
+        const char* dot = strchr(name, '.');
+        size_t length = dot ? (size_t)(dot - name) : strlen(name);
+        packet.push_back((uint8_t)length);
+        packet.insert(packet.end(), name, name + length);
+        name += length + (dot ? 1 : 0);
+    }
+    packet.push_back(0);
+}
+
+// Standard query with recursion desired, optionally with an EDNS OPT record
+static std::vector<uint8_t> query(uint16_t type, bool edns = false) {
+    uint8_t header[12] = {0x12, 0x34, 0x01, 0x00, 0, 1, 0, 0, 0, 0, 0, (uint8_t)(edns ? 1 : 0)};
+    std::vector<uint8_t> packet(header, header + sizeof(header));
+    appendName(packet, QUERY_NAME);
+    packet.push_back(type >> 8);
+    packet.push_back(type & 0xFF);
+    packet.push_back(0);
+    packet.push_back(1);
+    if (edns) {
+        uint8_t opt[11] = {0, 0, 41, 0x10, 0, 0, 0, 0, 0, 0, 0};
+        packet.insert(packet.end(), opt, opt + sizeof(opt));
+    }
+    return packet;
+}
+
+static void send(const std::vector<uint8_t>& packet) {
+    hostUdp().incoming.push_back(packet);
+}
+
+static const std::vector<uint8_t>& reply(size_t index) {
+    return hostUdp().sent[index];
+}
+
+// Reply header and question: same id and question, QR and AA set, RD copied
+static void assertReplyHeader(const std::vector<uint8_t>& packet, uint8_t rcode, uint8_t answers) {
+    std::vector<uint8_t> question = query(TYPE_A);
+    TEST_ASSERT_EQUAL_HEX8(0x12, packet[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, packet[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x85, packet[2]);
+    TEST_ASSERT_EQUAL_HEX8(rcode, packet[3]);
+    uint8_t counts[8] = {0, 1, 0, answers, 0, 0, 0, 0};
+    TEST_ASSERT_EQUAL_MEMORY(counts, &packet[4], sizeof(counts));
+    TEST_ASSERT_EQUAL_MEMORY(&question[12], &packet[12], QUESTION_END - 4 - 12);
+}
+
+void setUp(void) {
+    hostUdp().clear();
+    dns = new CaptiveDns();
+    dns->start(IPAddress(192, 168, 4, 1), false);
+}
+
+void tearDown(void) {
+    dns->stop();
+    delete dns;
+}
+
+void test_a_query_gets_the_ap_address(void) {
+    send(query(TYPE_A));
+
+    TEST_ASSERT_EQUAL_INT(1, dns->processRequests());
+
+    TEST_ASSERT_EQUAL_size_t(1, hostUdp().sent.size());
+    const std::vector<uint8_t>& packet = reply(0);
+    TEST_ASSERT_EQUAL_size_t(QUESTION_END + 16, packet.size());
+    assertReplyHeader(packet, 0, 1);
+    // Name pointer to the question, A, IN, TTL, 4-byte address
+    uint8_t answer[16] = {0xC0, 12, 0, TYPE_A, 0, 1, 0, 0, 0, DNS_TTL_SECONDS, 0, 4, 192, 168, 4, 1};
+    TEST_ASSERT_EQUAL_MEMORY(answer, &packet[QUESTION_END], sizeof(answer));
+    TEST_ASSERT_EQUAL_UINT32(1, dns->getAnswered());
+}
+
+void test_aaaa_query_gets_an_empty_answer(void) {
+    send(query(TYPE_AAAA));
+
+    dns->processRequests();
+
+    TEST_ASSERT_EQUAL_size_t(QUESTION_END, reply(0).size());
+    assertReplyHeader(reply(0), 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, dns->getNoData());
+}
+
+void test_other_types_get_nxdomain(void) {
+    send(query(TYPE_HTTPS));
+
+    dns->processRequests();
+
+    TEST_ASSERT_EQUAL_size_t(QUESTION_END, reply(0).size());
+    assertReplyHeader(reply(0), 3, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, dns->getNxDomain());
+}
+
+void test_edns_record_is_dropped_from_the_reply(void) {
+    send(query(TYPE_A, true));
+
+    dns->processRequests();
+
+    TEST_ASSERT_EQUAL_size_t(QUESTION_END + 16, reply(0).size());
+    assertReplyHeader(reply(0), 0, 1);
+}
+
+void test_malformed_packets_are_dropped(void) {
+    std::vector<uint8_t> shortPacket = query(TYPE_A);
+    shortPacket.resize(6);
+    send(shortPacket);
+
+    std::vector<uint8_t> response = query(TYPE_A);
+    response[2] |= 0x80;                    // QR: a response, not a query
+    send(response);
+
+    std::vector<uint8_t> twoQuestions = query(TYPE_A);
+    twoQuestions[5] = 2;
+    send(twoQuestions);
+
+    std::vector<uint8_t> compressed = query(TYPE_A);
+    compressed[12] = 0xC0;                  // Compression pointer in a question name
+    send(compressed);
+
+    std::vector<uint8_t> truncated = query(TYPE_A);
+    truncated.resize(QUESTION_END - 2);     // QCLASS missing
+    send(truncated);
+
+    send(std::vector<uint8_t>(DNS_MAX_PACKET + 1, 0));
+
+    TEST_ASSERT_EQUAL_INT(6, dns->processRequests());
+    TEST_ASSERT_EQUAL_size_t(0, hostUdp().sent.size());
+    TEST_ASSERT_EQUAL_UINT32(6, dns->getDropped());
+    TEST_ASSERT_EQUAL_UINT32(6, dns->getQueries());
+}
+
+void test_one_call_drains_a_bounded_number_of_queries(void) {
+    for (int i = 0; i < DNS_MAX_QUERIES_PER_CALL + 8; i++) {
+        send(query(TYPE_A));
+    }
+
+    TEST_ASSERT_EQUAL_INT(DNS_MAX_QUERIES_PER_CALL, dns->processRequests());
+    TEST_ASSERT_EQUAL_INT(8, dns->processRequests());
+    TEST_ASSERT_EQUAL_INT(0, dns->processRequests());
+    TEST_ASSERT_EQUAL_size_t(DNS_MAX_QUERIES_PER_CALL + 8, hostUdp().sent.size());
+}
+
+void test_loop_answers_when_the_task_cannot_start(void) {
+    CaptiveDns taskDns;
+    // The host has no tasks, so this falls back to answering from loop()
+    TEST_ASSERT_TRUE(taskDns.start(IPAddress(192, 168, 4, 1)));
+    send(query(TYPE_A));
+
+    taskDns.loop();
+
+    TEST_ASSERT_EQUAL_size_t(1, hostUdp().sent.size());
+    taskDns.stop();
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_a_query_gets_the_ap_address);
+    RUN_TEST(test_aaaa_query_gets_an_empty_answer);
+    RUN_TEST(test_other_types_get_nxdomain);
+    RUN_TEST(test_edns_record_is_dropped_from_the_reply);
+    RUN_TEST(test_malformed_packets_are_dropped);
+    RUN_TEST(test_one_call_drains_a_bounded_number_of_queries);
+    RUN_TEST(test_loop_answers_when_the_task_cannot_start);
+    return UNITY_END();
+}
@@ -0,0 +1,126 @@
+#include <unity.h>
+#include <WebServer.h>
+#include "captive_portal.h"
+
+// Replays the connectivity checks phones and laptops send right after joining
+// the setup AP, plus ordinary requests that must not be mistaken for one.
+#define PORTAL_URL "http://192.168.4.1/"
+
+struct ReplayedRequest {
+    const char* client;
+    const char* host;
+    const char* uri;
+    int onlineCode;             // 0: not a connectivity check
+    const char* onlineBody;     // Must appear in the online answer
+};
+
+static const ReplayedRequest REQUESTS[] = {
+    {"Android",          "connectivitycheck.gstatic.com", "/generate_204",              204, ""},
+    {"Android (old)",    "clients3.google.com",           "/generate_204",              204, ""},
+    {"Android (Google)", "www.google.com",                "/gen_204",                   204, ""},
+    {"Android (OEM)",    "connectivitycheck.android.com", "/generate_204",              204, ""},
+    {"iOS",              "captive.apple.com",             "/hotspot-detect.html",       200, "Success"},
+    {"iOS (other path)", "captive.apple.com",             "/",                          200, "Success"},
+    {"macOS (legacy)",   "www.apple.com",                 "/library/test/success.html", 200, "Success"},
+    {"iOS (mixed case)", "Captive.Apple.COM",             "/index.html",                200, "Success"},
+    {"Windows 10+",      "www.msftconnecttest.com",       "/connecttest.txt",           200, "Microsoft Connect Test"},
+    {"Windows 10+",      "www.msftconnecttest.com",       "/redirect",                  200, "Microsoft Connect Test"},
+    {"Windows 7",        "www.msftncsi.com",              "/ncsi.txt",                  200, "Microsoft NCSI"},
+    {"Firefox",          "detectportal.firefox.com",      "/success.txt",               200, "success\n"},
+    {"Firefox",          "detectportal.firefox.com",      "/canonical.html",            200, "captive-portal"},
+    {"Browser",          "192.168.4.1",                   "/favicon.ico",               0,   nullptr},
+    {"Browser",          "example.com",                   "/index.html",                0,   nullptr},
+    {"App",              "api.example.com",               "/generate_2040",             0,   nullptr}
+};
+
+#define REQUEST_COUNT (sizeof(REQUESTS) / sizeof(REQUESTS[0]))
+
+static CaptivePortal portal;
+
+void setUp(void) {
+    portal.begin(IPAddress(192, 168, 4, 1));
+}
+
+void tearDown(void) {}
+
+static void prepare(WebServer& server, const ReplayedRequest& request) {
+    server.requestHost = request.host;
+    server.requestUri = request.uri;
+}
+
+static void assertRedirected(const WebServer& server) {
+    TEST_ASSERT_EQUAL_INT(302, server.code);
+    TEST_ASSERT_EQUAL_STRING(PORTAL_URL, server.header("Location"));
+    TEST_ASSERT_EQUAL_STRING("no-cache, no-store, must-revalidate", server.header("Cache-Control"));
+    // Clients that ignore Location get a page with the link
+    TEST_ASSERT_TRUE(server.body.find("href='" PORTAL_URL "'") != std::string::npos);
+    TEST_ASSERT_TRUE(server.body.rfind("</html>") == server.body.size() - 7);
+}
+
+void test_replayed_requests_match_the_right_probe(void) {
+    for (size_t i = 0; i < REQUEST_COUNT; i++) {
+        WebServer server;
+        prepare(server, REQUESTS[i]);
+
+        const CaptiveProbe* probe = portal.match(server);
+
+        if (REQUESTS[i].onlineCode == 0) {
+            TEST_ASSERT_NULL(probe);
+        } else {
+            TEST_ASSERT_NOT_NULL(probe);
+            TEST_ASSERT_EQUAL_INT(REQUESTS[i].onlineCode, probe->onlineCode);
+        }
+    }
+}
+
+void test_probes_are_sent_to_the_portal_until_wifi_is_configured(void) {
+    for (size_t i = 0; i < REQUEST_COUNT; i++) {
+        if (REQUESTS[i].onlineCode == 0) {
+            continue;
+        }
+        WebServer server;
+        prepare(server, REQUESTS[i]);
+
+        portal.answerProbe(server, *portal.match(server), true);
+
+        assertRedirected(server);
+    }
+}
+
+void test_probes_get_the_online_answer_once_wifi_is_configured(void) {
+    for (size_t i = 0; i < REQUEST_COUNT; i++) {
+        if (REQUESTS[i].onlineCode == 0) {
+            continue;
+        }
+        WebServer server;
+        prepare(server, REQUESTS[i]);
+
+        portal.answerProbe(server, *portal.match(server), false);
+
+        TEST_ASSERT_EQUAL_INT(REQUESTS[i].onlineCode, server.code);
+        TEST_ASSERT_EQUAL_STRING("no-cache, no-store, must-revalidate", server.header("Cache-Control"));
+        if (REQUESTS[i].onlineCode == 204) {
+            TEST_ASSERT_EQUAL_size_t(0, server.body.size());
+        } else {
+            TEST_ASSERT_TRUE(server.body.find(REQUESTS[i].onlineBody) != std::string::npos);
+        }
+    }
+}
+
+void test_other_requests_are_redirected(void) {
+    WebServer server;
+    prepare(server, REQUESTS[REQUEST_COUNT - 1]);
+
+    portal.redirect(server);
+
+    assertRedirected(server);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_replayed_requests_match_the_right_probe);
+    RUN_TEST(test_probes_are_sent_to_the_portal_until_wifi_is_configured);
+    RUN_TEST(test_probes_get_the_online_answer_once_wifi_is_configured);
+    RUN_TEST(test_other_requests_are_redirected);
+    return UNITY_END();
+}
@@ -0,0 +1,138 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "fir_decimator.h"
+
+// Noise floor and CPU cost of the three acquisition pipelines on simulated
+// sensor streams: on-chip 4x averaging at 100Hz vs host FIR decimation from
+// 400/800Hz, all ending at the 25Hz processing rate. Run with
+//     pio test -e native -f test_decimation_benchmark -v
+// to see the table. The host timings only compare the pipelines with each
+// other; the multiply-add and I2C byte counts are what carry over to the ESP32.
+//
+// Stream model: every raw ADC sample gets the same white noise (the sensor's
+// datasheet noise is per conversion; shorter pulse widths at 800Hz add more,
+// which this does not model) plus a 120Hz ambient flicker from mains lighting.
+
+#define BASELINE 100000                // DC level, keeps the unsigned stream away from 0
+#define NOISE_SIGMA 40.0               // White noise per raw sample, ADC counts
+#define FLICKER_AMPLITUDE 200.0        // 120Hz ambient flicker, ADC counts
+#define FLICKER_HZ 120.0
+#define OUTPUT_RATE_HZ 25
+#define BENCH_OUTPUTS 20000            // Output samples per pipeline
+#define WARMUP_OUTPUTS 16              // Discarded while the FIR delay line fills
+
+struct PipelineResult {
+    double noiseRms;                   // Output noise, ADC counts RMS
+    double nsPerOutput;                // Host CPU time per output sample
+};
+
+static uint32_t rngState;
+
+static double uniform() {
+    // xorshift32, so every run sees the same stream
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState + 1.0) / 4294967297.0;
+}
+
+static double gaussian() {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+// Noise-only raw stream at rateHz; the pipelines are linear, so the output
+// noise floor is measured without a PPG signal in the way
+static void makeStream(uint32_t* raw, int count, int rateHz) {
+    rngState = 0x12345678;
+    for (int i = 0; i < count; i++) {
+        double t = (double)i / rateHz;
+        double value = BASELINE + NOISE_SIGMA * gaussian() + FLICKER_AMPLITUDE * sin(2.0 * M_PI * FLICKER_HZ * t);
+        raw[i] = (uint32_t)lround(value);
+    }
+}
+
+static double rmsAroundBaseline(const uint32_t* out, int count) {
+    double sum = 0;
+    for (int i = WARMUP_OUTPUTS; i < count; i++) {
+        double deviation = (double)out[i] - BASELINE;
+        sum += deviation * deviation;
+    }
+    return sqrt(sum / (count - WARMUP_OUTPUTS));
+}
+
+static uint32_t rawStream[BENCH_OUTPUTS * FIR_DECIM32_FACTOR];
+static uint32_t output[BENCH_OUTPUTS];
+
+static PipelineResult runOnChipAverage() {
+    // The MAX30105 averages 4 conversions at 100Hz before they reach the FIFO;
+    // the host only copies the result
+    const int factor = 4;
+    makeStream(rawStream, BENCH_OUTPUTS * factor, OUTPUT_RATE_HZ * factor);
+    for (int i = 0; i < BENCH_OUTPUTS; i++) {
+        uint32_t sum = 0;
+        for (int j = 0; j < factor; j++) {
+            sum += rawStream[i * factor + j];
+        }
+        output[i] = sum / factor;
+    }
+    PipelineResult result;
+    result.noiseRms = rmsAroundBaseline(output, BENCH_OUTPUTS);
+    result.nsPerOutput = 0;            // The averaging runs on the sensor
+    return result;
+}
+
+template <int TAPS>
+static PipelineResult runFir(const int16_t* taps, int factor) {
+    makeStream(rawStream, BENCH_OUTPUTS * factor, OUTPUT_RATE_HZ * factor);
+    FirDecimator<TAPS> fir;
+    fir.configure(taps, TAPS, factor);
+    int produced = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_OUTPUTS * factor; i++) {
+        uint32_t out;
+        if (fir.push(rawStream[i], out)) {
+            output[produced++] = out;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    PipelineResult result;
+    result.noiseRms = rmsAroundBaseline(output, produced);
+    result.nsPerOutput = std::chrono::duration<double, std::nano>(end - start).count() / produced;
+    return result;
+}
+
+static void report(const char* name, const PipelineResult& result, double reference, int macs, int i2cBytes) {
+    printf("%-22s noise %6.2f counts (%+6.1f dB)  host %7.1f ns/output  %3d MAC/output  %4d I2C bytes/output\n",
+           name, result.noiseRms, 20.0 * log10(result.noiseRms / reference), result.nsPerOutput, macs, i2cBytes);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_host_decimation_lowers_the_noise_floor(void) {
+    PipelineResult onChip = runOnChipAverage();
+    PipelineResult fir16 = runFir<FIR_DECIM16_TAP_COUNT>(FIR_DECIM16_TAPS, FIR_DECIM16_FACTOR);
+    PipelineResult fir32 = runFir<FIR_DECIM32_TAP_COUNT>(FIR_DECIM32_TAPS, FIR_DECIM32_FACTOR);
+
+    // RED + IR, 3 bytes each, per FIFO sample read
+    const int bytesPerSample = 2 * 3;
+    printf("\n");
+    report("on-chip 4x @ 100Hz", onChip, onChip.noiseRms, 0, bytesPerSample);
+    report("host FIR/16 @ 400Hz", fir16, onChip.noiseRms, FIR_DECIM16_TAP_COUNT / 2,
+           bytesPerSample * FIR_DECIM16_FACTOR);
+    report("host FIR/32 @ 800Hz", fir32, onChip.noiseRms, FIR_DECIM32_TAP_COUNT / 2,
+           bytesPerSample * FIR_DECIM32_FACTOR);
+
+    // The boxcar leaves the flicker aliased into the passband; the FIR removes
+    // it and averages more conversions per output
+    TEST_ASSERT_TRUE(fir16.noiseRms < onChip.noiseRms / 2);
+    TEST_ASSERT_TRUE(fir32.noiseRms < fir16.noiseRms);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_host_decimation_lowers_the_noise_floor);
+    return UNITY_END();
+}
@@ -0,0 +1,191 @@
+#include <unity.h>
+#include "max30105_fifo.h"
+
+// Register-level model of the MAX30105 FIFO with FIFO_ROLLOVER_EN set: a full
+// FIFO overwrites its oldest sample, which moves the read pointer along with
+// the write pointer and counts the loss in OVF_COUNTER (saturating at 0x1F).
+// Popping a sample clears OVF_COUNTER.
+struct FakeFifo {
+    uint8_t writePtr;
+    uint8_t readPtr;
+    uint8_t overflow;
+    int stored;
+    uint8_t reservedBits;       // Set in every pointer register read, to check the masking
+
+    FakeFifo() : writePtr(0), readPtr(0), overflow(0), stored(0), reservedBits(0) {}
+
+    void sample(int count = 1) {
+        for (int i = 0; i < count; i++) {
+            writePtr = (writePtr + 1) & MAX30105_FIFO_PTR_MASK;
+            if (stored == MAX30105_FIFO_DEPTH) {
+                readPtr = (readPtr + 1) & MAX30105_FIFO_PTR_MASK;
+                if (overflow < MAX30105_OVF_SATURATED) {
+                    overflow++;
+                }
+            } else {
+                stored++;
+            }
+        }
+    }
+
+    void pop(int count) {
+        for (int i = 0; i < count && stored > 0; i++) {
+            readPtr = (readPtr + 1) & MAX30105_FIFO_PTR_MASK;
+            stored--;
+            overflow = 0;
+        }
+    }
+
+    FifoPointers registers() const {
+        FifoPointers pointers = {(uint8_t)(writePtr | reservedBits), overflow, (uint8_t)(readPtr | reservedBits)};
+        return pointers;
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_empty_fifo_has_no_samples(void) {
+    FakeFifo fifo;
+    TEST_ASSERT_EQUAL_INT(0, fifoPendingSamples(fifo.registers()));
+}
+
+void test_counts_samples_behind_the_write_pointer(void) {
+    FakeFifo fifo;
+    fifo.sample(5);
+    TEST_ASSERT_EQUAL_INT(5, fifoPendingSamples(fifo.registers()));
+    fifo.pop(3);
+    TEST_ASSERT_EQUAL_INT(2, fifoPendingSamples(fifo.registers()));
+}
+
+void test_write_pointer_wrapping_past_the_read_pointer(void) {
+    FakeFifo fifo;
+    fifo.sample(30);
+    fifo.pop(30);
+    fifo.sample(10);            // Write pointer wraps to 8, read pointer stays at 30
+    TEST_ASSERT_EQUAL_INT(8, fifo.writePtr);
+    TEST_ASSERT_EQUAL_INT(30, fifo.readPtr);
+    TEST_ASSERT_EQUAL_INT(10, fifoPendingSamples(fifo.registers()));
+}
+
+void test_exactly_full_fifo_reads_as_empty_until_a_sample_is_lost(void) {
+    FakeFifo fifo;
+    fifo.sample(MAX30105_FIFO_DEPTH);
+    // Nothing overwritten yet, so the registers look the same as an empty FIFO
+    TEST_ASSERT_EQUAL_INT(0, fifo.overflow);
+    TEST_ASSERT_EQUAL_INT(0, fifoPendingSamples(fifo.registers()));
+    // One period later the loss shows up in OVF_COUNTER
+    fifo.sample();
+    TEST_ASSERT_EQUAL_INT(1, fifo.overflow);
+    TEST_ASSERT_EQUAL_INT(MAX30105_FIFO_DEPTH, fifoPendingSamples(fifo.registers()));
+}
+
+void test_stopped_sensor_is_never_full(void) {
+    // No new samples for a long time: still empty, whatever the time since the last read
+    FakeFifo fifo;
+    fifo.sample(10);
+    fifo.pop(10);
+    TEST_ASSERT_EQUAL_INT(0, fifoPendingSamples(fifo.registers()));
+}
+
+void test_overflowed_fifo_is_full(void) {
+    FakeFifo fifo;
+    fifo.sample(MAX30105_FIFO_DEPTH + 8);
+    TEST_ASSERT_EQUAL_INT(8, fifo.overflow);
+    TEST_ASSERT_EQUAL_INT(MAX30105_FIFO_DEPTH, fifoPendingSamples(fifo.registers()));
+}
+
+void test_saturated_overflow_counter_is_still_full(void) {
+    FakeFifo fifo;
+    fifo.sample(MAX30105_FIFO_DEPTH + 100);
+    TEST_ASSERT_EQUAL_INT(MAX30105_OVF_SATURATED, fifo.overflow);
+    TEST_ASSERT_EQUAL_INT(MAX30105_FIFO_DEPTH, fifoPendingSamples(fifo.registers()));
+}
+
+void test_draining_an_overflowed_fifo_clears_the_overflow(void) {
+    FakeFifo fifo;
+    fifo.sample(MAX30105_FIFO_DEPTH + 3);
+    fifo.pop(MAX30105_FIFO_DEPTH);
+    TEST_ASSERT_EQUAL_INT(0, fifoPendingSamples(fifo.registers()));
+    fifo.sample(4);
+    TEST_ASSERT_EQUAL_INT(4, fifoPendingSamples(fifo.registers()));
+}
+
+void test_reserved_pointer_bits_are_ignored(void) {
+    FakeFifo fifo;
+    fifo.reservedBits = 0xE0;
+    fifo.sample(30);
+    fifo.pop(28);
+    fifo.sample(6);
+    TEST_ASSERT_EQUAL_INT(8, fifoPendingSamples(fifo.registers()));
+}
+
+void test_clock_model_inside_the_last_period_is_kept(void) {
+    TEST_ASSERT_EQUAL_INT32(0, sampleClockCorrection(10000, 10000, 2500));
+    TEST_ASSERT_EQUAL_INT32(0, sampleClockCorrection(10000, 12500, 2500));
+}
+
+void test_clock_model_running_late_is_pulled_forward(void) {
+    TEST_ASSERT_EQUAL_INT32(300, sampleClockCorrection(10000, 12800, 2500));
+}
+
+void test_clock_model_ahead_of_now_is_pulled_back(void) {
+    TEST_ASSERT_EQUAL_INT32(-40, sampleClockCorrection(10040, 10000, 2500));
+}
+
+void test_clock_correction_across_micros_wrap(void) {
+    TEST_ASSERT_EQUAL_INT32(0, sampleClockCorrection(0xFFFFFF00, 0x00000100, 2500));
+    TEST_ASSERT_EQUAL_INT32(100, sampleClockCorrection(0xFFFFFF00, 0x00000928, 2500));
+}
+
+void test_counter_timestamps_follow_a_drifting_sensor_clock(void) {
+    // The sensor oscillator runs 1% fast: 400 Hz nominal, a sample every 2475 us.
+    // Timestamps advance by the nominal period, and the correction keeps the
+    // newest one within a period of the time the FIFO was read.
+    const uint32_t period = 2500;
+    const uint32_t actualPeriod = 2475;
+    uint32_t sampleCount = 0;
+    uint32_t nextTime = 0;
+    int corrections = 0;
+    for (uint32_t now = 10000; now < 10000000; now += 10000) {
+        uint32_t produced = now / actualPeriod;
+        int samples = (int)(produced - sampleCount);
+        sampleCount = produced;
+        if (samples == 0) {
+            continue;
+        }
+
+        uint32_t newest = nextTime + (samples - 1) * period;
+        int32_t correction = sampleClockCorrection(newest, now, period);
+        if (correction != 0) {
+            corrections++;
+            nextTime += correction;
+            newest += correction;
+        }
+        TEST_ASSERT_TRUE((int32_t)(now - newest) >= 0);
+        TEST_ASSERT_TRUE(now - newest <= period);
+        nextTime = newest + period;
+    }
+    // 10 s at 1% drift is 40 periods; corrected in a few dozen steps, not on every read
+    TEST_ASSERT_TRUE(corrections > 0);
+    TEST_ASSERT_TRUE(corrections < 100);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_fifo_has_no_samples);
+    RUN_TEST(test_counts_samples_behind_the_write_pointer);
+    RUN_TEST(test_write_pointer_wrapping_past_the_read_pointer);
+    RUN_TEST(test_exactly_full_fifo_reads_as_empty_until_a_sample_is_lost);
+    RUN_TEST(test_stopped_sensor_is_never_full);
+    RUN_TEST(test_overflowed_fifo_is_full);
+    RUN_TEST(test_saturated_overflow_counter_is_still_full);
+    RUN_TEST(test_draining_an_overflowed_fifo_clears_the_overflow);
+    RUN_TEST(test_reserved_pointer_bits_are_ignored);
+    RUN_TEST(test_clock_model_inside_the_last_period_is_kept);
+    RUN_TEST(test_clock_model_running_late_is_pulled_forward);
+    RUN_TEST(test_clock_model_ahead_of_now_is_pulled_back);
+    RUN_TEST(test_clock_correction_across_micros_wrap);
+    RUN_TEST(test_counter_timestamps_follow_a_drifting_sensor_clock);
+    return UNITY_END();
+}
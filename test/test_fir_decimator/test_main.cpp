@@ -0,0 +1,139 @@
+#include <unity.h>
+#include "fir_decimator.h"
+
+// Large enough that the negative taps never pull the output below zero
+#define BASELINE 100000
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static int32_t tapSum(const int16_t* taps, int count) {
+    int32_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += taps[i];
+    }
+    return sum;
+}
+
+static bool isSymmetric(const int16_t* taps, int count) {
+    for (int i = 0; i < count / 2; i++) {
+        if (taps[i] != taps[count - 1 - i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_taps_have_unity_dc_gain_and_are_symmetric(void) {
+    TEST_ASSERT_EQUAL_INT32(32768, tapSum(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT));
+    TEST_ASSERT_EQUAL_INT32(32768, tapSum(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT));
+    TEST_ASSERT_TRUE(isSymmetric(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT));
+    TEST_ASSERT_TRUE(isSymmetric(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT));
+}
+
+void test_emits_one_output_per_factor_inputs(void) {
+    FirDecimator<FIR_DECIM16_TAP_COUNT> fir;
+    fir.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+    uint32_t out;
+    int outputs = 0;
+    for (int i = 0; i < 10 * FIR_DECIM16_FACTOR; i++) {
+        if (fir.push(BASELINE, out)) {
+            outputs++;
+            TEST_ASSERT_EQUAL_INT(FIR_DECIM16_FACTOR - 1, i % FIR_DECIM16_FACTOR);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(10, outputs);
+}
+
+void test_passes_samples_through_until_the_delay_line_is_full(void) {
+    FirDecimator<FIR_DECIM16_TAP_COUNT> fir;
+    fir.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+    uint32_t out = 0;
+    for (int i = 0; i < FIR_DECIM16_FACTOR; i++) {
+        fir.push(1000 + i, out);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000 + FIR_DECIM16_FACTOR - 1, out);
+}
+
+void test_step_response_settles_at_the_step_height(void) {
+    FirDecimator<FIR_DECIM32_TAP_COUNT> fir;
+    fir.configure(FIR_DECIM32_TAPS, FIR_DECIM32_TAP_COUNT, FIR_DECIM32_FACTOR);
+    uint32_t out = 0;
+    for (int i = 0; i < FIR_DECIM32_TAP_COUNT; i++) {
+        fir.push(BASELINE, out);
+    }
+    TEST_ASSERT_EQUAL_UINT32(BASELINE, out);
+
+    // Once the step has filled the delay line the output is exactly the new level
+    for (int i = 0; i < FIR_DECIM32_TAP_COUNT; i++) {
+        fir.push(BASELINE + 5000, out);
+    }
+    TEST_ASSERT_EQUAL_UINT32(BASELINE + 5000, out);
+}
+
+void test_step_response_is_half_way_at_the_midpoint(void) {
+    FirDecimator<FIR_DECIM16_TAP_COUNT> fir;
+    fir.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+    uint32_t out = 0;
+    for (int i = 0; i < FIR_DECIM16_TAP_COUNT; i++) {
+        fir.push(BASELINE, out);
+    }
+
+    // Outputs while the step moves through the window: symmetric taps put the
+    // output at half the step once the step fills half the window
+    uint32_t outputs[FIR_DECIM16_TAP_COUNT / FIR_DECIM16_FACTOR];
+    int count = 0;
+    for (int i = 0; i < FIR_DECIM16_TAP_COUNT; i++) {
+        if (fir.push(BASELINE + 32768, out)) {
+            outputs[count++] = out;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(4, count);
+    TEST_ASSERT_TRUE(outputs[0] < outputs[1]);
+    TEST_ASSERT_TRUE(outputs[1] < outputs[2]);
+    TEST_ASSERT_EQUAL_UINT32(BASELINE + 32768, outputs[3]);
+    TEST_ASSERT_EQUAL_UINT32(BASELINE + 32768 / 2, outputs[1]);
+}
+
+void test_impulse_response_samples_the_taps(void) {
+    FirDecimator<FIR_DECIM16_TAP_COUNT> fir;
+    fir.configure(FIR_DECIM16_TAPS, FIR_DECIM16_TAP_COUNT, FIR_DECIM16_FACTOR);
+    uint32_t out = 0;
+    for (int i = 0; i < FIR_DECIM16_TAP_COUNT; i++) {
+        fir.push(BASELINE, out);
+    }
+
+    // A Q15 unit impulse comes out as the taps it meets at each output instant
+    // (its age in samples, mirrored by symmetry), then the filter returns to the baseline
+    int age = 0;
+    int outputs = 0;
+    fir.push(BASELINE + 32768, out);
+    for (int i = 1; i < 2 * FIR_DECIM16_TAP_COUNT; i++) {
+        age++;
+        if (fir.push(BASELINE, out)) {
+            int32_t expected = age < FIR_DECIM16_TAP_COUNT ? FIR_DECIM16_TAPS[age] : 0;
+            TEST_ASSERT_EQUAL_INT32(BASELINE + expected, (int32_t)out);
+            outputs++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(8, outputs);
+}
+
+void test_unconfigured_filter_passes_samples_through(void) {
+    FirDecimator<FIR_DECIM16_TAP_COUNT> fir;
+    uint32_t out = 0;
+    TEST_ASSERT_TRUE(fir.push(1234, out));
+    TEST_ASSERT_EQUAL_UINT32(1234, out);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_taps_have_unity_dc_gain_and_are_symmetric);
+    RUN_TEST(test_emits_one_output_per_factor_inputs);
+    RUN_TEST(test_passes_samples_through_until_the_delay_line_is_full);
+    RUN_TEST(test_step_response_settles_at_the_step_height);
+    RUN_TEST(test_step_response_is_half_way_at_the_midpoint);
+    RUN_TEST(test_impulse_response_samples_the_taps);
+    RUN_TEST(test_unconfigured_filter_passes_samples_through);
+    return UNITY_END();
+}
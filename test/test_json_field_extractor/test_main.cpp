@@ -0,0 +1,166 @@
+#include <unity.h>
+#include "json_field_extractor.h"
+
+static JsonFieldExtractor extractor;
+static char summary[32];
+static char etag[8];
+static char count[12];
+static int summaryField;
+static int etagField;
+static int countField;
+
+void setUp(void) {
+    extractor = JsonFieldExtractor();
+    summaryField = extractor.addField("summary", summary, sizeof(summary));
+    etagField = extractor.addField("etag", etag, sizeof(etag));
+    countField = extractor.addField("count", count, sizeof(count));
+}
+
+void tearDown(void) {}
+
+static void feed(const char* json) {
+    extractor.write((const uint8_t*)json, strlen(json));
+}
+
+// The same input in chunks of every size up to the whole document
+static void feedInChunks(const char* json, size_t chunk) {
+    size_t length = strlen(json);
+    for (size_t offset = 0; offset < length; offset += chunk) {
+        size_t count = (length - offset < chunk) ? length - offset : chunk;
+        extractor.write((const uint8_t*)json + offset, count);
+    }
+}
+
+void test_extracts_selected_top_level_fields(void) {
+    feed("{\"other\":\"x\",\"summary\":\"Normal range\",\"count\":42,\"etag\":\"v1\"}");
+    TEST_ASSERT_TRUE(extractor.isFound(summaryField));
+    TEST_ASSERT_EQUAL_STRING("Normal range", summary);
+    TEST_ASSERT_EQUAL_STRING("v1", etag);
+    TEST_ASSERT_EQUAL_STRING("42", count);
+}
+
+void test_missing_field_is_not_found(void) {
+    feed("{\"summary\":\"ok\"}");
+    TEST_ASSERT_TRUE(extractor.isFound(summaryField));
+    TEST_ASSERT_FALSE(extractor.isFound(etagField));
+    TEST_ASSERT_EQUAL_STRING("", etag);
+}
+
+void test_nested_values_are_skipped(void) {
+    feed("{\"data\":{\"summary\":\"nested\",\"list\":[1,{\"etag\":\"x\"}]},\"summary\":\"top\"}");
+    TEST_ASSERT_EQUAL_STRING("top", summary);
+    TEST_ASSERT_FALSE(extractor.isFound(etagField));
+}
+
+void test_scalars_are_copied_as_written(void) {
+    feed("{ \"count\" : -12.5e3 , \"etag\":null}");
+    TEST_ASSERT_EQUAL_STRING("-12.5e3", count);
+    TEST_ASSERT_EQUAL_STRING("null", etag);
+}
+
+void test_result_does_not_depend_on_chunk_boundaries(void) {
+    const char* json = "{\"summary\":\"a\\\"b\\u00e9\\ud83d\\ude00\",\"count\":7}";
+    for (size_t chunk = 1; chunk <= strlen(json); chunk++) {
+        extractor.reset();
+        feedInChunks(json, chunk);
+        TEST_ASSERT_EQUAL_STRING("a\"b\xC3\xA9\xF0\x9F\x98\x80", summary);
+        TEST_ASSERT_EQUAL_STRING("7", count);
+    }
+}
+
+void test_simple_escapes(void) {
+    feed("{\"summary\":\"\\\"q\\\" \\\\ \\/ \\n\\t\\r\\b\\f\"}");
+    TEST_ASSERT_EQUAL_STRING("\"q\" \\ / \n\t\r\b\f", summary);
+}
+
+void test_unicode_escapes_become_utf8(void) {
+    feed("{\"summary\":\"\\u0041\\u00E9\\u20ac\"}");
+    TEST_ASSERT_EQUAL_STRING("A\xC3\xA9\xE2\x82\xAC", summary);
+}
+
+void test_surrogate_pair_becomes_one_character(void) {
+    feed("{\"summary\":\"\\uD83D\\uDE00\"}");
+    TEST_ASSERT_EQUAL_STRING("\xF0\x9F\x98\x80", summary);
+}
+
+void test_nul_escape_is_replaced(void) {
+    feed("{\"summary\":\"a\\u0000b\"}");
+    TEST_ASSERT_EQUAL_STRING("a\xEF\xBF\xBD" "b", summary);
+}
+
+void test_high_surrogate_before_another_escape_is_replaced(void) {
+    // The second escape is not a low surrogate, so it is decoded on its own
+    feed("{\"summary\":\"\\ud83d\\u0041\"}");
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBD" "A", summary);
+
+    extractor.reset();
+    feed("{\"summary\":\"\\ud83d\\ud83d\\ude00\"}");
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBD\xF0\x9F\x98\x80", summary);
+
+    extractor.reset();
+    feed("{\"summary\":\"\\ud83d\\n\"}");
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBD\n", summary);
+}
+
+void test_unpaired_surrogates_are_replaced(void) {
+    feed("{\"summary\":\"\\ud83dx\\ude00\",\"etag\":\"\\ud83d\"}");
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBDx\xEF\xBF\xBD", summary);
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBD", etag);
+}
+
+void test_malformed_unicode_escape_is_replaced(void) {
+    feed("{\"summary\":\"\\u12x\",\"count\":1}");
+    TEST_ASSERT_EQUAL_STRING("\xEF\xBF\xBDx", summary);
+    TEST_ASSERT_EQUAL_STRING("1", count);
+}
+
+void test_truncation_keeps_whole_characters(void) {
+    // 7 bytes fit in etag: "abcde" plus a 3-byte character only has room for 2
+    feed("{\"etag\":\"abcde\\u20acz\"}");
+    TEST_ASSERT_TRUE(extractor.isTruncated(etagField));
+    TEST_ASSERT_EQUAL_STRING("abcde", etag);
+}
+
+void test_long_value_is_truncated_not_overrun(void) {
+    feed("{\"etag\":\"0123456789\",\"count\":3}");
+    TEST_ASSERT_TRUE(extractor.isTruncated(etagField));
+    TEST_ASSERT_EQUAL_STRING("0123456", etag);
+    TEST_ASSERT_EQUAL_STRING("3", count);
+}
+
+void test_overlong_key_matches_nothing(void) {
+    feed("{\"summaryxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\":\"no\",\"count\":1}");
+    TEST_ASSERT_FALSE(extractor.isFound(summaryField));
+    TEST_ASSERT_EQUAL_STRING("1", count);
+}
+
+void test_reset_clears_previous_response(void) {
+    feed("{\"summary\":\"first\"}");
+    extractor.reset();
+    TEST_ASSERT_FALSE(extractor.isFound(summaryField));
+    TEST_ASSERT_EQUAL_STRING("", summary);
+    feed("{\"count\":2}");
+    TEST_ASSERT_FALSE(extractor.isFound(summaryField));
+    TEST_ASSERT_EQUAL_STRING("2", count);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_extracts_selected_top_level_fields);
+    RUN_TEST(test_missing_field_is_not_found);
+    RUN_TEST(test_nested_values_are_skipped);
+    RUN_TEST(test_scalars_are_copied_as_written);
+    RUN_TEST(test_result_does_not_depend_on_chunk_boundaries);
+    RUN_TEST(test_simple_escapes);
+    RUN_TEST(test_unicode_escapes_become_utf8);
+    RUN_TEST(test_surrogate_pair_becomes_one_character);
+    RUN_TEST(test_nul_escape_is_replaced);
+    RUN_TEST(test_high_surrogate_before_another_escape_is_replaced);
+    RUN_TEST(test_unpaired_surrogates_are_replaced);
+    RUN_TEST(test_malformed_unicode_escape_is_replaced);
+    RUN_TEST(test_truncation_keeps_whole_characters);
+    RUN_TEST(test_long_value_is_truncated_not_overrun);
+    RUN_TEST(test_overlong_key_matches_nothing);
+    RUN_TEST(test_reset_clears_previous_response);
+    return UNITY_END();
+}
@@ -0,0 +1,187 @@
+#include <unity.h>
+#include <FS.h>
+#include <Preferences.h>
+#include "measurement_queue.h"
+
+void setUp(void) {
+    hostFiles().clear();
+    hostPreferences().clear();
+}
+
+void tearDown(void) {}
+
+static std::vector<uint8_t>& ringFile() {
+    return hostFiles()[MEASUREMENT_QUEUE_FILE];
+}
+
+// Flips one byte of the heart rate field in the record's slot
+static void corrupt(uint32_t sequence) {
+    size_t offset = (sequence % MEASUREMENT_QUEUE_CAPACITY) * sizeof(QueuedMeasurement) +
+                    offsetof(QueuedMeasurement, heartRate);
+    ringFile()[offset] ^= 0xFF;
+}
+
+void test_begin_preallocates_an_empty_ring(void) {
+    MeasurementQueue queue;
+    TEST_ASSERT_TRUE(queue.begin());
+    TEST_ASSERT_EQUAL_size_t(MEASUREMENT_QUEUE_CAPACITY * sizeof(QueuedMeasurement), ringFile().size());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());
+
+    QueuedMeasurement record;
+    TEST_ASSERT_EQUAL_INT(0, queue.peek(&record, 1));
+}
+
+void test_records_are_peeked_oldest_first_until_acked(void) {
+    MeasurementQueue queue;
+    queue.begin();
+    TEST_ASSERT_EQUAL_UINT32(1, queue.append(72, 98, "user-a"));
+    TEST_ASSERT_EQUAL_UINT32(2, queue.append(80, 97, ""));
+    TEST_ASSERT_EQUAL_UINT32(3, queue.append(65, 99, "user-b"));
+
+    QueuedMeasurement records[4];
+    TEST_ASSERT_EQUAL_INT(2, queue.peek(records, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, records[0].sequence);
+    TEST_ASSERT_EQUAL_INT32(72, records[0].heartRate);
+    TEST_ASSERT_EQUAL_INT32(98, records[0].spo2);
+    TEST_ASSERT_EQUAL_STRING("user-a", records[0].userId);
+    TEST_ASSERT_EQUAL_STRING("", records[1].userId);
+
+    // Peeking doesn't remove anything
+    TEST_ASSERT_EQUAL_INT(3, queue.peek(records, 4));
+
+    queue.ack(2);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.pending());
+    TEST_ASSERT_EQUAL_INT(1, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_UINT32(3, records[0].sequence);
+}
+
+void test_ack_outside_the_queue_is_ignored(void) {
+    MeasurementQueue queue;
+    queue.begin();
+    queue.append(72, 98, "");
+    queue.append(73, 98, "");
+    queue.ack(2);
+    queue.ack(1);               // Already acknowledged
+    queue.ack(5);               // Never written
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getAckedSequence());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());
+}
+
+void test_head_and_tail_survive_a_reboot(void) {
+    {
+        MeasurementQueue queue;
+        queue.begin();
+        queue.append(70, 96, "");
+        queue.append(71, 97, "");
+        queue.append(72, 98, "");
+        queue.ack(1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, hostPreferences()[MEASUREMENT_QUEUE_NVS "/acked"]);
+
+    MeasurementQueue queue;
+    queue.begin();
+    TEST_ASSERT_EQUAL_UINT32(2, queue.pending());
+    TEST_ASSERT_EQUAL_UINT32(3, queue.getLastSequence());
+    TEST_ASSERT_EQUAL_UINT32(4, queue.append(73, 99, ""));
+
+    QueuedMeasurement records[4];
+    TEST_ASSERT_EQUAL_INT(3, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_UINT32(2, records[0].sequence);
+    TEST_ASSERT_EQUAL_INT32(71, records[0].heartRate);
+}
+
+void test_torn_write_at_the_tail_is_discarded_on_reboot(void) {
+    {
+        MeasurementQueue queue;
+        queue.begin();
+        queue.append(70, 96, "");
+        queue.append(71, 97, "");
+        queue.append(72, 98, "");
+    }
+    corrupt(3);
+
+    MeasurementQueue queue;
+    queue.begin();
+    TEST_ASSERT_EQUAL_UINT32(2, queue.getLastSequence());
+
+    // The slot is reused by the next record
+    TEST_ASSERT_EQUAL_UINT32(3, queue.append(75, 95, ""));
+    QueuedMeasurement records[4];
+    TEST_ASSERT_EQUAL_INT(3, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_INT32(75, records[2].heartRate);
+}
+
+void test_damaged_head_record_is_skipped(void) {
+    MeasurementQueue queue;
+    queue.begin();
+    queue.append(70, 96, "");
+    queue.append(71, 97, "");
+    queue.append(72, 98, "");
+    corrupt(1);
+
+    QueuedMeasurement records[4];
+    TEST_ASSERT_EQUAL_INT(2, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_UINT32(2, records[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getAckedSequence());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDropped());
+}
+
+void test_damaged_record_ends_a_batch_until_it_reaches_the_head(void) {
+    MeasurementQueue queue;
+    queue.begin();
+    queue.append(70, 96, "");
+    queue.append(71, 97, "");
+    queue.append(72, 98, "");
+    corrupt(2);
+
+    QueuedMeasurement records[4];
+    TEST_ASSERT_EQUAL_INT(1, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_UINT32(1, records[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(0, queue.getDropped());
+
+    queue.ack(1);
+    TEST_ASSERT_EQUAL_INT(1, queue.peek(records, 4));
+    TEST_ASSERT_EQUAL_UINT32(3, records[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDropped());
+}
+
+void test_full_queue_drops_the_oldest_record(void) {
+    MeasurementQueue queue;
+    queue.begin();
+    for (int i = 0; i < MEASUREMENT_QUEUE_CAPACITY + 1; i++) {
+        queue.append(60 + i % 40, 95, "");
+    }
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_QUEUE_CAPACITY, queue.pending());
+    TEST_ASSERT_EQUAL_UINT32(1, queue.getDropped());
+
+    QueuedMeasurement record;
+    TEST_ASSERT_EQUAL_INT(1, queue.peek(&record, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, record.sequence);
+
+    // Still consistent after a reboot
+    MeasurementQueue rebooted;
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_QUEUE_CAPACITY, rebooted.pending());
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_QUEUE_CAPACITY + 1, rebooted.getLastSequence());
+}
+
+void test_not_ready_before_begin(void) {
+    MeasurementQueue queue;
+    TEST_ASSERT_FALSE(queue.isReady());
+    TEST_ASSERT_EQUAL_UINT32(0, queue.append(70, 96, ""));
+    TEST_ASSERT_EQUAL_UINT32(0, queue.pending());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_preallocates_an_empty_ring);
+    RUN_TEST(test_records_are_peeked_oldest_first_until_acked);
+    RUN_TEST(test_ack_outside_the_queue_is_ignored);
+    RUN_TEST(test_head_and_tail_survive_a_reboot);
+    RUN_TEST(test_torn_write_at_the_tail_is_discarded_on_reboot);
+    RUN_TEST(test_damaged_head_record_is_skipped);
+    RUN_TEST(test_damaged_record_ends_a_batch_until_it_reaches_the_head);
+    RUN_TEST(test_full_queue_drops_the_oldest_record);
+    RUN_TEST(test_not_ready_before_begin);
+    return UNITY_END();
+}
@@ -0,0 +1,240 @@
+#include <unity.h>
+#include <FS.h>
+#include <Preferences.h>
+#include <HTTPClient.h>
+#include "measurement_uploader.h"
+
+// The uploader runs on the real UplinkClient and MeasurementQueue; the server
+// is the scripted HTTPClient fake, which records every request it receives.
+#define BACKEND "http://backend.test"
+#define UID "esp-123456789abc"            // getDeviceUid() for the host's fixed eFuse MAC
+
+static UplinkClient* uplink;
+static MeasurementQueue* queue;
+static MeasurementUploader* uploader;
+
+void setUp(void) {
+    hostFiles().clear();
+    hostPreferences().clear();
+    hostHttp().clear();
+    hostWiFi().status = WL_CONNECTED;
+    hostState().millis = 0;
+
+    uplink = new UplinkClient();
+    uplink->begin(BACKEND);
+    queue = new MeasurementQueue();
+    queue->begin();
+    uploader = new MeasurementUploader(*uplink, *queue);
+}
+
+void tearDown(void) {
+    delete uploader;
+    delete queue;
+    delete uplink;
+}
+
+static const HostHttpRequest& request(size_t index) {
+    return hostHttp().requests[index];
+}
+
+static void queueRecords(int count, const char* userId) {
+    for (int i = 0; i < count; i++) {
+        queue->append(70 + i, 97, userId);
+        uploader->noteQueued();
+    }
+}
+
+void test_records_of_one_user_go_out_as_one_batch(void) {
+    queueRecords(3, "user-a");
+    hostHttp().respond(201);
+
+    TEST_ASSERT_EQUAL_INT(3, uploader->uploadBatch());
+
+    TEST_ASSERT_EQUAL_size_t(1, hostHttp().requests.size());
+    TEST_ASSERT_EQUAL_STRING("POST", request(0).method.c_str());
+    TEST_ASSERT_EQUAL_STRING(BACKEND UPLOAD_BATCH_PATH, request(0).url.c_str());
+    TEST_ASSERT_EQUAL_STRING(UID "-1-3", request(0).header("Idempotency-Key"));
+    TEST_ASSERT_EQUAL_STRING("user-a", request(0).header("X-User-Id"));
+    TEST_ASSERT_EQUAL_STRING("{\"records\":["
+                             "{\"id\":\"" UID "-1\",\"heart_rate\":70,\"spo2\":97},"
+                             "{\"id\":\"" UID "-2\",\"heart_rate\":71,\"spo2\":97},"
+                             "{\"id\":\"" UID "-3\",\"heart_rate\":72,\"spo2\":97}]}",
+                             request(0).payload.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, queue->pending());
+    TEST_ASSERT_EQUAL_UINT32(3, uploader->getUploaded());
+}
+
+void test_failed_batch_is_retried_unchanged_under_the_same_key(void) {
+    queueRecords(2, "user-a");
+    hostHttp().respond(503);
+    hostHttp().respond(HTTPC_ERROR_READ_TIMEOUT);   // Server may have stored it, the response was lost
+    hostHttp().respond(200);
+    hostHttp().respond(200);
+
+    TEST_ASSERT_EQUAL_INT(-1, uploader->uploadBatch());
+    // More records arrive while the batch is pending; they must not join it
+    queueRecords(2, "user-a");
+    TEST_ASSERT_EQUAL_INT(-1, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_UINT32(4, queue->pending());
+
+    TEST_ASSERT_EQUAL_INT(2, uploader->uploadBatch());
+    for (size_t i = 1; i < 3; i++) {
+        TEST_ASSERT_EQUAL_STRING(UID "-1-2", request(i).header("Idempotency-Key"));
+        TEST_ASSERT_EQUAL_STRING(request(0).payload.c_str(), request(i).payload.c_str());
+    }
+
+    // Once acknowledged, the next batch picks up the newer records
+    TEST_ASSERT_EQUAL_INT(2, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_STRING(UID "-3-4", request(3).header("Idempotency-Key"));
+    TEST_ASSERT_EQUAL_UINT32(0, queue->pending());
+}
+
+void test_batch_stops_where_the_user_changes(void) {
+    queueRecords(2, "user-a");
+    queueRecords(1, "user-b");
+    queueRecords(1, "");                             // Guest measurement
+    for (int i = 0; i < 3; i++) {
+        hostHttp().respond(200);
+    }
+
+    TEST_ASSERT_EQUAL_INT(2, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_INT(1, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_INT(1, uploader->uploadBatch());
+
+    TEST_ASSERT_EQUAL_STRING("user-a", request(0).header("X-User-Id"));
+    TEST_ASSERT_EQUAL_STRING(UID "-1-2", request(0).header("Idempotency-Key"));
+    TEST_ASSERT_EQUAL_STRING("user-b", request(1).header("X-User-Id"));
+    TEST_ASSERT_EQUAL_STRING(UID "-3-3", request(1).header("Idempotency-Key"));
+    TEST_ASSERT_NULL(request(2).header("X-User-Id"));
+    TEST_ASSERT_EQUAL_UINT32(0, queue->pending());
+}
+
+void test_batch_is_capped(void) {
+    queueRecords(UPLOAD_BATCH_MAX + 4, "user-a");
+    hostHttp().respond(200);
+    hostHttp().respond(200);
+
+    TEST_ASSERT_EQUAL_INT(UPLOAD_BATCH_MAX, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_INT(4, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_INT(0, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_size_t(2, hostHttp().requests.size());
+}
+
+void test_missing_batch_endpoint_falls_back_to_one_request_per_record(void) {
+    int fallbackCodes[] = {404, 405};
+    for (int n = 0; n < 2; n++) {
+        tearDown();
+        setUp();
+        queueRecords(3, "user-a");
+        hostHttp().respond(fallbackCodes[n]);
+        for (int i = 0; i < 3; i++) {
+            hostHttp().respond(201);
+        }
+
+        TEST_ASSERT_EQUAL_INT(3, uploader->uploadBatch());
+
+        TEST_ASSERT_EQUAL_size_t(4, hostHttp().requests.size());
+        for (size_t i = 1; i < 4; i++) {
+            char id[40];
+            snprintf(id, sizeof(id), UID "-%u", (unsigned)i);
+            TEST_ASSERT_EQUAL_STRING(BACKEND UPLOAD_SINGLE_PATH, request(i).url.c_str());
+            // The record id is the key, so each record is deduplicated on its own
+            TEST_ASSERT_EQUAL_STRING(id, request(i).header("Idempotency-Key"));
+            TEST_ASSERT_TRUE(strstr(request(i).payload.c_str(), id) != nullptr);
+            TEST_ASSERT_EQUAL_STRING("user-a", request(i).header("X-User-Id"));
+        }
+        TEST_ASSERT_EQUAL_UINT32(0, queue->pending());
+
+        // The batch endpoint is not tried again
+        queueRecords(1, "user-a");
+        hostHttp().respond(201);
+        TEST_ASSERT_EQUAL_INT(1, uploader->uploadBatch());
+        TEST_ASSERT_EQUAL_STRING(BACKEND UPLOAD_SINGLE_PATH, request(4).url.c_str());
+    }
+}
+
+void test_fallback_keeps_the_records_that_did_not_go_through(void) {
+    queueRecords(3, "user-a");
+    hostHttp().respond(404);
+    hostHttp().respond(201);
+    hostHttp().respond(500);
+
+    TEST_ASSERT_EQUAL_INT(-1, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_UINT32(2, queue->pending());
+
+    hostHttp().respond(201);
+    hostHttp().respond(201);
+    TEST_ASSERT_EQUAL_INT(2, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_STRING(UID "-2", request(3).header("Idempotency-Key"));
+    TEST_ASSERT_EQUAL_STRING(UID "-3", request(4).header("Idempotency-Key"));
+    TEST_ASSERT_EQUAL_UINT32(0, queue->pending());
+    TEST_ASSERT_EQUAL_UINT32(3, uploader->getUploaded());
+}
+
+void test_bytes_and_requests_count_every_body_sent(void) {
+    queueRecords(4, "user-a");
+    hostHttp().respond(200);
+    uploader->uploadBatch();
+    uint32_t batchBytes = uploader->getBytes();
+    TEST_ASSERT_EQUAL_UINT32(request(0).payload.size(), batchBytes);
+
+    // The rejected batch attempt counts as well as the records sent one by one
+    queueRecords(4, "user-a");
+    hostHttp().respond(404);
+    for (int i = 0; i < 4; i++) {
+        hostHttp().respond(201);
+    }
+    uploader->uploadBatch();
+
+    uint32_t sent = 0;
+    for (size_t i = 0; i < hostHttp().requests.size(); i++) {
+        sent += request(i).payload.size();
+    }
+    TEST_ASSERT_EQUAL_UINT32(sent, uploader->getBytes());
+    TEST_ASSERT_EQUAL_UINT32(6, uploader->getRequests());
+    TEST_ASSERT_EQUAL_UINT32(8, uploader->getUploaded());
+
+    // Per record, the batch body costs no more than the single ones plus its envelope
+    uint32_t singleBytes = uploader->getBytes() - batchBytes - request(1).payload.size();
+    TEST_ASSERT_TRUE(batchBytes / 4 <= singleBytes / 4 + 4);
+}
+
+void test_nothing_is_acknowledged_while_offline(void) {
+    queueRecords(2, "user-a");
+    hostWiFi().status = WL_DISCONNECTED;
+
+    TEST_ASSERT_EQUAL_INT(-1, uploader->uploadBatch());
+    TEST_ASSERT_EQUAL_size_t(0, hostHttp().requests.size());
+    TEST_ASSERT_EQUAL_UINT32(2, queue->pending());
+}
+
+void test_batch_is_due_when_full_or_after_the_window(void) {
+    // A backlog found at boot goes out at once
+    TEST_ASSERT_FALSE(uploader->isDue(0));
+    TEST_ASSERT_TRUE(uploader->isDue(3));
+
+    uploader->noteQueued();
+    TEST_ASSERT_FALSE(uploader->isDue(1));
+    TEST_ASSERT_TRUE(uploader->isDue(UPLOAD_BATCH_MAX));
+
+    // Later records don't restart the window
+    hostState().millis = UPLOAD_BATCH_WINDOW_MS - 1;
+    uploader->noteQueued();
+    TEST_ASSERT_FALSE(uploader->isDue(2));
+    hostState().millis = UPLOAD_BATCH_WINDOW_MS;
+    TEST_ASSERT_TRUE(uploader->isDue(2));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_records_of_one_user_go_out_as_one_batch);
+    RUN_TEST(test_failed_batch_is_retried_unchanged_under_the_same_key);
+    RUN_TEST(test_batch_stops_where_the_user_changes);
+    RUN_TEST(test_batch_is_capped);
+    RUN_TEST(test_missing_batch_endpoint_falls_back_to_one_request_per_record);
+    RUN_TEST(test_fallback_keeps_the_records_that_did_not_go_through);
+    RUN_TEST(test_bytes_and_requests_count_every_body_sent);
+    RUN_TEST(test_nothing_is_acknowledged_while_offline);
+    RUN_TEST(test_batch_is_due_when_full_or_after_the_window);
+    return UNITY_END();
+}
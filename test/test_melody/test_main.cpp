@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <vector>
+#include "tone_player.h"
+
+// MELODY() is evaluated by the compiler
+static_assert(MELODY(NOTE_C6, REST, REST, NOTE_E6).length == 2, "RESTs merge into the note before them");
+static_assert(MELODY(REST, REST, NOTE_C6).steps[0].pitch == 0, "Leading RESTs become a silent step");
+
+struct Event {
+    unsigned long ms;
+    int frequency;
+};
+
+void setUp(void) {
+    hostState() = HostState();
+}
+
+void tearDown(void) {}
+
+static void assertStep(const Melody& melody, int index, int frequency, int beats) {
+    TEST_ASSERT_TRUE(index < melody.length);
+    TEST_ASSERT_EQUAL_INT(frequency, MELODY_PITCHES[melody.steps[index].pitch]);
+    TEST_ASSERT_EQUAL_INT(beats, melody.steps[index].beats);
+}
+
+// Tone changes of the removed blocking playMelody() for an int-array melody
+static std::vector<Event> legacySchedule(const int* notes, int count, int tempoDivisor) {
+    const int noteMs = 1000 / tempoDivisor;
+    const int beatMs = (int)(noteMs * 1.3);
+    std::vector<Event> events;
+    for (int i = 0; i < count; i++) {
+        if (notes[i] != REST) {
+            events.push_back(Event{(unsigned long)(i * beatMs), notes[i]});
+            events.push_back(Event{(unsigned long)(i * beatMs + noteMs), 0});
+        }
+    }
+    return events;
+}
+
+// Tone changes while TonePlayer plays the compiled melody, 1 ms per loop()
+static std::vector<Event> playerSchedule(const Melody& melody, int tempoDivisor) {
+    TonePlayer player;
+    std::vector<Event> events;
+    hostState().millis = 0;
+    player.play(melody, tempoDivisor, TONE_PRIORITY_ALERT);
+    int frequency = 0;
+    while (true) {
+        if ((int)hostState().toneFrequency != frequency || hostState().toneWrites > 0) {
+            frequency = (int)hostState().toneFrequency;
+            events.push_back(Event{hostState().millis, frequency});
+            hostState().toneWrites = 0;
+        }
+        if (!player.isPlaying()) {
+            break;
+        }
+        hostState().millis++;
+        player.loop();
+    }
+    return events;
+}
+
+static void assertSameSchedule(const std::vector<Event>& expected, const std::vector<Event>& actual) {
+    TEST_ASSERT_EQUAL_size_t(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected[i].ms, actual[i].ms);
+        TEST_ASSERT_EQUAL_INT(expected[i].frequency, actual[i].frequency);
+    }
+}
+
+void test_rests_merge_into_the_preceding_note(void) {
+    const Melody& melody = MELODY(NOTE_C6, REST, REST, NOTE_E6, NOTE_G6, REST);
+    TEST_ASSERT_EQUAL_INT(3, melody.length);
+    assertStep(melody, 0, NOTE_C6, 3);
+    assertStep(melody, 1, NOTE_E6, 1);
+    assertStep(melody, 2, NOTE_G6, 2);
+}
+
+void test_leading_rests_become_one_silent_step(void) {
+    const Melody& melody = MELODY(REST, REST, NOTE_A4, NOTE_A4);
+    TEST_ASSERT_EQUAL_INT(3, melody.length);
+    assertStep(melody, 0, REST, 2);
+    assertStep(melody, 1, NOTE_A4, 1);
+    assertStep(melody, 2, NOTE_A4, 1);
+}
+
+void test_single_rest_is_one_silent_step(void) {
+    const Melody& melody = MELODY(REST);
+    TEST_ASSERT_EQUAL_INT(1, melody.length);
+    assertStep(melody, 0, REST, 1);
+}
+
+void test_lowest_and_highest_pitches_are_known(void) {
+    const Melody& melody = MELODY(NOTE_B0, NOTE_DS8);
+    assertStep(melody, 0, NOTE_B0, 1);
+    assertStep(melody, 1, NOTE_DS8, 1);
+}
+
+void test_pitch_table_is_ascending_after_rest(void) {
+    TEST_ASSERT_EQUAL_INT(REST, MELODY_PITCHES[0]);
+    for (int i = 2; i < MELODY_PITCH_COUNT; i++) {
+        TEST_ASSERT_TRUE(MELODY_PITCHES[i - 1] < MELODY_PITCHES[i]);
+    }
+    TEST_ASSERT_TRUE(MELODY_PITCH_COUNT < MELODY_NO_PITCH);
+}
+
+void test_long_rest_run_fits_in_one_step(void) {
+    const Melody& melody = MELODY(NOTE_C4,
+        REST, REST, REST, REST, REST, REST, REST, REST, REST, REST,
+        REST, REST, REST, REST, REST, REST, REST, REST, REST, REST);
+    TEST_ASSERT_EQUAL_INT(1, melody.length);
+    assertStep(melody, 0, NOTE_C4, 21);
+}
+
+void test_playback_matches_the_int_array_melody(void) {
+    static const int notes[] = {REST, NOTE_E5, NOTE_E5, REST, NOTE_E5, REST, NOTE_C5, NOTE_E5, REST, REST, NOTE_G5};
+    const Melody& melody = MELODY(REST, NOTE_E5, NOTE_E5, REST, NOTE_E5, REST, NOTE_C5, NOTE_E5, REST, REST, NOTE_G5);
+    const int count = sizeof(notes) / sizeof(notes[0]);
+
+    assertSameSchedule(legacySchedule(notes, count, 4), playerSchedule(melody, 4));
+    assertSameSchedule(legacySchedule(notes, count, 25), playerSchedule(melody, 25));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rests_merge_into_the_preceding_note);
+    RUN_TEST(test_leading_rests_become_one_silent_step);
+    RUN_TEST(test_single_rest_is_one_silent_step);
+    RUN_TEST(test_lowest_and_highest_pitches_are_known);
+    RUN_TEST(test_pitch_table_is_ascending_after_rest);
+    RUN_TEST(test_long_rest_run_fits_in_one_step);
+    RUN_TEST(test_playback_matches_the_int_array_melody);
+    return UNITY_END();
+}
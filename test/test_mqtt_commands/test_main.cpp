@@ -0,0 +1,244 @@
+#include <unity.h>
+#include <PubSubClient.h>
+#include "mqtt_manager.h"
+#include "msgpack_writer.h"
+
+// MQTTManager's command router against the PubSubClient fake, which shares one
+// buffer between the message being handled and everything published from it.
+#define DEVICE_TOPIC MQTT_TOPIC_PREFIX "esp-123456789abc/"
+#define BUZZER_PIN 25
+
+static TonePlayer* tones;
+static MQTTManager* mqtt;
+
+static int startCalls;
+static bool startResult;
+static int stopCalls;
+static int uploadCalls;
+
+static bool startMeasurement() {
+    startCalls++;
+    return startResult;
+}
+
+static void stopMeasurement() {
+    stopCalls++;
+}
+
+static bool upload() {
+    uploadCalls++;
+    return true;
+}
+
+void setUp(void) {
+    hostMqtt().clear();
+    hostWiFi().status = WL_CONNECTED;
+    hostState().millis = 1000;
+    startCalls = 0;
+    startResult = true;
+    stopCalls = 0;
+    uploadCalls = 0;
+
+    tones = new TonePlayer();
+    mqtt = new MQTTManager(BUZZER_PIN, *tones);
+    mqtt->begin();
+}
+
+void tearDown(void) {
+    delete mqtt;
+    delete tones;
+}
+
+static void command(const char* name, const char* args) {
+    char topic[MQTT_TOPIC_SIZE];
+    snprintf(topic, sizeof(topic), DEVICE_TOPIC "cmd/%s", name);
+    hostMqtt().deliver(topic, args);
+}
+
+static int countPublished(const char* kind) {
+    std::string topic = std::string(DEVICE_TOPIC) + kind;
+    int count = 0;
+    for (size_t i = 0; i < hostMqtt().published.size(); i++) {
+        if (hostMqtt().published[i].topic == topic) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// The last ack must be exactly {cmd, id, ok[, error]}; id is nil when null
+static void assertAck(const char* cmd, const char* id, bool ok, const char* error) {
+    uint8_t expected[MQTT_PAYLOAD_SIZE];
+    MsgPackWriter writer(expected, sizeof(expected));
+    writer.beginMap(ok ? 3 : 4);
+    writer.writeString("cmd");
+    writer.writeString(cmd);
+    writer.writeString("id");
+    if (id != nullptr) {
+        writer.writeString(id);
+    } else {
+        writer.writeNil();
+    }
+    writer.writeString("ok");
+    writer.writeBool(ok);
+    if (!ok) {
+        writer.writeString("error");
+        writer.writeString(error);
+    }
+
+    TEST_ASSERT_TRUE(hostMqtt().published.size() > 0);
+    const HostMqttMessage& ack = hostMqtt().published.back();
+    TEST_ASSERT_EQUAL_STRING(DEVICE_TOPIC "ack", ack.topic.c_str());
+    TEST_ASSERT_EQUAL_size_t(writer.getLength(), ack.payload.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, ack.payload.data(), writer.getLength());
+}
+
+void test_subscribes_to_the_notification_and_command_topics(void) {
+    TEST_ASSERT_EQUAL_size_t(2, hostMqtt().subscriptions.size());
+    TEST_ASSERT_EQUAL_STRING(DEVICE_ID, hostMqtt().subscriptions[0].c_str());
+    TEST_ASSERT_EQUAL_STRING(DEVICE_TOPIC "cmd/+", hostMqtt().subscriptions[1].c_str());
+}
+
+void test_command_name_comes_from_the_topic(void) {
+    mqtt->setStopMeasurementCallback(stopMeasurement);
+
+    command("stop", "{\"id\":\"s1\"}");
+
+    TEST_ASSERT_EQUAL_INT(1, stopCalls);
+    assertAck("stop", "s1", true, nullptr);
+}
+
+void test_unknown_command_is_refused(void) {
+    command("reboot", "{\"id\":\"r1\"}");
+    assertAck("reboot", "r1", false, "unknown_command");
+
+    // A name longer than the ack's copy is cut short and can't match anything
+    mqtt->setStopMeasurementCallback(stopMeasurement);
+    command("stopstopstopstopstop", "");
+    TEST_ASSERT_EQUAL_INT(0, stopCalls);
+    assertAck("stopstopstopsto", nullptr, false, "unknown_command");
+}
+
+void test_invalid_json_is_refused_before_the_handler_runs(void) {
+    mqtt->setStartMeasurementCallback(startMeasurement);
+
+    command("start", "{\"id\":\"x1\",");
+
+    TEST_ASSERT_EQUAL_INT(0, startCalls);
+    assertAck("start", nullptr, false, "invalid_json");
+}
+
+void test_arguments_are_optional(void) {
+    mqtt->setStartMeasurementCallback(startMeasurement);
+
+    command("start", "");
+
+    TEST_ASSERT_EQUAL_INT(1, startCalls);
+    assertAck("start", nullptr, true, nullptr);
+}
+
+void test_handler_failures_carry_their_error(void) {
+    command("start", "{\"id\":\"a\"}");
+    assertAck("start", "a", false, "not_ready");
+
+    mqtt->setStartMeasurementCallback(startMeasurement);
+    startResult = false;
+    command("start", "{\"id\":\"b\"}");
+    TEST_ASSERT_EQUAL_INT(1, startCalls);
+    assertAck("start", "b", false, "not_ready");
+
+    command("upload", "{\"id\":\"c\"}");
+    assertAck("upload", "c", false, "offline");
+    mqtt->setUploadCallback(upload);
+    command("upload", "{\"id\":\"d\"}");
+    TEST_ASSERT_EQUAL_INT(1, uploadCalls);
+    assertAck("upload", "d", true, nullptr);
+}
+
+void test_request_id_survives_a_handler_that_publishes(void) {
+    // status publishes its report before the ack, reusing the buffer the
+    // command arrived in
+    command("status", "{\"id\":\"req-0123456789-abcdefghij-0123456\"}");
+
+    TEST_ASSERT_EQUAL_INT(1, countPublished("status"));
+    assertAck("status", "req-0123456789-abcdefghij-0123456", true, nullptr);
+}
+
+void test_config_rejects_invalid_settings(void) {
+    const char* invalid[][2] = {
+        {"{}",                                         "no_settings"},
+        {"{\"heartbeat_s\":9}",                        "invalid_heartbeat_s"},
+        {"{\"heartbeat_s\":3601}",                     "invalid_heartbeat_s"},
+        {"{\"heartbeat_s\":\"60\"}",                   "invalid_heartbeat_s"},
+        {"{\"heartbeat_s\":30.5}",                     "invalid_heartbeat_s"},
+        {"{\"notifications\":1}",                      "invalid_notifications"},
+        {"{\"heartbeat_s\":30,\"notifications\":\"no\"}", "invalid_notifications"}
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        command("config", invalid[i][0]);
+        assertAck("config", nullptr, false, invalid[i][1]);
+    }
+
+    // Nothing was applied, not even the valid heartbeat next to the bad flag
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(1, countPublished("heartbeat"));
+    hostState().millis += 30000;
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(1, countPublished("heartbeat"));
+    hostState().millis += MQTT_HEARTBEAT_INTERVAL_MS - 30000;
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(2, countPublished("heartbeat"));
+}
+
+void test_config_sets_the_heartbeat_interval(void) {
+    command("config", "{\"heartbeat_s\":30}");
+    assertAck("config", nullptr, true, nullptr);
+
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(1, countPublished("heartbeat"));
+    hostState().millis += 29999;
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(1, countPublished("heartbeat"));
+    hostState().millis += 1;
+    mqtt->loop();
+    TEST_ASSERT_EQUAL_INT(2, countPublished("heartbeat"));
+}
+
+void test_config_mutes_notifications_but_not_alerts(void) {
+    command("config", "{\"notifications\":false}");
+    assertAck("config", nullptr, true, nullptr);
+
+    hostMqtt().deliver(DEVICE_ID, "hello");
+    TEST_ASSERT_FALSE(tones->isPlaying());
+
+    command("alert", "{\"melody\":\"win\"}");
+    assertAck("alert", nullptr, true, nullptr);
+    TEST_ASSERT_TRUE(tones->isPlaying());
+
+    command("alert", "{\"melody\":\"siren\"}");
+    assertAck("alert", nullptr, false, "unknown_melody");
+}
+
+void test_notification_topic_plays_the_melody(void) {
+    hostMqtt().deliver(DEVICE_ID, "hello");
+
+    TEST_ASSERT_TRUE(tones->isPlaying());
+    // No ack: it is not a command
+    TEST_ASSERT_EQUAL_INT(0, countPublished("ack"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_subscribes_to_the_notification_and_command_topics);
+    RUN_TEST(test_command_name_comes_from_the_topic);
+    RUN_TEST(test_unknown_command_is_refused);
+    RUN_TEST(test_invalid_json_is_refused_before_the_handler_runs);
+    RUN_TEST(test_arguments_are_optional);
+    RUN_TEST(test_handler_failures_carry_their_error);
+    RUN_TEST(test_request_id_survives_a_handler_that_publishes);
+    RUN_TEST(test_config_rejects_invalid_settings);
+    RUN_TEST(test_config_sets_the_heartbeat_interval);
+    RUN_TEST(test_config_mutes_notifications_but_not_alerts);
+    RUN_TEST(test_notification_topic_plays_the_melody);
+    return UNITY_END();
+}
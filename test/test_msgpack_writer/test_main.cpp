@@ -0,0 +1,145 @@
+#include <unity.h>
+#include "msgpack_writer.h"
+
+static uint8_t buffer[320];
+
+void setUp(void) {
+    memset(buffer, 0xAA, sizeof(buffer));
+}
+
+void tearDown(void) {}
+
+#define ASSERT_ENCODES(call, ...) do { \
+    const uint8_t expected[] = {__VA_ARGS__}; \
+    MsgPackWriter writer(buffer, sizeof(buffer)); \
+    writer.call; \
+    TEST_ASSERT_FALSE(writer.hasOverflowed()); \
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), writer.getLength()); \
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buffer, sizeof(expected)); \
+} while (0)
+
+void test_unsigned_integer_boundaries(void) {
+    ASSERT_ENCODES(writeUInt(0), 0x00);
+    ASSERT_ENCODES(writeUInt(127), 0x7F);
+    ASSERT_ENCODES(writeUInt(128), 0xCC, 0x80);
+    ASSERT_ENCODES(writeUInt(255), 0xCC, 0xFF);
+    ASSERT_ENCODES(writeUInt(256), 0xCD, 0x01, 0x00);
+    ASSERT_ENCODES(writeUInt(65535), 0xCD, 0xFF, 0xFF);
+    ASSERT_ENCODES(writeUInt(65536), 0xCE, 0x00, 0x01, 0x00, 0x00);
+    ASSERT_ENCODES(writeUInt(0xFFFFFFFF), 0xCE, 0xFF, 0xFF, 0xFF, 0xFF);
+}
+
+void test_signed_integer_boundaries(void) {
+    ASSERT_ENCODES(writeInt(5), 0x05);
+    ASSERT_ENCODES(writeInt(200), 0xCC, 0xC8);
+    ASSERT_ENCODES(writeInt(-1), 0xFF);
+    ASSERT_ENCODES(writeInt(-32), 0xE0);
+    ASSERT_ENCODES(writeInt(-33), 0xD0, 0xDF);
+    ASSERT_ENCODES(writeInt(-128), 0xD0, 0x80);
+    ASSERT_ENCODES(writeInt(-129), 0xD1, 0xFF, 0x7F);
+    ASSERT_ENCODES(writeInt(-32768), 0xD1, 0x80, 0x00);
+    ASSERT_ENCODES(writeInt(-32769), 0xD2, 0xFF, 0xFF, 0x7F, 0xFF);
+    ASSERT_ENCODES(writeInt(INT32_MIN), 0xD2, 0x80, 0x00, 0x00, 0x00);
+}
+
+void test_string_length_boundaries(void) {
+    char text[300];
+    memset(text, 'x', sizeof(text));
+
+    text[31] = '\0';
+    MsgPackWriter fixstr(buffer, sizeof(buffer));
+    fixstr.writeString(text);
+    TEST_ASSERT_EQUAL_UINT8(0xBF, buffer[0]);
+    TEST_ASSERT_EQUAL_size_t(32, fixstr.getLength());
+
+    text[31] = 'x';
+    text[32] = '\0';
+    MsgPackWriter str8(buffer, sizeof(buffer));
+    str8.writeString(text);
+    TEST_ASSERT_EQUAL_UINT8(0xD9, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8(32, buffer[1]);
+    TEST_ASSERT_EQUAL_size_t(34, str8.getLength());
+
+    text[32] = 'x';
+    text[256] = '\0';
+    MsgPackWriter str16(buffer, sizeof(buffer));
+    str16.writeString(text);
+    TEST_ASSERT_EQUAL_UINT8(0xDA, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, buffer[1]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, buffer[2]);
+    TEST_ASSERT_EQUAL_size_t(259, str16.getLength());
+    TEST_ASSERT_FALSE(str16.hasOverflowed());
+
+    ASSERT_ENCODES(writeString(""), 0xA0);
+}
+
+void test_container_header_boundaries(void) {
+    ASSERT_ENCODES(beginMap(0), 0x80);
+    ASSERT_ENCODES(beginMap(15), 0x8F);
+    ASSERT_ENCODES(beginMap(16), 0xDE, 0x00, 0x10);
+    ASSERT_ENCODES(beginArray(15), 0x9F);
+    ASSERT_ENCODES(beginArray(300), 0xDC, 0x01, 0x2C);
+}
+
+void test_constants(void) {
+    ASSERT_ENCODES(writeBool(true), 0xC3);
+    ASSERT_ENCODES(writeBool(false), 0xC2);
+    ASSERT_ENCODES(writeNil(), 0xC0);
+}
+
+void test_map_of_key_value_pairs(void) {
+    MsgPackWriter writer(buffer, sizeof(buffer));
+    writer.beginMap(2);
+    writer.writeString("hr");
+    writer.writeInt(72);
+    writer.writeString("spo2");
+    writer.writeInt(98);
+    const uint8_t expected[] = {0x82, 0xA2, 'h', 'r', 0x48, 0xA4, 's', 'p', 'o', '2', 0x62};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expected), writer.getLength());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+void test_overflow_is_reported_and_stays_in_bounds(void) {
+    MsgPackWriter writer(buffer, 4);
+    writer.writeString("hello");
+    TEST_ASSERT_TRUE(writer.hasOverflowed());
+    TEST_ASSERT_TRUE(writer.getLength() <= 4);
+    TEST_ASSERT_EQUAL_UINT8(0xAA, buffer[4]);
+}
+
+void test_overflow_in_a_multi_byte_integer(void) {
+    MsgPackWriter writer(buffer, 3);
+    writer.writeUInt(70000);
+    TEST_ASSERT_TRUE(writer.hasOverflowed());
+    TEST_ASSERT_EQUAL_size_t(3, writer.getLength());
+    TEST_ASSERT_EQUAL_UINT8(0xAA, buffer[3]);
+}
+
+void test_overflow_is_sticky(void) {
+    MsgPackWriter writer(buffer, 2);
+    writer.writeString("abc");
+    writer.writeNil();
+    TEST_ASSERT_TRUE(writer.hasOverflowed());
+}
+
+void test_exactly_full_buffer_is_not_an_overflow(void) {
+    MsgPackWriter writer(buffer, 4);
+    writer.writeString("abc");
+    TEST_ASSERT_FALSE(writer.hasOverflowed());
+    TEST_ASSERT_EQUAL_size_t(4, writer.getLength());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unsigned_integer_boundaries);
+    RUN_TEST(test_signed_integer_boundaries);
+    RUN_TEST(test_string_length_boundaries);
+    RUN_TEST(test_container_header_boundaries);
+    RUN_TEST(test_constants);
+    RUN_TEST(test_map_of_key_value_pairs);
+    RUN_TEST(test_overflow_is_reported_and_stays_in_bounds);
+    RUN_TEST(test_overflow_in_a_multi_byte_integer);
+    RUN_TEST(test_overflow_is_sticky);
+    RUN_TEST(test_exactly_full_buffer_is_not_an_overflow);
+    return UNITY_END();
+}
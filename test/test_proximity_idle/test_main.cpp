@@ -0,0 +1,219 @@
+#include <unity.h>
+#include "proximity_idle.h"
+
+// Register-level model of the MAX30105 proximity function. Writing MODE_CONFIG
+// while PROX_INT_EN is set starts proximity mode: every sample period the IR
+// ADC count from the pilot LED is compared (8 MSBs of the 18-bit count) with
+// PROX_INT_THRESH, and once it is exceeded PROX_INT is set and the part goes
+// back to normal sampling. Reading interrupt status 1 clears it. Every driver
+// call is counted as the register reads and writes it costs on the bus.
+#define REG_INT_STATUS1 0x00
+#define REG_INT_ENABLE1 0x02
+#define REG_MODE_CONFIG 0x09
+#define REG_LED1_PA 0x0C                 // Red
+#define REG_LED2_PA 0x0D                 // IR
+#define REG_PILOT_PA 0x10
+#define REG_PROX_INT_THRESH 0x30
+#define PROX_INT_EN 0x10
+#define ADC_MAX 262143                   // 18-bit ADC
+
+struct FakeMax30105 {
+    uint8_t regs[256];
+    bool proximityMode;
+    uint32_t countsPerPilotStep;         // What sits on the sensor: IR ADC counts per pilot current step
+    int reads;
+    int writes;
+
+    FakeMax30105() : proximityMode(false), countsPerPilotStep(0), reads(0), writes(0) {
+        for (int i = 0; i < 256; i++) {
+            regs[i] = 0;
+        }
+        regs[REG_MODE_CONFIG] = MAX30105_MODE_SPO2;
+        regs[REG_LED1_PA] = 0x3C;
+        regs[REG_LED2_PA] = 0x3C;
+    }
+
+    uint8_t readRegister(uint8_t reg) {
+        reads++;
+        return regs[reg];
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+        writes++;
+        regs[reg] = value;
+    }
+
+    // One sample period of the part
+    void sample() {
+        if (!proximityMode) {
+            return;
+        }
+        uint32_t adc = countsPerPilotStep * regs[REG_PILOT_PA];
+        if (adc > ADC_MAX) {
+            adc = ADC_MAX;
+        }
+        if ((adc >> 10) > regs[REG_PROX_INT_THRESH]) {
+            regs[REG_INT_STATUS1] |= MAX30105_INT_PROX;
+            proximityMode = false;
+        }
+    }
+
+    // The driver calls used by ProximityIdle, as the SparkFun library issues them
+    void setPulseAmplitudeRed(uint8_t value) { writeRegister(REG_LED1_PA, value); }
+    void setPulseAmplitudeProximity(uint8_t value) { writeRegister(REG_PILOT_PA, value); }
+    void setPROXINTTHRESH(uint8_t value) { writeRegister(REG_PROX_INT_THRESH, value); }
+
+    uint8_t getINT1() {
+        uint8_t status = readRegister(REG_INT_STATUS1);
+        regs[REG_INT_STATUS1] = 0;
+        return status;
+    }
+
+    void enablePROXINT() {
+        writeRegister(REG_INT_ENABLE1, readRegister(REG_INT_ENABLE1) | PROX_INT_EN);
+    }
+
+    void setLEDMode(uint8_t mode) {
+        writeRegister(REG_MODE_CONFIG, (readRegister(REG_MODE_CONFIG) & 0xF8) | mode);
+        proximityMode = (regs[REG_INT_ENABLE1] & PROX_INT_EN) != 0;
+    }
+};
+
+// Misses enough windows to put the sensor into proximity mode at `now`
+static void goIdle(ProximityIdle<FakeMax30105>& gate, FakeMax30105& sensor, unsigned long now, bool multiLed = false) {
+    for (int i = 0; i < PROXIMITY_IDLE_AFTER_MISSES; i++) {
+        gate.fingerMissing(sensor, multiLed, now);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_keeps_measuring_until_enough_windows_miss(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+
+    for (int i = 0; i < PROXIMITY_IDLE_AFTER_MISSES - 1; i++) {
+        TEST_ASSERT_FALSE(gate.fingerMissing(sensor, false, 0));
+    }
+    // A window with a finger starts the count over
+    gate.fingerSeen();
+    TEST_ASSERT_FALSE(gate.fingerMissing(sensor, false, 0));
+    TEST_ASSERT_FALSE(gate.isIdle());
+    TEST_ASSERT_EQUAL_INT(0, sensor.reads + sensor.writes);
+
+    for (int i = 1; i < PROXIMITY_IDLE_AFTER_MISSES - 1; i++) {
+        gate.fingerMissing(sensor, false, 0);
+    }
+    TEST_ASSERT_TRUE(gate.fingerMissing(sensor, false, 0));
+    TEST_ASSERT_TRUE(gate.isIdle());
+}
+
+void test_entering_idle_arms_the_proximity_detector(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+
+    goIdle(gate, sensor, 0);
+
+    TEST_ASSERT_EQUAL_HEX8(0, sensor.regs[REG_LED1_PA]);
+    TEST_ASSERT_EQUAL_HEX8(PROXIMITY_PILOT_AMPLITUDE, sensor.regs[REG_PILOT_PA]);
+    TEST_ASSERT_EQUAL_HEX8(PROXIMITY_THRESHOLD, sensor.regs[REG_PROX_INT_THRESH]);
+    TEST_ASSERT_TRUE(sensor.regs[REG_INT_ENABLE1] & PROX_INT_EN);
+    TEST_ASSERT_EQUAL_HEX8(MAX30105_MODE_SPO2, sensor.regs[REG_MODE_CONFIG] & 0x07);
+    TEST_ASSERT_TRUE(sensor.proximityMode);
+}
+
+void test_multi_led_sensor_keeps_its_mode_while_idle(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+    sensor.regs[REG_MODE_CONFIG] = MAX30105_MODE_MULTILED;
+
+    goIdle(gate, sensor, 0, true);
+
+    TEST_ASSERT_EQUAL_HEX8(MAX30105_MODE_MULTILED, sensor.regs[REG_MODE_CONFIG] & 0x07);
+    TEST_ASSERT_TRUE(sensor.proximityMode);
+}
+
+void test_idle_costs_one_register_read_per_poll_interval(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+    goIdle(gate, sensor, 0);
+    sensor.countsPerPilotStep = 20;      // Ambient light only
+    int reads = sensor.reads;
+    int writes = sensor.writes;
+
+    // One second of loop() calls every millisecond, sensor sampling at 100Hz
+    for (unsigned long now = 1; now <= 1000; now++) {
+        if (now % 10 == 0) {
+            sensor.sample();
+        }
+        TEST_ASSERT_FALSE(gate.poll(sensor, now));
+    }
+
+    TEST_ASSERT_EQUAL_INT(1000 / PROXIMITY_POLL_INTERVAL_MS, sensor.reads - reads);
+    TEST_ASSERT_EQUAL_INT(0, sensor.writes - writes);
+    TEST_ASSERT_TRUE(gate.isIdle());
+    TEST_ASSERT_TRUE(sensor.proximityMode);
+}
+
+void test_finger_wakes_the_sensor_at_the_next_poll(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+    goIdle(gate, sensor, 0);
+
+    sensor.countsPerPilotStep = 1500;    // Finger over the window
+    sensor.sample();
+    TEST_ASSERT_TRUE(sensor.regs[REG_INT_STATUS1] & MAX30105_INT_PROX);
+    TEST_ASSERT_FALSE(sensor.proximityMode);
+
+    // Not before the poll interval is up
+    TEST_ASSERT_FALSE(gate.poll(sensor, PROXIMITY_POLL_INTERVAL_MS - 1));
+    TEST_ASSERT_TRUE(gate.poll(sensor, PROXIMITY_POLL_INTERVAL_MS));
+    TEST_ASSERT_FALSE(gate.isIdle());
+    // The read cleared the flag, and an awake gate no longer touches the bus
+    TEST_ASSERT_EQUAL_HEX8(0, sensor.regs[REG_INT_STATUS1]);
+    int reads = sensor.reads;
+    TEST_ASSERT_FALSE(gate.poll(sensor, 10 * PROXIMITY_POLL_INTERVAL_MS));
+    TEST_ASSERT_EQUAL_INT(reads, sensor.reads);
+}
+
+void test_stale_proximity_flag_does_not_wake(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+    // Left over from an earlier idle period
+    sensor.regs[REG_INT_STATUS1] = MAX30105_INT_PROX;
+
+    goIdle(gate, sensor, 0);
+
+    TEST_ASSERT_FALSE(gate.poll(sensor, PROXIMITY_POLL_INTERVAL_MS));
+    TEST_ASSERT_TRUE(gate.isIdle());
+}
+
+void test_reconfiguring_the_sensor_leaves_idle(void) {
+    FakeMax30105 sensor;
+    ProximityIdle<FakeMax30105> gate;
+    gate.fingerMissing(sensor, false, 0);
+    goIdle(gate, sensor, 0);
+
+    // configureSensor() soft-resets the part, which disarms PROX_INT
+    gate.reset();
+
+    TEST_ASSERT_FALSE(gate.isIdle());
+    TEST_ASSERT_FALSE(gate.poll(sensor, PROXIMITY_POLL_INTERVAL_MS));
+    // The miss count starts over as well
+    for (int i = 0; i < PROXIMITY_IDLE_AFTER_MISSES - 1; i++) {
+        TEST_ASSERT_FALSE(gate.fingerMissing(sensor, false, 0));
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_keeps_measuring_until_enough_windows_miss);
+    RUN_TEST(test_entering_idle_arms_the_proximity_detector);
+    RUN_TEST(test_multi_led_sensor_keeps_its_mode_while_idle);
+    RUN_TEST(test_idle_costs_one_register_read_per_poll_interval);
+    RUN_TEST(test_finger_wakes_the_sensor_at_the_next_poll);
+    RUN_TEST(test_stale_proximity_flag_does_not_wake);
+    RUN_TEST(test_reconfiguring_the_sensor_leaves_idle);
+    return UNITY_END();
+}
@@ -0,0 +1,54 @@
+#include <unity.h>
+#include "max30105_timing.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_keeps_the_preferred_width_when_it_fits(void) {
+    TEST_ASSERT_EQUAL_INT(411, max30105PulseWidthFor(100, 2, 411));
+    TEST_ASSERT_EQUAL_INT(411, max30105PulseWidthFor(100, 3, 411));
+    TEST_ASSERT_EQUAL_INT(215, max30105PulseWidthFor(100, 2, 215));
+}
+
+void test_never_widens_past_the_preferred_width(void) {
+    TEST_ASSERT_EQUAL_INT(118, max30105PulseWidthFor(50, 2, 118));
+    TEST_ASSERT_EQUAL_INT(118, max30105PulseWidthFor(50, 3, 200)); // Not a table width
+}
+
+void test_third_led_needs_a_narrower_pulse(void) {
+    TEST_ASSERT_EQUAL_INT(411, max30105PulseWidthFor(400, 2, 411));
+    TEST_ASSERT_EQUAL_INT(215, max30105PulseWidthFor(400, 3, 411));
+    TEST_ASSERT_EQUAL_INT(215, max30105PulseWidthFor(800, 2, 411));
+    TEST_ASSERT_EQUAL_INT(118, max30105PulseWidthFor(800, 3, 411));
+}
+
+void test_rates_between_table_rows_round_down_the_width(void) {
+    TEST_ASSERT_EQUAL_INT(215, max30105PulseWidthFor(201, 3, 411));
+    TEST_ASSERT_EQUAL_INT(69, max30105PulseWidthFor(1001, 2, 411));
+}
+
+void test_falls_back_to_the_narrowest_pulse(void) {
+    TEST_ASSERT_EQUAL_INT(69, max30105PulseWidthFor(1600, 3, 411));
+    TEST_ASSERT_EQUAL_INT(69, max30105PulseWidthFor(3200, 2, 411));
+}
+
+void test_every_width_fits_its_listed_rates(void) {
+    // Pulse plus conversion for each LED slot must fit the sample period
+    for (int i = 0; i < MAX30105_PULSE_WIDTH_COUNT; i++) {
+        const PulseWidthLimit& limit = MAX30105_PULSE_WIDTH_LIMITS[i];
+        TEST_ASSERT_TRUE(2 * limit.pulseWidthUs < 1000000 / limit.maxRateTwoLeds);
+        TEST_ASSERT_TRUE(3 * limit.pulseWidthUs < 1000000 / limit.maxRateThreeLeds);
+        TEST_ASSERT_TRUE(limit.maxRateThreeLeds <= limit.maxRateTwoLeds);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_keeps_the_preferred_width_when_it_fits);
+    RUN_TEST(test_never_widens_past_the_preferred_width);
+    RUN_TEST(test_third_led_needs_a_narrower_pulse);
+    RUN_TEST(test_rates_between_table_rows_round_down_the_width);
+    RUN_TEST(test_falls_back_to_the_narrowest_pulse);
+    RUN_TEST(test_every_width_fits_its_listed_rates);
+    return UNITY_END();
+}
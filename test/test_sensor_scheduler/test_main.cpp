@@ -0,0 +1,246 @@
+#include <unity.h>
+#include "probe_scheduler.h"
+
+// Simulated I2C bus shared by all probes: reading a FIFO sample and running the
+// HR/SpO2 algorithm advance one clock, and every probe's FIFO keeps filling
+// (and, when full, losing samples) against that clock while the others are served.
+#define SIM_FIFO_DEPTH 32              // MAX30105 FIFO
+#define SIM_HOP 25                     // SAMPLE_HOP: samples per processing pass
+#define SIM_SAMPLE_READ_US 200         // One 6-byte sample at 400kHz, with addressing
+#define SIM_PROCESS_US 30000           // One HR/SpO2 computation
+#define SIM_LOOP_US 1000               // Rest of loop() between scheduling rounds
+
+static uint64_t simClock;
+static int serviceLog[64];             // Probe ids in the order their FIFO was read
+static int serviceLogLength;
+
+struct SimulatedProbe {
+    int id;
+    uint32_t periodUs;                 // Spacing of samples arriving in the FIFO
+    uint64_t nextSampleUs;
+    int fifo;
+    uint32_t lost;                     // Samples overwritten in a full FIFO
+    int hopFill;
+    uint32_t hops;
+    bool ready;
+    bool idle;
+    bool measuring;
+    bool complete;
+    int idlePolls;
+
+    SimulatedProbe(int probeId, uint32_t period) :
+        id(probeId), periodUs(period), nextSampleUs(period), fifo(0), lost(0), hopFill(0), hops(0),
+        ready(true), idle(false), measuring(false), complete(false), idlePolls(0) {}
+
+    void catchUp() {
+        while (nextSampleUs <= simClock) {
+            if (fifo == SIM_FIFO_DEPTH) {
+                lost++;
+            } else {
+                fifo++;
+            }
+            nextSampleUs += periodUs;
+        }
+    }
+
+    int serviceFifo(int maxSamples) {
+        if (serviceLogLength < 64) {
+            serviceLog[serviceLogLength++] = id;
+        }
+        int moved = 0;
+        catchUp();
+        while (moved < maxSamples && hopFill < SIM_HOP && fifo > 0) {
+            fifo--;
+            hopFill++;
+            moved++;
+            simClock += SIM_SAMPLE_READ_US;
+            catchUp();
+        }
+        return moved;
+    }
+
+    void processReadings() {
+        if (idle) {
+            idlePolls++;
+            return;
+        }
+        if (hopFill >= SIM_HOP) {
+            hopFill = 0;
+            hops++;
+        }
+        simClock += SIM_PROCESS_US;
+    }
+
+    bool isReady() const { return ready; }
+    void setReady(bool value) { ready = value; }
+    bool isProximityIdle() const { return idle; }
+    bool isHopReady() const { return hopFill >= SIM_HOP; }
+    bool isMeasurementReady() const { return complete; }
+    bool isMeasurementInProgress() const { return measuring; }
+    void startMeasurement() { measuring = true; complete = false; }
+    void stopMeasurement() { measuring = false; }
+    bool checkI2CConnection() { return ready; }
+
+    void finish() { measuring = false; complete = true; }
+};
+
+static void runFor(ProbeScheduler<SimulatedProbe>& scheduler, uint64_t durationUs) {
+    uint64_t end = simClock + durationUs;
+    while (simClock < end) {
+        scheduler.service();
+        simClock += SIM_LOOP_US;
+    }
+}
+
+void setUp(void) {
+    simClock = 0;
+    serviceLogLength = 0;
+}
+void tearDown(void) {}
+
+void test_two_probes_at_25hz_never_overflow(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+
+    runFor(scheduler, 60000000ULL);
+    first.catchUp();
+    second.catchUp();
+
+    TEST_ASSERT_EQUAL_UINT32(0, first.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, second.lost);
+    // 60 s at 25 Hz is 60 hops per probe; at most the hop in progress is missing
+    TEST_ASSERT_TRUE(first.hops >= 59 && first.hops <= 60);
+    TEST_ASSERT_TRUE(second.hops >= 59 && second.hops <= 60);
+    TEST_ASSERT_EQUAL_UINT32(first.hops, scheduler.getHopsProcessed(0));
+    TEST_ASSERT_EQUAL_UINT32(second.hops, scheduler.getHopsProcessed(1));
+}
+
+void test_two_probes_at_100hz_never_overflow(void) {
+    // The FIFO lasts 320 ms, so a probe may not wait behind more than a few
+    // computations of the other
+    SimulatedProbe first(0, 10000), second(1, 10000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+
+    runFor(scheduler, 20000000ULL);
+    first.catchUp();
+    second.catchUp();
+
+    TEST_ASSERT_EQUAL_UINT32(0, first.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, second.lost);
+    TEST_ASSERT_TRUE(first.hops >= 79);
+    TEST_ASSERT_TRUE(second.hops >= 79);
+}
+
+void test_acquisition_order_rotates(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+
+    for (int round = 0; round < 4; round++) {
+        scheduler.service();
+    }
+
+    TEST_ASSERT_EQUAL_INT(8, serviceLogLength);
+    int expected[8] = {0, 1, 1, 0, 0, 1, 1, 0};
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_INT(expected[i], serviceLog[i]);
+    }
+}
+
+void test_bursts_are_bounded(void) {
+    SimulatedProbe first(0, 1000), second(1, 1000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+    simClock = 20000;                  // 20 samples waiting in each FIFO
+
+    scheduler.service();
+
+    TEST_ASSERT_EQUAL_UINT32(SCHEDULER_BURST_SAMPLES, scheduler.getSamplesAcquired(0));
+    TEST_ASSERT_EQUAL_UINT32(SCHEDULER_BURST_SAMPLES, scheduler.getSamplesAcquired(1));
+}
+
+void test_one_computation_per_round_alternating(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+    first.hopFill = SIM_HOP;
+    second.hopFill = SIM_HOP;
+
+    scheduler.service();
+    TEST_ASSERT_EQUAL_UINT32(1, first.hops);
+    TEST_ASSERT_EQUAL_UINT32(0, second.hops);
+
+    scheduler.service();
+    TEST_ASSERT_EQUAL_UINT32(1, first.hops);
+    TEST_ASSERT_EQUAL_UINT32(1, second.hops);
+}
+
+void test_idle_probe_gets_a_turn_to_poll(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+    second.idle = true;
+
+    runFor(scheduler, 2000000ULL);
+
+    // Its FIFO is left alone, but it is polled for a finger
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSamplesAcquired(1));
+    TEST_ASSERT_TRUE(second.idlePolls > 0);
+    TEST_ASSERT_TRUE(first.hops > 0);
+}
+
+void test_probe_that_is_not_ready_is_skipped(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+    first.ready = false;
+
+    TEST_ASSERT_TRUE(scheduler.isReady());
+    runFor(scheduler, 10000000ULL);
+    second.catchUp();
+
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.getSamplesAcquired(0));
+    TEST_ASSERT_EQUAL_UINT32(0, second.lost);
+    TEST_ASSERT_TRUE(second.hops >= 9);
+
+    scheduler.setReady(false);
+    TEST_ASSERT_FALSE(scheduler.isReady());
+}
+
+void test_session_completes_when_every_active_probe_finishes(void) {
+    SimulatedProbe first(0, 40000), second(1, 40000);
+    ProbeScheduler<SimulatedProbe> scheduler;
+    scheduler.addProbe(&first);
+    scheduler.addProbe(&second);
+
+    scheduler.startMeasurement();
+    TEST_ASSERT_TRUE(scheduler.isMeasurementInProgress());
+    first.finish();
+    TEST_ASSERT_FALSE(scheduler.isMeasurementComplete());
+
+    // A probe that drops off the bus no longer holds the session up
+    second.ready = false;
+    TEST_ASSERT_TRUE(scheduler.isMeasurementComplete());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_two_probes_at_25hz_never_overflow);
+    RUN_TEST(test_two_probes_at_100hz_never_overflow);
+    RUN_TEST(test_acquisition_order_rotates);
+    RUN_TEST(test_bursts_are_bounded);
+    RUN_TEST(test_one_computation_per_round_alternating);
+    RUN_TEST(test_idle_probe_gets_a_turn_to_poll);
+    RUN_TEST(test_probe_that_is_not_ready_is_skipped);
+    RUN_TEST(test_session_completes_when_every_active_probe_finishes);
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+#include <unity.h>
+#include "template_stream.h"
+
+static WebServer server;
+
+struct Page {
+    bool loggedIn;
+    bool connected;
+    const char* ssid;
+    int32_t heartRate;
+};
+
+static void pageValue(const char* name, TemplateStream& out, void* context) {
+    const Page* page = (const Page*)context;
+    if (strcmp(name, "SSID") == 0) {
+        out.printEscaped(page->ssid);
+    } else if (strcmp(name, "HR") == 0) {
+        out.print(page->heartRate);
+    } else if (strcmp(name, "IP") == 0) {
+        out.print(IPAddress(192, 168, 4, 1));
+    }
+    // Unknown names render as nothing
+}
+
+static bool pageSection(const char* name, void* context) {
+    const Page* page = (const Page*)context;
+    if (strcmp(name, "LOGGED_IN") == 0) {
+        return page->loggedIn;
+    }
+    if (strcmp(name, "CONNECTED") == 0) {
+        return page->connected;
+    }
+    return false;
+}
+
+static std::string render(const char* tpl, const Page& page) {
+    server = WebServer();
+    TemplateStream out(server);
+    out.begin(200, "text/html");
+    out.render(tpl, pageValue, pageSection, (void*)&page);
+    out.end();
+    return server.body;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_values_are_substituted(void) {
+    Page page = {false, false, "home", -72};
+    TEST_ASSERT_EQUAL_STRING("<p>home -72 192.168.4.1</p>",
+                             render("<p>{{SSID}} {{HR}} {{IP}}</p>", page).c_str());
+}
+
+void test_response_is_chunked_and_terminated(void) {
+    Page page = {false, false, "", 0};
+    render("abc", page);
+    TEST_ASSERT_EQUAL_INT(200, server.code);
+    TEST_ASSERT_TRUE(server.chunked);
+    TEST_ASSERT_EQUAL_size_t(2, server.chunks.size());
+    TEST_ASSERT_EQUAL_size_t(0, server.chunks.back());
+}
+
+void test_sections_follow_the_callback(void) {
+    const char* tpl = "{{#LOGGED_IN}}user{{/LOGGED_IN}}{{^LOGGED_IN}}guest{{/LOGGED_IN}}";
+    Page page = {true, false, "", 0};
+    TEST_ASSERT_EQUAL_STRING("user", render(tpl, page).c_str());
+    page.loggedIn = false;
+    TEST_ASSERT_EQUAL_STRING("guest", render(tpl, page).c_str());
+}
+
+void test_nested_sections_inside_a_hidden_one_stay_hidden(void) {
+    const char* tpl = "a{{#CONNECTED}}b{{#LOGGED_IN}}c{{/LOGGED_IN}}d{{/CONNECTED}}e";
+    Page page = {true, false, "", 0};
+    TEST_ASSERT_EQUAL_STRING("ae", render(tpl, page).c_str());
+    page.connected = true;
+    TEST_ASSERT_EQUAL_STRING("abcde", render(tpl, page).c_str());
+    page.loggedIn = false;
+    TEST_ASSERT_EQUAL_STRING("abde", render(tpl, page).c_str());
+}
+
+void test_values_in_hidden_sections_are_not_rendered(void) {
+    Page page = {false, false, "x", 0};
+    TEST_ASSERT_EQUAL_STRING("", render("{{#LOGGED_IN}}{{SSID}}{{/LOGGED_IN}}", page).c_str());
+}
+
+void test_unknown_names_render_empty(void) {
+    Page page = {false, false, "", 0};
+    TEST_ASSERT_EQUAL_STRING("[]", render("[{{NOPE}}]", page).c_str());
+    TEST_ASSERT_EQUAL_STRING("[]", render("[{{#NOPE}}x{{/NOPE}}]", page).c_str());
+}
+
+void test_user_text_is_html_escaped(void) {
+    Page page = {false, false, "<b>\"Tom's\" & co</b>", 0};
+    TEST_ASSERT_EQUAL_STRING("&lt;b&gt;&quot;Tom&#39;s&quot; &amp; co&lt;/b&gt;",
+                             render("{{SSID}}", page).c_str());
+}
+
+void test_single_braces_are_literal_text(void) {
+    Page page = {false, false, "", 0};
+    TEST_ASSERT_EQUAL_STRING("a{b}c{ {x} }", render("a{b}c{ {x} }", page).c_str());
+}
+
+void test_tag_cut_off_by_the_end_of_the_template_is_still_read(void) {
+    Page page = {false, false, "net", 0};
+    TEST_ASSERT_EQUAL_STRING("anet", render("a{{SSID", page).c_str());
+}
+
+void test_long_output_is_split_into_full_chunks(void) {
+    std::string tpl(TEMPLATE_CHUNK_SIZE * 2 + 10, 'x');
+    Page page = {false, false, "", 0};
+    std::string body = render(tpl.c_str(), page);
+    TEST_ASSERT_EQUAL_size_t(tpl.size(), body.size());
+    TEST_ASSERT_EQUAL_size_t(4, server.chunks.size());
+    TEST_ASSERT_EQUAL_size_t(TEMPLATE_CHUNK_SIZE, server.chunks[0]);
+    TEST_ASSERT_EQUAL_size_t(TEMPLATE_CHUNK_SIZE, server.chunks[1]);
+    TEST_ASSERT_EQUAL_size_t(10, server.chunks[2]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_values_are_substituted);
+    RUN_TEST(test_response_is_chunked_and_terminated);
+    RUN_TEST(test_sections_follow_the_callback);
+    RUN_TEST(test_nested_sections_inside_a_hidden_one_stay_hidden);
+    RUN_TEST(test_values_in_hidden_sections_are_not_rendered);
+    RUN_TEST(test_unknown_names_render_empty);
+    RUN_TEST(test_user_text_is_html_escaped);
+    RUN_TEST(test_single_braces_are_literal_text);
+    RUN_TEST(test_tag_cut_off_by_the_end_of_the_template_is_still_read);
+    RUN_TEST(test_long_output_is_split_into_full_chunks);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <unity.h>
+#include "tone_player.h"
+
+static const Melody chime = MELODY(NOTE_C6, REST, NOTE_E6);        // 3 beats
+static const Melody alarm = MELODY(NOTE_A4, NOTE_A5);              // 2 beats
+static const Melody click = MELODY(NOTE_G6);                       // 1 beat
+
+// At tempo divisor 4 a note sounds for 250 ms and a beat lasts 325 ms
+#define NOTE_MS 250
+#define BEAT_MS 325
+
+static bool quiet;
+
+static bool isQuiet() {
+    return quiet;
+}
+
+void setUp(void) {
+    hostState() = HostState();
+    hostState().millis = 1000;
+    quiet = false;
+}
+
+void tearDown(void) {}
+
+// Advances the virtual clock 1 ms per loop() call
+static void runFor(TonePlayer& player, unsigned long ms) {
+    for (unsigned long i = 0; i < ms; i++) {
+        hostState().millis++;
+        player.loop();
+    }
+}
+
+void test_play_returns_at_once_with_the_first_note_sounding(void) {
+    TonePlayer player;
+    TEST_ASSERT_TRUE(player.play(chime, 4, TONE_PRIORITY_NOTIFICATION));
+    TEST_ASSERT_TRUE(player.isPlaying());
+    TEST_ASSERT_EQUAL_INT(NOTE_C6, (int)hostState().toneFrequency);
+}
+
+void test_notes_follow_the_tempo(void) {
+    TonePlayer player;
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+
+    runFor(player, NOTE_MS - 1);
+    TEST_ASSERT_EQUAL_INT(NOTE_C6, (int)hostState().toneFrequency);
+    runFor(player, 1);
+    TEST_ASSERT_EQUAL_INT(0, (int)hostState().toneFrequency);
+
+    // The REST merged into C6 holds it for two beats before E6
+    runFor(player, 2 * BEAT_MS - NOTE_MS - 1);
+    TEST_ASSERT_EQUAL_INT(0, (int)hostState().toneFrequency);
+    runFor(player, 1);
+    TEST_ASSERT_EQUAL_INT(NOTE_E6, (int)hostState().toneFrequency);
+
+    runFor(player, BEAT_MS);
+    TEST_ASSERT_FALSE(player.isPlaying());
+    TEST_ASSERT_EQUAL_INT(0, (int)hostState().toneFrequency);
+}
+
+void test_late_loop_calls_do_not_stretch_the_melody(void) {
+    TonePlayer player;
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+
+    // One slow loop() in the middle, e.g. a TLS handshake
+    hostState().millis += 400;
+    player.loop();
+    runFor(player, 3 * BEAT_MS - 400 - 1);
+    TEST_ASSERT_TRUE(player.isPlaying());
+    runFor(player, 1);
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+void test_same_priority_melodies_play_in_order(void) {
+    TonePlayer player;
+    player.play(click, 4, TONE_PRIORITY_NOTIFICATION);
+    player.play(alarm, 4, TONE_PRIORITY_NOTIFICATION);
+    runFor(player, BEAT_MS);
+    TEST_ASSERT_EQUAL_INT(NOTE_A4, (int)hostState().toneFrequency);
+    TEST_ASSERT_EQUAL_UINT32(0, player.getPreempted());
+}
+
+void test_higher_priority_preempts_the_playing_melody(void) {
+    TonePlayer player;
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+    runFor(player, 100);
+    TEST_ASSERT_TRUE(player.play(alarm, 4, TONE_PRIORITY_ALERT));
+    TEST_ASSERT_EQUAL_UINT32(1, player.getPreempted());
+    TEST_ASSERT_EQUAL_INT(NOTE_A4, (int)hostState().toneFrequency);
+
+    runFor(player, 2 * BEAT_MS);
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+void test_queue_orders_by_priority(void) {
+    TonePlayer player;
+    player.play(click, 4, TONE_PRIORITY_ALERT);
+    player.play(chime, 4, TONE_PRIORITY_FEEDBACK);
+    player.play(alarm, 4, TONE_PRIORITY_NOTIFICATION);
+
+    // The notification jumps ahead of the queued feedback sound
+    runFor(player, BEAT_MS);
+    TEST_ASSERT_EQUAL_INT(NOTE_A4, (int)hostState().toneFrequency);
+    runFor(player, 2 * BEAT_MS);
+    TEST_ASSERT_EQUAL_INT(NOTE_C6, (int)hostState().toneFrequency);
+}
+
+void test_full_queue_drops_new_melodies(void) {
+    TonePlayer player;
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+    for (int i = 0; i < TONE_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_TRUE(player.play(click, 4, TONE_PRIORITY_NOTIFICATION));
+    }
+    TEST_ASSERT_FALSE(player.play(click, 4, TONE_PRIORITY_NOTIFICATION));
+    TEST_ASSERT_EQUAL_UINT32(1, player.getDropped());
+}
+
+void test_quiet_device_only_plays_alerts(void) {
+    TonePlayer player;
+    player.setQuietCallback(isQuiet);
+    quiet = true;
+    TEST_ASSERT_FALSE(player.play(click, 4, TONE_PRIORITY_FEEDBACK));
+    TEST_ASSERT_FALSE(player.play(chime, 4, TONE_PRIORITY_NOTIFICATION));
+    TEST_ASSERT_EQUAL_UINT32(2, player.getDropped());
+    TEST_ASSERT_TRUE(player.play(alarm, 4, TONE_PRIORITY_ALERT));
+    TEST_ASSERT_EQUAL_INT(NOTE_A4, (int)hostState().toneFrequency);
+}
+
+void test_going_quiet_silences_a_playing_notification(void) {
+    TonePlayer player;
+    player.setQuietCallback(isQuiet);
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+    player.play(click, 4, TONE_PRIORITY_FEEDBACK);
+    runFor(player, 50);
+
+    // A measurement starts: the playing and the queued melody are both dropped
+    quiet = true;
+    runFor(player, 1);
+    TEST_ASSERT_FALSE(player.isPlaying());
+    TEST_ASSERT_EQUAL_INT(0, (int)hostState().toneFrequency);
+    TEST_ASSERT_EQUAL_UINT32(2, player.getDropped());
+}
+
+void test_stop_silences_and_clears_the_queue(void) {
+    TonePlayer player;
+    player.play(chime, 4, TONE_PRIORITY_NOTIFICATION);
+    player.play(click, 4, TONE_PRIORITY_NOTIFICATION);
+    player.stop();
+    TEST_ASSERT_FALSE(player.isPlaying());
+    TEST_ASSERT_EQUAL_INT(0, (int)hostState().toneFrequency);
+    runFor(player, 3 * BEAT_MS);
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+void test_invalid_tempo_is_rejected(void) {
+    TonePlayer player;
+    TEST_ASSERT_FALSE(player.play(chime, 0, TONE_PRIORITY_ALERT));
+    TEST_ASSERT_FALSE(player.isPlaying());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_play_returns_at_once_with_the_first_note_sounding);
+    RUN_TEST(test_notes_follow_the_tempo);
+    RUN_TEST(test_late_loop_calls_do_not_stretch_the_melody);
+    RUN_TEST(test_same_priority_melodies_play_in_order);
+    RUN_TEST(test_higher_priority_preempts_the_playing_melody);
+    RUN_TEST(test_queue_orders_by_priority);
+    RUN_TEST(test_full_queue_drops_new_melodies);
+    RUN_TEST(test_quiet_device_only_plays_alerts);
+    RUN_TEST(test_going_quiet_silences_a_playing_notification);
+    RUN_TEST(test_stop_silences_and_clears_the_queue);
+    RUN_TEST(test_invalid_tempo_is_rejected);
+    return UNITY_END();
+}
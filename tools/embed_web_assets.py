@@ -0,0 +1,152 @@
+"""Embed the files in web/ as gzip-compressed PROGMEM blobs.
+
+Runs as a PlatformIO pre-build script (see extra_scripts in platformio.ini) and
+can also be run by hand: python tools/embed_web_assets.py
+
+Writes include/web_assets.h. Templates (*.tpl.html) are stored uncompressed as
+strings for TemplateStream, everything else is gzipped. Non-HTML assets get a
+content hash appended to their URL (e.g. /style.css?v=1a2b3c4d) so they can be
+cached indefinitely; references to them inside the HTML files are rewritten to
+the versioned URL. Every compressed asset also gets an ETag so unchanged files
+can be revalidated with a 304.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT = os.path.join(PROJECT_DIR, "include", "web_assets.h")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+
+def minify(text):
+    # Templates are hand-written one element per line; joining the lines is enough
+    return "".join(line.strip() for line in text.splitlines())
+
+
+def is_template(name):
+    return name.endswith(".tpl.html")
+
+
+def c_string(text):
+    lines = text.split("\n")
+    parts = []
+    for i, line in enumerate(lines):
+        line = line.replace("\\", "\\\\").replace('"', '\\"')
+        if i < len(lines) - 1:
+            line += "\\n"
+        if line:
+            parts.append('    "%s"' % line)
+    return "\n".join(parts)
+
+
+def symbol(name):
+    return "WEB_" + re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def c_bytes(data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]))
+    return ",\n".join(lines)
+
+
+def main():
+    names = sorted(n for n in os.listdir(WEB_DIR)
+                   if os.path.splitext(n)[1] in CONTENT_TYPES)
+    sources = {}
+    for name in names:
+        with open(os.path.join(WEB_DIR, name), encoding="utf-8") as f:
+            text = f.read()
+            # Templates keep their line breaks (used inside <pre>-style blocks)
+            sources[name] = text if is_template(name) else minify(text)
+
+    # Version the static (non-HTML) assets and point the pages at those URLs
+    urls = {}
+    for name in names:
+        if not name.endswith(".html"):
+            digest = hashlib.sha1(sources[name].encode("utf-8")).hexdigest()[:8]
+            urls[name] = "/%s?v=%s" % (name, digest)
+    for name in names:
+        if name.endswith(".html"):
+            for asset, url in urls.items():
+                sources[name] = sources[name].replace("'/%s'" % asset, "'%s'" % url)
+
+    out = [
+        "// Generated by tools/embed_web_assets.py from the files in web/ - do not edit.",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// A gzip-compressed file stored in flash",
+        "struct WebAsset {",
+        "    const char* path;        // URL the asset is served at (without version query)",
+        "    const char* contentType;",
+        "    const uint8_t* data;     // gzip stream, send with Content-Encoding: gzip",
+        "    size_t length;",
+        "    bool immutable;          // URL carries a content hash, cache forever",
+        "    const char* etag;        // Quoted hash of the data, for If-None-Match",
+        "};",
+        "",
+    ]
+    static_routes = []
+    for name in names:
+        sym = symbol(name)
+        if is_template(name):
+            out.append("// %s: %d bytes, rendered by TemplateStream" % (name, len(sources[name].encode("utf-8"))))
+            out.append("static const char %s[] PROGMEM =" % sym)
+            out.append(c_string(sources[name]) + ";")
+            out.append("")
+            continue
+        raw = sources[name].encode("utf-8")
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        immutable = name in urls
+        etag = hashlib.sha1(packed).hexdigest()[:16]
+        out.append("// %s: %d bytes, %d gzipped" % (name, len(raw), len(packed)))
+        out.append("static const uint8_t %s_GZ[] PROGMEM = {" % sym)
+        out.append(c_bytes(packed))
+        out.append("};")
+        out.append('static const WebAsset %s = {"/%s", "%s", %s_GZ, sizeof(%s_GZ), %s, "\\"%s\\""};'
+                   % (sym, name, CONTENT_TYPES[os.path.splitext(name)[1]], sym, sym,
+                      "true" if immutable else "false", etag))
+        if immutable:
+            out.append('#define %s_URL "%s"' % (sym, urls[name]))
+            static_routes.append(sym)
+        out.append("")
+
+    out.append("// Assets served as-is at their path, sorted by path for the route dispatcher")
+    out.append("static const WebAsset* const WEB_STATIC_ROUTES[] = {")
+    out.append(",\n".join("    &%s" % sym for sym in static_routes))
+    out.append("};")
+    out.append("#define WEB_STATIC_ROUTE_COUNT (sizeof(WEB_STATIC_ROUTES) / sizeof(WEB_STATIC_ROUTES[0]))")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+
+    text = "\n".join(out)
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT, encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    with open(OUTPUT, "w", encoding="utf-8") as f:
+        f.write(text)
+    print("embed_web_assets: wrote %s" % os.path.relpath(OUTPUT, PROJECT_DIR))
+
+
+main()